@@ -0,0 +1,135 @@
+// Synthetic-audio check for AudioEventDetector.
+//
+// Builds 16 kHz mono PCM with known content (3 kHz whistle bursts over steady crowd noise, plus two
+// crowd-level ramps), feeds it through the detector in odd-sized chunks like the ffmpeg pipe does, and
+// checks that every planned event is reported close to its time and that nothing else is. Prints one
+// line per event and exits non-zero on any mismatch, so it can run under CTest.
+//
+//   ava_audio_event_check
+
+#include "AudioEvents.h"
+
+#include <QRandomGenerator>
+#include <QTextStream>
+#include <QVector>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace {
+constexpr int kSampleRate = 16000;
+constexpr qint64 kDurationMs = 90000;
+constexpr int kChunkSamples = 1777;        // deliberately not a multiple of the detector's hop
+constexpr double kWhistleHz = 3000.0;
+constexpr double kWhistleAmplitude = 0.05; // about 4 dB above the crowd bed: a whistle, not a surge
+constexpr double kCrowdGain = 0.05;        // uniform noise, about -31 dBFS RMS
+constexpr double kSurgeGain = 0.4;         // +18 dB
+constexpr qint64 kRampMs = 300;
+constexpr qint64 kWhistleToleranceMs = 100;
+constexpr qint64 kSurgeStartToleranceMs = 600;
+constexpr qint64 kSurgeEndLateMs = 1500;   // the short-term level needs a moment to fall back
+constexpr double kPi = 3.14159265358979323846;
+
+struct Planned {
+    AudioEvent::Kind kind = AudioEvent::Kind::Whistle;
+    qint64 startMs = 0;
+    qint64 endMs = 0;                      // surges: end of the hold, before the ramp down
+};
+
+const QVector<Planned>& plan() {
+    static const QVector<Planned> events = {
+        {AudioEvent::Kind::Whistle, 5000, 5400},      // inside the surge warm-up; whistles still count
+        {AudioEvent::Kind::Whistle, 15000, 15500},
+        {AudioEvent::Kind::Whistle, 24000, 24350},
+        {AudioEvent::Kind::CrowdSurge, 35000, 39000},
+        {AudioEvent::Kind::Whistle, 52000, 53000},
+        {AudioEvent::Kind::CrowdSurge, 65000, 68000},
+    };
+    return events;
+}
+
+double crowdGainAt(qint64 ms) {
+    for (const Planned& p : plan()) {
+        if (p.kind != AudioEvent::Kind::CrowdSurge) continue;
+        if (ms < p.startMs || ms >= p.endMs + kRampMs) continue;
+        const double up = std::min(1.0, double(ms - p.startMs) / kRampMs);
+        const double down = ms < p.endMs ? 1.0 : 1.0 - double(ms - p.endMs) / kRampMs;
+        return kCrowdGain + (kSurgeGain - kCrowdGain) * std::min(up, down);
+    }
+    return kCrowdGain;
+}
+
+bool whistleAt(qint64 ms) {
+    return std::any_of(plan().cbegin(), plan().cend(), [ms](const Planned& p) {
+        return p.kind == AudioEvent::Kind::Whistle && ms >= p.startMs && ms < p.endMs;
+    });
+}
+
+QVector<qint16> synthesize() {
+    QRandomGenerator rng(20240611);
+    const qint64 total = kDurationMs * kSampleRate / 1000;
+    QVector<qint16> pcm(total);
+    for (qint64 i = 0; i < total; ++i) {
+        const qint64 ms = i * 1000 / kSampleRate;
+        double sample = crowdGainAt(ms) * (2.0 * rng.generateDouble() - 1.0);
+        if (whistleAt(ms)) sample += kWhistleAmplitude * std::sin(2.0 * kPi * kWhistleHz * double(i) / kSampleRate);
+        pcm[i] = qint16(std::clamp(sample, -1.0, 1.0) * 32767.0);
+    }
+    return pcm;
+}
+
+const char* kindName(AudioEvent::Kind kind) {
+    return kind == AudioEvent::Kind::Whistle ? "whistle" : "crowd";
+}
+
+bool matches(const Planned& p, const AudioEvent& e) {
+    if (p.kind != e.kind) return false;
+    if (p.kind == AudioEvent::Kind::Whistle) {
+        return std::abs(e.startMs - p.startMs) <= kWhistleToleranceMs
+               && std::abs(e.endMs - p.endMs) <= kWhistleToleranceMs;
+    }
+    return std::abs(e.startMs - p.startMs) <= kSurgeStartToleranceMs && e.endMs >= p.endMs
+           && e.endMs <= p.endMs + kRampMs + kSurgeEndLateMs;
+}
+} // namespace
+
+int main() {
+    QTextStream out(stdout);
+    const QVector<qint16> pcm = synthesize();
+
+    AudioEventDetector detector(kSampleRate);
+    for (qsizetype at = 0; at < pcm.size(); at += kChunkSamples) {
+        detector.appendSamples(pcm.constData() + at, int(std::min<qsizetype>(kChunkSamples, pcm.size() - at)));
+    }
+    detector.finish();
+    const QVector<AudioEvent>& reported = detector.events();
+
+    int failures = 0;
+    QVector<bool> claimed(reported.size(), false);
+    for (const Planned& p : plan()) {
+        int found = -1;
+        for (int i = 0; i < reported.size() && found < 0; ++i) {
+            if (!claimed.at(i) && matches(p, reported.at(i))) found = i;
+        }
+        if (found < 0) {
+            ++failures;
+            out << "MISSING " << kindName(p.kind) << ' ' << p.startMs << '-' << p.endMs << " ms\n";
+            continue;
+        }
+        claimed[found] = true;
+        const AudioEvent& e = reported.at(found);
+        out << "ok      " << kindName(p.kind) << ' ' << p.startMs << '-' << p.endMs << " ms -> " << e.startMs << '-'
+            << e.endMs << " ms (confidence " << e.confidence << ")\n";
+    }
+    for (int i = 0; i < reported.size(); ++i) {
+        if (claimed.at(i)) continue;
+        ++failures;
+        const AudioEvent& e = reported.at(i);
+        out << "EXTRA   " << kindName(e.kind) << ' ' << e.startMs << '-' << e.endMs << " ms\n";
+    }
+
+    out << (failures == 0 ? "PASS" : "FAIL") << " (" << plan().size() << " planned, " << reported.size()
+        << " reported)\n";
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,389 @@
+// Headless seek / playback latency benchmark for VideoPlayer.
+//
+// Generates synthetic clips with ffmpeg (codec x GOP x resolution), drives VideoPlayer under the
+// offscreen platform and prints JSON: time-to-first-frame, exact-seek latency percentiles, scrub
+// responsiveness, and frame delivery jitter and frame-step copy cost per playback rate. Compare runs
+// across builds with --label and across Qt multimedia backends with
+// QT_MEDIA_BACKEND=ffmpeg|darwin|gstreamer|windows. Thumbnail, audio and scene analysis stay off and
+// measuring starts once the keyframe index is built, so no background decoder shares the CPU.
+//
+//   ava_playback_bench [--workdir DIR] [--out FILE] [--label NAME] [--duration SEC] [--seeks N]
+//                      [--case codec:gop:height ...] [--with-proxy] [--with-analysis]
+
+#include "VideoPlayer.h"
+#include "PlaybackTelemetry.h"
+#include "FrameCopier.h"
+#include "ClipExporter.h"
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QProcess>
+#include <QRandomGenerator>
+#include <QSettings>
+#include <QSysInfo>
+#include <QTextStream>
+#include <QVideoFrame>
+#include <QVideoSink>
+#include <QVideoWidget>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+namespace {
+constexpr int kFrameTimeoutMs = 5000;
+constexpr int kSettleMs = 250;
+constexpr int kIndexTimeoutMs = 60000;
+constexpr int kScrubSteps = 90;
+constexpr int kScrubStepMs = 16;  // ~60 Hz mouse moves
+constexpr int kPlaybackWindowMs = 4000;
+constexpr double kRates[] = {1.0, 2.0, 4.0};
+
+struct BenchCase {
+    QString codec;   // ffmpeg encoder name (libx264, libx265, mpeg2video, ...)
+    int gop = 25;
+    int height = 1080;
+
+    QString name() const { return QStringLiteral("%1_g%2_%3p").arg(codec).arg(gop).arg(height); }
+};
+
+bool parseCase(const QString& spec, BenchCase* out) {
+    const QStringList parts = spec.split(QLatin1Char(':'));
+    if (parts.size() != 3) return false;
+    bool gopOk = false, heightOk = false;
+    out->codec = parts.at(0);
+    out->gop = parts.at(1).toInt(&gopOk);
+    out->height = parts.at(2).toInt(&heightOk);
+    return gopOk && heightOk && out->gop > 0 && out->height > 0;
+}
+
+QVector<BenchCase> defaultCases() {
+    return {
+        {QStringLiteral("libx264"), 1, 1080},    // all-intra (proxy-like)
+        {QStringLiteral("libx264"), 25, 1080},
+        {QStringLiteral("libx264"), 250, 1080},  // long GOP, camera-like
+        {QStringLiteral("libx265"), 250, 2160},  // 4K HEVC
+    };
+}
+
+// Keeps every sink frame arrival (wall clock) so each phase can slice its own window.
+class FrameClock {
+public:
+    explicit FrameClock(QVideoSink* sink) {
+        clock_.start();
+        connection_ = QObject::connect(sink, &QVideoSink::videoFrameChanged, sink, [this](const QVideoFrame&) {
+            arrivalsMs_.push_back(clock_.elapsed());
+        });
+    }
+    ~FrameClock() { QObject::disconnect(connection_); }
+    qint64 now() const { return clock_.elapsed(); }
+    int count() const { return int(arrivalsMs_.size()); }
+    qint64 arrivalAt(int i) const { return arrivalsMs_.at(i); }
+
+private:
+    QElapsedTimer clock_;
+    QVector<qint64> arrivalsMs_;
+    QMetaObject::Connection connection_;
+};
+
+bool spinUntil(const std::function<bool()>& done, int timeoutMs) {
+    QElapsedTimer timer;
+    timer.start();
+    while (!done()) {
+        if (timer.elapsed() > timeoutMs) return false;
+        QCoreApplication::processEvents(QEventLoop::AllEvents | QEventLoop::WaitForMoreEvents, 5);
+    }
+    return true;
+}
+
+void spinFor(int ms) {
+    spinUntil([] { return false; }, ms);
+}
+
+double percentile(QVector<double> values, double p) {
+    if (values.isEmpty()) return -1.0;
+    std::sort(values.begin(), values.end());
+    const double rank = p * double(values.size() - 1);
+    const int lo = int(std::floor(rank));
+    const int hi = std::min(int(values.size()) - 1, lo + 1);
+    return values.at(lo) + (values.at(hi) - values.at(lo)) * (rank - lo);
+}
+
+QJsonObject distribution(const QVector<double>& values) {
+    double sum = 0.0;
+    for (double v : values) sum += v;
+    return QJsonObject{
+        {QStringLiteral("n"), values.size()},
+        {QStringLiteral("mean"), values.isEmpty() ? -1.0 : sum / values.size()},
+        {QStringLiteral("p50"), percentile(values, 0.50)},
+        {QStringLiteral("p90"), percentile(values, 0.90)},
+        {QStringLiteral("p99"), percentile(values, 0.99)},
+        {QStringLiteral("max"), values.isEmpty() ? -1.0 : *std::max_element(values.begin(), values.end())},
+    };
+}
+
+QString generateClip(const QString& ffmpeg, const QString& workDir, const BenchCase& c, int durationSec,
+                     QString* error) {
+    const QString path = QDir(workDir).filePath(QStringLiteral("%1_%2s.mp4").arg(c.name()).arg(durationSec));
+    if (QFileInfo(path).size() > 0) return path;
+
+    const int width = int(std::lround(c.height * 16.0 / 9.0)) & ~1;
+    QStringList args = {
+        QStringLiteral("-hide_banner"), QStringLiteral("-nostdin"), QStringLiteral("-y"),
+        QStringLiteral("-f"), QStringLiteral("lavfi"),
+        QStringLiteral("-i"), QStringLiteral("testsrc2=size=%1x%2:rate=25").arg(width).arg(c.height),
+        QStringLiteral("-f"), QStringLiteral("lavfi"),
+        QStringLiteral("-i"), QStringLiteral("sine=frequency=440:sample_rate=48000"),
+        QStringLiteral("-t"), QString::number(durationSec),
+        QStringLiteral("-c:v"), c.codec,
+        QStringLiteral("-g"), QString::number(c.gop),
+        QStringLiteral("-pix_fmt"), QStringLiteral("yuv420p"),
+        QStringLiteral("-c:a"), QStringLiteral("aac"),
+    };
+    if (c.codec == QStringLiteral("libx265")) args << QStringLiteral("-tag:v") << QStringLiteral("hvc1");
+    args << path;
+
+    QProcess process;
+    process.setProcessChannelMode(QProcess::MergedChannels);
+    process.start(ffmpeg, args);
+    if (!process.waitForFinished(-1) || process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0) {
+        *error = QString::fromUtf8(process.readAll().right(800));
+        QFile::remove(path);
+        return {};
+    }
+    return path;
+}
+
+void setRate(VideoPlayer& player, double rate) {
+    player.playbackResetSpeedWithControlFlash();
+    const int steps = int(std::lround((rate - 1.0) / 0.25));
+    for (int i = 0; i < std::abs(steps); ++i) {
+        (steps > 0) ? player.playbackFasterWithControlFlash() : player.playbackSlowerWithControlFlash();
+    }
+}
+
+QJsonObject runCase(const QString& clipPath, int durationSec, int seekCount) {
+    VideoPlayer player;
+    QVideoSink* sink = player.videoWidget()->videoSink();
+    FrameClock frames(sink);
+    QJsonObject result;
+
+    // Time to first frame
+    const qint64 loadStart = frames.now();
+    player.loadVideoFromFile(clipPath);
+    const bool firstFrame = spinUntil([&] { return frames.count() > 0 && player.durationMs() > 0; }, kFrameTimeoutMs);
+    result.insert(QStringLiteral("timeToFirstFrameMs"), firstFrame ? double(frames.arrivalAt(0) - loadStart) : -1.0);
+    if (!firstFrame) return result;
+
+    player.pause();
+    // Scrubbing snaps to the index's keyframes; wait for the indexer so it is not decoding meanwhile.
+    const bool indexed = spinUntil([&] { return player.mediaIndex() != nullptr; }, kIndexTimeoutMs);
+    result.insert(QStringLiteral("indexReady"), indexed);
+    spinFor(kSettleMs);
+
+    // Exact seeks to random positions (fixed seed so builds compare like for like)
+    QRandomGenerator rng(42);
+    const qint64 durationMs = player.durationMs() > 0 ? player.durationMs() : qint64(durationSec) * 1000;
+    QVector<double> seekLatencies;
+    int seekTimeouts = 0;
+    for (int i = 0; i < seekCount; ++i) {
+        const qint64 target = qint64(rng.bounded(quint32(std::max<qint64>(1, durationMs - 500))));
+        const int before = frames.count();
+        const qint64 issued = frames.now();
+        player.seekToMs(target);
+        if (spinUntil([&] { return frames.count() > before; }, kFrameTimeoutMs)) {
+            seekLatencies.push_back(double(frames.arrivalAt(before) - issued));
+        } else {
+            ++seekTimeouts;
+        }
+        spinFor(20);
+    }
+    QJsonObject seeks = distribution(seekLatencies);
+    seeks.insert(QStringLiteral("timeouts"), seekTimeouts);
+    result.insert(QStringLiteral("seekLatencyMs"), seeks);
+
+    // Scrub sweep: first -> last third of the clip at ~60 Hz, then release
+    player.beginScrub();
+    const int scrubFirstFrame = frames.count();
+    const qint64 scrubStart = frames.now();
+    for (int i = 0; i < kScrubSteps; ++i) {
+        player.scrubTo(durationMs / 3 + (durationMs / 3) * i / kScrubSteps);
+        spinFor(kScrubStepMs);
+    }
+    const int scrubFrames = frames.count() - scrubFirstFrame;
+    const double scrubSeconds = double(frames.now() - scrubStart) / 1000.0;
+    const int releaseBefore = frames.count();
+    const qint64 released = frames.now();
+    player.endScrub((durationMs * 2) / 3);
+    const bool releaseFrame = spinUntil([&] { return frames.count() > releaseBefore; }, kFrameTimeoutMs);
+    result.insert(QStringLiteral("scrub"), QJsonObject{
+        {QStringLiteral("moves"), kScrubSteps},
+        {QStringLiteral("framesShown"), scrubFrames},
+        {QStringLiteral("updatesPerSecond"), scrubSeconds > 0 ? scrubFrames / scrubSeconds : 0.0},
+        {QStringLiteral("releaseToFrameMs"), releaseFrame ? double(frames.arrivalAt(releaseBefore) - released) : -1.0},
+    });
+
+    // Frame delivery jitter while playing at each rate
+    QJsonArray playback;
+    for (double rate : kRates) {
+        player.seekToMs(0);
+        setRate(player, rate);
+        player.play();
+        spinFor(kSettleMs);
+        const FrameCopier::Stats copiesBefore = player.frameCopier()->stats();
+        const int first = frames.count();
+        spinFor(kPlaybackWindowMs);
+        const int last = frames.count();
+        const FrameCopier::Stats copiesAfter = player.frameCopier()->stats();
+        player.pause();
+
+        QVector<double> intervals;
+        for (int i = first + 1; i < last; ++i) intervals.push_back(double(frames.arrivalAt(i) - frames.arrivalAt(i - 1)));
+        const double expected = 1000.0 / 25.0 / rate;
+        QVector<double> jitter;
+        for (double interval : intervals) jitter.push_back(std::abs(interval - expected));
+
+        playback.append(QJsonObject{
+            {QStringLiteral("rate"), rate},
+            {QStringLiteral("framesPerSecond"), double(last - first) * 1000.0 / kPlaybackWindowMs},
+            {QStringLiteral("expectedIntervalMs"), expected},
+            {QStringLiteral("intervalMs"), distribution(intervals)},
+            {QStringLiteral("jitterMs"), distribution(jitter)},
+            {QStringLiteral("stepBufferCopies"), QJsonObject{
+                {QStringLiteral("submitted"), double(copiesAfter.submitted - copiesBefore.submitted)},
+                {QStringLiteral("dropped"), double(copiesAfter.dropped - copiesBefore.dropped)},
+                {QStringLiteral("avgCopyUs"), copiesAfter.copied > copiesBefore.copied
+                     ? (copiesAfter.totalCopyNs - copiesBefore.totalCopyNs) / 1000.0
+                           / double(copiesAfter.copied - copiesBefore.copied)
+                     : 0.0},
+                {QStringLiteral("maxCopyUs"), copiesAfter.maxCopyNs / 1000.0},
+            }},
+        });
+        spinFor(kSettleMs);
+    }
+    result.insert(QStringLiteral("playback"), playback);
+
+    const PlaybackTelemetry::Stats& t = player.telemetry()->stats();
+    result.insert(QStringLiteral("telemetry"), QJsonObject{
+        {QStringLiteral("framesDelivered"), double(t.framesDelivered)},
+        {QStringLiteral("lateFrames"), double(t.lateFrames)},
+        {QStringLiteral("droppedFrames"), double(t.droppedFrames)},
+        {QStringLiteral("stallEvents"), double(t.stallEvents)},
+        {QStringLiteral("recoveries"), double(t.recoveries)},
+        {QStringLiteral("abandonedStalls"), double(t.abandonedStalls)},
+    });
+    return result;
+}
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+    // Separate settings scope so benchmark runs never touch the analyst's AVA preferences.
+    QCoreApplication::setOrganizationName(QStringLiteral("AVA"));
+    QCoreApplication::setApplicationName(QStringLiteral("ava_playback_bench"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("AVA playback latency benchmark"));
+    parser.addHelpOption();
+    const QCommandLineOption workdirOpt(QStringLiteral("workdir"), QStringLiteral("Directory for generated clips."),
+                                        QStringLiteral("dir"), QDir::temp().filePath(QStringLiteral("ava-bench")));
+    const QCommandLineOption outOpt(QStringLiteral("out"), QStringLiteral("Write JSON here instead of stdout."),
+                                    QStringLiteral("file"));
+    const QCommandLineOption labelOpt(QStringLiteral("label"), QStringLiteral("Free-form build label."),
+                                      QStringLiteral("name"));
+    const QCommandLineOption durationOpt(QStringLiteral("duration"), QStringLiteral("Clip length in seconds."),
+                                         QStringLiteral("sec"), QStringLiteral("30"));
+    const QCommandLineOption seeksOpt(QStringLiteral("seeks"), QStringLiteral("Random exact seeks per clip."),
+                                      QStringLiteral("n"), QStringLiteral("40"));
+    const QCommandLineOption caseOpt(QStringLiteral("case"), QStringLiteral("codec:gop:height (repeatable)."),
+                                     QStringLiteral("spec"));
+    const QCommandLineOption proxyOpt(QStringLiteral("with-proxy"),
+                                      QStringLiteral("Allow VideoPlayer to build and switch to playback proxies."));
+    const QCommandLineOption analysisOpt(QStringLiteral("with-analysis"),
+                                         QStringLiteral("Run thumbnail, audio and scene analysis while measuring."));
+    parser.addOptions({workdirOpt, outOpt, labelOpt, durationOpt, seeksOpt, caseOpt, proxyOpt, analysisOpt});
+    parser.process(app);
+
+    // Background decoders compete with playback for CPU; keep them off unless asked, so runs compare.
+    QSettings settings;
+    settings.setValue(QStringLiteral("playback/proxyEnabled"), parser.isSet(proxyOpt));
+    settings.setValue(QStringLiteral("playback/backgroundAnalysis"), parser.isSet(analysisOpt));
+    settings.sync();
+
+    QVector<BenchCase> cases;
+    for (const QString& spec : parser.values(caseOpt)) {
+        BenchCase c;
+        if (!parseCase(spec, &c)) {
+            QTextStream(stderr) << "invalid --case " << spec << " (expected codec:gop:height)\n";
+            return 2;
+        }
+        cases.push_back(c);
+    }
+    if (cases.isEmpty()) cases = defaultCases();
+
+    const QString ffmpeg = ClipExporter::findFfmpeg();
+    if (ffmpeg.isEmpty()) {
+        QTextStream(stderr) << "ffmpeg not found\n";
+        return 2;
+    }
+    const QString workDir = parser.value(workdirOpt);
+    QDir().mkpath(workDir);
+    const int durationSec = std::max(5, parser.value(durationOpt).toInt());
+    const int seekCount = std::max(1, parser.value(seeksOpt).toInt());
+
+    QJsonArray results;
+    for (const BenchCase& c : cases) {
+        QTextStream(stderr) << "[bench] " << c.name() << "\n";
+        QJsonObject entry{
+            {QStringLiteral("case"), c.name()},
+            {QStringLiteral("codec"), c.codec},
+            {QStringLiteral("gop"), c.gop},
+            {QStringLiteral("height"), c.height},
+        };
+        QString error;
+        const QString clip = generateClip(ffmpeg, workDir, c, durationSec, &error);
+        if (clip.isEmpty()) {
+            entry.insert(QStringLiteral("error"), QStringLiteral("clip generation failed: %1").arg(error));
+        } else {
+            const QJsonObject metrics = runCase(clip, durationSec, seekCount);
+            for (auto it = metrics.begin(); it != metrics.end(); ++it) entry.insert(it.key(), it.value());
+        }
+        results.append(entry);
+    }
+
+    const QJsonObject report{
+        {QStringLiteral("label"), parser.value(labelOpt)},
+        {QStringLiteral("qtVersion"), QString::fromLatin1(qVersion())},
+        {QStringLiteral("platform"), QGuiApplication::platformName()},
+        {QStringLiteral("mediaBackend"), qEnvironmentVariableIsEmpty("QT_MEDIA_BACKEND")
+                                             ? QStringLiteral("default")
+                                             : qEnvironmentVariable("QT_MEDIA_BACKEND")},
+        {QStringLiteral("os"), QSysInfo::prettyProductName()},
+        {QStringLiteral("cpu"), QSysInfo::currentCpuArchitecture()},
+        {QStringLiteral("proxy"), parser.isSet(proxyOpt)},
+        {QStringLiteral("analysis"), parser.isSet(analysisOpt)},
+        {QStringLiteral("cases"), results},
+    };
+    const QByteArray json = QJsonDocument(report).toJson(QJsonDocument::Indented);
+
+    if (parser.isSet(outOpt)) {
+        QFile out(parser.value(outOpt));
+        if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            QTextStream(stderr) << "cannot write " << parser.value(outOpt) << "\n";
+            return 1;
+        }
+        out.write(json);
+    } else {
+        QTextStream(stdout) << json;
+    }
+    return 0;
+}
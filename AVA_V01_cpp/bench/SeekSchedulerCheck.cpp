@@ -0,0 +1,97 @@
+// Latency-pacing check for SeekScheduler.
+//
+// Drives the scheduler with a player that has no media and a free-standing video sink, delivering
+// frames by hand. A drag inside one GOP turns into a long run of requests for the same keyframe;
+// those must not reach the player again, and neither they nor a seek that times out may move the
+// latency estimate that sets the scheduler's interval and timeout. A frame the player injects from
+// its own buffers must not complete a seek either. Exits non-zero on a mismatch, so it can run under
+// CTest.
+//
+//   ava_seek_scheduler_check
+
+#include "SeekScheduler.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QMediaPlayer>
+#include <QTextStream>
+#include <QVideoFrame>
+#include <QVideoFrameFormat>
+#include <QVideoSink>
+
+#include <cstdlib>
+
+namespace {
+constexpr qint64 kKeyframeMs = 4000;
+constexpr int kSameTargetRequests = 500;
+
+void spin(qint64 ms) {
+    QElapsedTimer clock;
+    clock.start();
+    while (clock.elapsed() < ms) QCoreApplication::processEvents(QEventLoop::AllEvents, 5);
+}
+} // namespace
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+
+    QMediaPlayer player;
+    QVideoSink sink;
+    SeekScheduler scheduler(&player, &sink);
+    int measured = 0;
+    QObject::connect(&scheduler, &SeekScheduler::seekLatencyMeasured, [&measured](qint64) { ++measured; });
+    const QVideoFrame frame(QVideoFrameFormat(QSize(16, 16), QVideoFrameFormat::Format_RGBA8888));
+    int failures = 0;
+    const auto expect = [&](bool ok, const char* what) {
+        out << (ok ? "ok      " : "FAIL    ") << what << " (latency " << scheduler.averageLatencyMs() << " ms, "
+            << measured << " measured)\n";
+        if (!ok) ++failures;
+    };
+
+    // One real seek: the frame arrives, and its target is now on screen.
+    scheduler.requestSeek(kKeyframeMs);
+    spin(20);
+    sink.setVideoFrame(frame);
+    const qint64 settledLatency = scheduler.averageLatencyMs();
+    expect(measured == 1, "first seek measured");
+
+    // Dragging within the GOP: every position snaps to the same keyframe.
+    for (int i = 0; i < kSameTargetRequests; ++i) {
+        scheduler.requestSeek(kKeyframeMs);
+        QCoreApplication::processEvents();
+    }
+    spin(200);   // past the pacing interval: a re-issued seek would be in flight now
+    sink.setVideoFrame(frame);  // and would complete here
+    expect(scheduler.averageLatencyMs() == settledLatency && measured == 1, "same-target requests ignored");
+
+    // A seek whose frame never arrives times out without becoming a latency sample.
+    scheduler.requestSeek(kKeyframeMs * 2);
+    spin(1200);  // longer than the largest timeout
+    expect(scheduler.averageLatencyMs() == settledLatency && measured == 1, "timeout not sampled");
+
+    // After that timeout the same target is still treated as shown.
+    for (int i = 0; i < kSameTargetRequests; ++i) scheduler.requestSeek(kKeyframeMs * 2);
+    spin(200);
+    sink.setVideoFrame(frame);
+    expect(scheduler.averageLatencyMs() == settledLatency && measured == 1, "timed-out target not retried");
+
+    // A new target is issued and measured again.
+    scheduler.requestSeek(kKeyframeMs * 3);
+    spin(20);
+    sink.setVideoFrame(frame);
+    expect(measured == 2, "new target measured");
+
+    // A frame replayed from the player's buffers while a seek is in flight is not its answer.
+    scheduler.requestSeek(kKeyframeMs * 4);
+    spin(20);
+    scheduler.setInjectingFrame(true);
+    sink.setVideoFrame(frame);
+    scheduler.setInjectingFrame(false);
+    expect(measured == 2, "injected frame does not complete the seek");
+    sink.setVideoFrame(frame);
+    expect(measured == 3, "decoded frame completes it");
+
+    out << (failures == 0 ? "PASS" : "FAIL") << '\n';
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
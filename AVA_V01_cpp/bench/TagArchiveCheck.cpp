@@ -0,0 +1,153 @@
+// Round-trip check for TagArchive.
+//
+// Writes a small session to an archive, maps it again and compares every column, the symbol table
+// and the team names with the session; loads it into a fresh session and compares the tags; then
+// does the same through a live journal and convertJournal(), and checks that team names reach the
+// journal as they change and that discarding the journal leaves only the archive. Exits non-zero on any mismatch, so it can run under CTest.
+//
+//   ava_tag_archive_check
+
+#include "TagArchive.h"
+#include "TagJournal.h"
+#include "TagSession.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTextStream>
+
+#include <cstdlib>
+
+namespace {
+struct Checker {
+    QTextStream& out;
+    int failures = 0;
+
+    void expect(bool ok, const QString& what) {
+        out << (ok ? "ok      " : "FAIL    ") << what << '\n';
+        if (!ok) ++failures;
+    }
+};
+
+TagSession::GameTag makeTag(qint64 positionMs, const QString& mainEvent, const QString& followUp,
+                            const QString& team, const QString& note) {
+    TagSession::GameTag tag;
+    tag.positionMs = positionMs;
+    tag.mainEvent = TagSymbol(mainEvent);
+    tag.followUpEvent = TagSymbol(followUp);
+    tag.period = TagSymbol(positionMs < 900000 ? QStringLiteral("Q1") : QStringLiteral("Q2"));
+    tag.team = TagSymbol(team);
+    tag.situation = TagSymbol(QStringLiteral("Attacking"));
+    tag.note = note;
+    return tag;
+}
+
+// Out of time order on purpose, with an empty follow-up, an empty note and a non-ASCII note.
+void fillSession(TagSession& session) {
+    session.setGameTeams(QStringLiteral("Hockey Club"), QStringLiteral("Visitors"), QStringLiteral("#0044aa"),
+                         QStringLiteral("#aa2200"));
+    session.addTag(makeTag(1200000, QStringLiteral("Goal"), QStringLiteral("Field goal"), QStringLiteral("Home"),
+                           QStringLiteral("top corner")));
+    session.addTag(makeTag(30000, QStringLiteral("Shot"), QString(), QStringLiteral("Away"), QString()));
+    session.addTag(makeTag(450000, QStringLiteral("Penalty corner"), QStringLiteral("Saved"),
+                           QStringLiteral("Home"), QStringLiteral("Rückhand, zweiter Pfosten")));
+    session.addTag(makeTag(450000, QStringLiteral("Shot"), QStringLiteral("Wide"), QStringLiteral("Away"),
+                           QString()));
+    const TagSession::TagId removed =
+        session.addTag(makeTag(600000, QStringLiteral("Card"), QString(), QStringLiteral("Home"), QString()));
+    session.removeTag(removed);
+    session.flushChanges();
+}
+
+bool sameTag(const TagSession::GameTag& a, const TagSession::GameTag& b) {
+    return a.id == b.id && a.positionMs == b.positionMs && a.mainEvent == b.mainEvent
+           && a.followUpEvent == b.followUpEvent && a.period == b.period && a.team == b.team
+           && a.situation == b.situation && a.note == b.note;
+}
+
+bool sameTags(const TagSession& expected, const TagSession& actual) {
+    if (expected.tags().size() != actual.tags().size()) return false;
+    for (const TagSession::GameTag& tag : expected.tags()) {
+        const TagSession::GameTag* other = actual.tag(tag.id);
+        if (!other || !sameTag(tag, *other)) return false;
+    }
+    return expected.homeTeamName() == actual.homeTeamName() && expected.awayTeamName() == actual.awayTeamName()
+           && expected.homeTeamColor() == actual.homeTeamColor()
+           && expected.awayTeamColor() == actual.awayTeamColor();
+}
+
+void checkArchive(Checker& check, const TagSession& session, const QString& path, const QString& label) {
+    TagArchive archive;
+    check.expect(archive.open(path), label + QStringLiteral(": opens"));
+    if (!archive.isOpen()) return;
+    check.expect(archive.tagCount() == session.tags().size(), label + QStringLiteral(": tag count"));
+
+    bool rowsMatch = archive.tagCount() == session.tagIdsByTime().size();
+    for (int row = 0; rowsMatch && row < archive.tagCount(); ++row) {
+        const TagSession::GameTag* tag = session.tag(session.tagIdsByTime().at(row));
+        rowsMatch = tag && archive.tagId(row) == tag->id && archive.positionMs(row) == tag->positionMs
+                    && sameTag(archive.tagAt(row), *tag);
+    }
+    check.expect(rowsMatch, label + QStringLiteral(": rows in time order, every field"));
+
+    const quint32 goal = archive.findSymbol(QStringLiteral("Goal"));
+    check.expect(goal != 0 && archive.symbolText(goal) == QStringLiteral("Goal")
+                     && archive.findSymbol(QStringLiteral("Not used")) == 0,
+                 label + QStringLiteral(": symbol table"));
+    check.expect(archive.homeTeamName() == session.homeTeamName() && archive.awayTeamColor() == session.awayTeamColor(),
+                 label + QStringLiteral(": team names and colours"));
+    check.expect(archive.lowerBound(450000) == 1 && archive.lowerBound(450001) == 3
+                     && archive.lowerBound(5000000) == archive.tagCount(),
+                 label + QStringLiteral(": lowerBound"));
+
+    TagSession restored;
+    archive.loadInto(&restored);
+    check.expect(sameTags(session, restored), label + QStringLiteral(": loadInto restores the session"));
+}
+} // namespace
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+    Checker check{out};
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        out << "FAIL    no temporary directory\n";
+        return EXIT_FAILURE;
+    }
+
+    // Straight from a session.
+    TagSession session;
+    fillSession(session);
+    const QString sessionArchive = dir.filePath(QStringLiteral("session.avaarchive"));
+    check.expect(TagArchive::writeSession(session, sessionArchive), QStringLiteral("session: writes"));
+    checkArchive(check, session, sessionArchive, QStringLiteral("session"));
+
+    // Through a journal, as the app does when a video is closed.
+    const QString source = dir.filePath(QStringLiteral("match.mp4"));
+    TagSession journaled;
+    {
+        TagJournal journal(&journaled);
+        journal.open(source);
+        fillSession(journaled);
+        journal.waitForWriter();
+        const TagJournal::Contents replayed = TagJournal::readContents(source);
+        check.expect(replayed.homeTeamName == journaled.homeTeamName()
+                         && replayed.awayTeamColor == journaled.awayTeamColor(),
+                     QStringLiteral("journal: team names recorded as they change"));
+        journal.close();
+        journal.waitForWriter();
+        const QString journalArchive = TagArchive::archivePathFor(source);
+        check.expect(TagArchive::convertJournal(source, journalArchive), QStringLiteral("journal: converts"));
+        checkArchive(check, journaled, journalArchive, QStringLiteral("journal"));
+
+        journal.open(source);  // replays what was just converted
+        journal.closeAndDiscardFiles();
+        check.expect(!QFile::exists(TagJournal::journalPathFor(source))
+                         && !QFile::exists(TagJournal::snapshotPathFor(source)) && QFile::exists(journalArchive),
+                     QStringLiteral("journal: discarded, archive kept"));
+    }
+
+    out << (check.failures == 0 ? "PASS" : "FAIL") << '\n';
+    return check.failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,122 @@
+// Change-set coalescing check for TagSession.
+//
+// Runs short mutation sequences inside one transaction each and compares the single change set
+// delivered on commit with the net effect consumers must see (see TagSession::ChangeSet). Prints
+// one line per case and exits non-zero on any mismatch, so it can run under CTest.
+//
+//   ava_tag_session_check
+
+#include "TagSession.h"
+
+#include <QCoreApplication>
+#include <QStringList>
+#include <QTextStream>
+#include <QVector>
+
+#include <cstdlib>
+#include <functional>
+
+namespace {
+struct Expected {
+    QVector<TagSession::TagId> added;
+    QVector<TagSession::TagId> removed;
+    QVector<TagSession::TagId> modified;
+};
+
+using Mutation = std::function<Expected(TagSession&, TagSession::TagId existing)>;
+
+TagSession::GameTag makeTag(qint64 positionMs, const QString& mainEvent) {
+    TagSession::GameTag tag;
+    tag.positionMs = positionMs;
+    tag.mainEvent = TagSymbol(mainEvent);
+    tag.team = TagSymbol(QStringLiteral("Home"));
+    return tag;
+}
+
+QString idList(const QVector<TagSession::TagId>& ids) {
+    QStringList parts;
+    for (const TagSession::TagId id : ids) parts << QString::number(id);
+    return QLatin1Char('[') + parts.join(QLatin1Char(',')) + QLatin1Char(']');
+}
+
+// Runs mutate in one transaction on a session that already holds one delivered tag, then checks
+// what the commit delivered: exactly one change set when anything is expected, none otherwise.
+bool runCase(QTextStream& out, const char* name, const Mutation& mutate) {
+    TagSession session;
+    const TagSession::TagId existing = session.addTag(makeTag(1000, QStringLiteral("Goal")));
+    session.flushChanges();
+
+    QVector<TagSession::ChangeSet> delivered;
+    QObject::connect(&session, &TagSession::changesCommitted,
+                     [&delivered](const TagSession::ChangeSet& changes) { delivered.append(changes); });
+    Expected expected;
+    {
+        TagSession::Transaction transaction(&session);
+        expected = mutate(session, existing);
+    }
+
+    const bool expectNone = expected.added.isEmpty() && expected.removed.isEmpty() && expected.modified.isEmpty();
+    bool ok = delivered.size() == (expectNone ? 0 : 1);
+    const TagSession::ChangeSet changes = delivered.isEmpty() ? TagSession::ChangeSet() : delivered.constFirst();
+    // Change sets list IDs in ascending order, and so does every expectation below.
+    ok = ok && !changes.cleared && changes.added == expected.added && changes.removed == expected.removed
+         && changes.modified == expected.modified;
+
+    out << (ok ? "ok      " : "FAIL    ") << name << ": " << delivered.size() << " change set(s), added "
+        << idList(changes.added) << " removed " << idList(changes.removed) << " modified "
+        << idList(changes.modified) << '\n';
+    return ok;
+}
+} // namespace
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+    int failures = 0;
+    const auto check = [&](const char* name, const Mutation& mutate) {
+        if (!runCase(out, name, mutate)) ++failures;
+    };
+
+    check("add + edit -> added", [](TagSession& session, TagSession::TagId) {
+        TagSession::GameTag tag = makeTag(2000, QStringLiteral("Shot"));
+        tag.id = session.addTag(tag);
+        tag.positionMs = 2500;
+        session.updateTag(tag);
+        return Expected{{tag.id}, {}, {}};
+    });
+    check("add + remove -> nothing", [](TagSession& session, TagSession::TagId) {
+        session.removeTag(session.addTag(makeTag(2000, QStringLiteral("Shot"))));
+        return Expected{};
+    });
+    check("edit + remove -> removed", [](TagSession& session, TagSession::TagId existing) {
+        TagSession::GameTag tag = *session.tag(existing);
+        tag.positionMs = 1500;
+        session.updateTag(tag);
+        session.removeTag(existing);
+        return Expected{{}, {existing}, {}};
+    });
+    check("remove + restore -> modified", [](TagSession& session, TagSession::TagId existing) {
+        const TagSession::GameTag tag = *session.tag(existing);
+        session.removeTag(existing);
+        session.restoreTag(tag);
+        return Expected{{}, {}, {existing}};
+    });
+    check("remove + restore + edit -> modified", [](TagSession& session, TagSession::TagId existing) {
+        TagSession::GameTag tag = *session.tag(existing);
+        session.removeTag(existing);
+        session.restoreTag(tag);
+        tag.positionMs = 3000;
+        session.updateTag(tag);
+        return Expected{{}, {}, {existing}};
+    });
+    check("remove + restore + remove -> removed", [](TagSession& session, TagSession::TagId existing) {
+        const TagSession::GameTag tag = *session.tag(existing);
+        session.removeTag(existing);
+        session.restoreTag(tag);
+        session.removeTag(existing);
+        return Expected{{}, {existing}, {}};
+    });
+
+    out << (failures == 0 ? "PASS" : "FAIL") << '\n';
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
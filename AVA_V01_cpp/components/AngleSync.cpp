@@ -0,0 +1,170 @@
+#include "AngleSync.h"
+
+#include "SeekScheduler.h"
+#include "VideoPlayer.h"
+
+#include <QMediaPlayer>
+#include <QUrl>
+#include <QVideoSink>
+#include <QVideoWidget>
+
+#include <algorithm>
+
+namespace {
+constexpr qint64 kDriftCheckIntervalMs = 200;
+constexpr qint64 kDriftToleranceMs     = 20;    // half a frame at 25 fps
+constexpr qint64 kHardResyncMs         = 250;   // beyond this a rate nudge would take too long
+constexpr double kMaxRateCorrection    = 0.05;  // +-5 %: inaudible (angles are muted anyway) and invisible
+constexpr double kCorrectionWindowMs   = 1000.0;
+} // namespace
+
+AngleSync::AngleSync(VideoPlayer* master, QObject* parent) : QObject(parent), master_(master) {
+  connect(master_, &VideoPlayer::positionChangedMs, this, &AngleSync::onMasterPosition);
+  connect(master_, &VideoPlayer::playingChanged, this, &AngleSync::onMasterPlayingChanged);
+  connect(master_, &VideoPlayer::playbackRateChanged, this, &AngleSync::onMasterRateChanged);
+}
+
+AngleSync::~AngleSync() {
+  removeAll();
+}
+
+int AngleSync::addAngle(const Angle& angle, QWidget* widgetParent) {
+  Follower follower;
+  follower.info = angle;
+
+  follower.widget = new QVideoWidget(widgetParent);
+  follower.widget->setAspectRatioMode(Qt::KeepAspectRatio);
+  follower.widget->setStyleSheet(QStringLiteral("background-color: black;"));
+  follower.widget->setToolTip(angle.name);
+
+  // No QAudioOutput: the master angle owns the sound, and the backend skips audio decoding.
+  follower.player = new QMediaPlayer(this);
+  follower.player->setVideoOutput(follower.widget);
+  follower.player->setSource(QUrl::fromLocalFile(angle.path));
+  follower.scheduler = new SeekScheduler(follower.player, follower.widget->videoSink(), this);
+  follower.sinceDriftCheck.start();
+
+  followers_.append(follower);
+  Follower& added = followers_.last();
+  alignExactly(added, master_->currentPositionMs());
+  if (master_->isPlaying()) {
+    added.player->setPlaybackRate(master_->playbackRate());
+    added.player->play();
+  }
+
+  emit anglesChanged();
+  return followers_.size() - 1;
+}
+
+void AngleSync::removeAll() {
+  if (followers_.isEmpty()) return;
+  for (Follower& follower : followers_) {
+    follower.player->stop();
+    follower.scheduler->deleteLater();
+    follower.player->deleteLater();
+    follower.widget->deleteLater();
+  }
+  followers_.clear();
+  emit anglesChanged();
+}
+
+QVector<AngleSync::Angle> AngleSync::angles() const {
+  QVector<Angle> out;
+  out.reserve(followers_.size());
+  for (const Follower& follower : followers_) out.append(follower.info);
+  return out;
+}
+
+void AngleSync::setOffsetMs(int index, qint64 offsetMs) {
+  if (index < 0 || index >= followers_.size()) return;
+  Follower& follower = followers_[index];
+  follower.info.offsetMs = offsetMs;
+  alignExactly(follower, master_->currentPositionMs());
+  emit anglesChanged();
+}
+
+void AngleSync::setAngleVisible(int index, bool visible) {
+  if (index < 0 || index >= followers_.size()) return;
+  Follower& follower = followers_[index];
+  if (follower.visible == visible) return;
+  follower.visible = visible;
+  follower.widget->setVisible(visible);
+
+  if (!visible) {
+    follower.scheduler->cancel();
+    follower.player->pause();
+  } else {
+    alignExactly(follower, master_->currentPositionMs());
+    if (master_->isPlaying()) {
+      follower.player->setPlaybackRate(master_->playbackRate());
+      follower.player->play();
+    }
+  }
+  emit anglesChanged();
+}
+
+qint64 AngleSync::angleTimeMs(const Follower& follower, qint64 masterMs) const {
+  const qint64 dur = follower.player->duration();
+  const qint64 t = masterMs + follower.info.offsetMs;
+  return (dur > 0) ? std::clamp(t, qint64{0}, dur) : std::max<qint64>(0, t);
+}
+
+void AngleSync::alignExactly(Follower& follower, qint64 masterMs) {
+  follower.scheduler->cancel();
+  follower.player->setPosition(angleTimeMs(follower, masterMs));
+  follower.sinceDriftCheck.restart();
+}
+
+void AngleSync::onMasterPosition(qint64 masterMs) {
+  const bool playing = master_->isPlaying();
+  for (Follower& follower : followers_) {
+    if (!follower.visible) continue;
+    if (playing) {
+      correctDrift(follower, masterMs);
+    } else {
+      // Paused, scrubbing, stepping or shuttling: show the same instant; stale targets are dropped.
+      follower.scheduler->requestSeek(angleTimeMs(follower, masterMs));
+    }
+  }
+}
+
+void AngleSync::correctDrift(Follower& follower, qint64 masterMs) {
+  if (follower.sinceDriftCheck.elapsed() < kDriftCheckIntervalMs) return;
+  follower.sinceDriftCheck.restart();
+
+  const double masterRate = master_->playbackRate();
+  const qint64 driftMs = follower.player->position() - angleTimeMs(follower, masterMs);
+  if (qAbs(driftMs) > kHardResyncMs) {
+    alignExactly(follower, masterMs);
+    follower.player->setPlaybackRate(masterRate);
+    if (follower.player->playbackState() != QMediaPlayer::PlayingState) follower.player->play();
+    return;
+  }
+
+  // Ahead -> slightly slower, behind -> slightly faster, proportional to the drift.
+  double correction = 0.0;
+  if (qAbs(driftMs) > kDriftToleranceMs) {
+    correction = std::clamp(double(driftMs) / kCorrectionWindowMs, -kMaxRateCorrection, kMaxRateCorrection);
+  }
+  follower.player->setPlaybackRate(masterRate * (1.0 - correction));
+}
+
+void AngleSync::onMasterPlayingChanged(bool playing) {
+  const qint64 masterMs = master_->currentPositionMs();
+  for (Follower& follower : followers_) {
+    if (!follower.visible) continue;
+    alignExactly(follower, masterMs);
+    if (playing) {
+      follower.player->setPlaybackRate(master_->playbackRate());
+      follower.player->play();
+    } else {
+      follower.player->pause();
+    }
+  }
+}
+
+void AngleSync::onMasterRateChanged(double rate) {
+  for (Follower& follower : followers_) {
+    if (follower.visible) follower.player->setPlaybackRate(rate);
+  }
+}
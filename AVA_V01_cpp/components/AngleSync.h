@@ -0,0 +1,67 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+class QMediaPlayer;
+class QVideoWidget;
+class QWidget;
+class SeekScheduler;
+class VideoPlayer;
+
+/// Extra camera angles slaved to the main VideoPlayer, which stays the only clock (one timeline, tags in
+/// master time). Each angle is a muted QMediaPlayer + QVideoWidget at `master time + offsetMs`.
+/// While the master plays, drift is trimmed with small rate corrections and large jumps with a seek; while it
+/// is paused, scrubbed, stepped or shuttled, angles follow every position through a latest-wins SeekScheduler.
+/// Hidden angles are paused, so they cost no decoding.
+class AngleSync final : public QObject {
+  Q_OBJECT
+public:
+  struct Angle {
+    QString name;
+    QString path;
+    qint64 offsetMs = 0;  // angle time = master time + offsetMs
+  };
+
+  explicit AngleSync(VideoPlayer* master, QObject* parent = nullptr);
+  ~AngleSync() override;
+
+  /// Creates the angle's video widget as a child of `widgetParent` (the caller lays it out).
+  int addAngle(const Angle& angle, QWidget* widgetParent);
+  void removeAll();
+
+  int count() const { return int(followers_.size()); }
+  const Angle& angle(int index) const { return followers_.at(index).info; }
+  QVector<Angle> angles() const;
+  QVideoWidget* videoWidget(int index) const { return followers_.at(index).widget; }
+
+  void setOffsetMs(int index, qint64 offsetMs);
+  void setAngleVisible(int index, bool visible);
+  bool isAngleVisible(int index) const { return followers_.at(index).visible; }
+
+signals:
+  void anglesChanged();
+
+private:
+  struct Follower {
+    Angle info;
+    QMediaPlayer* player = nullptr;
+    QVideoWidget* widget = nullptr;
+    SeekScheduler* scheduler = nullptr;
+    bool visible = true;
+    QElapsedTimer sinceDriftCheck;
+  };
+
+  void onMasterPosition(qint64 masterMs);
+  void onMasterPlayingChanged(bool playing);
+  void onMasterRateChanged(double rate);
+  void alignExactly(Follower& follower, qint64 masterMs);
+  void correctDrift(Follower& follower, qint64 masterMs);
+  qint64 angleTimeMs(const Follower& follower, qint64 masterMs) const;
+
+  VideoPlayer* master_ = nullptr;
+  QVector<Follower> followers_;
+};
@@ -0,0 +1,83 @@
+#include "FrameCopier.h"
+#include "FrameRingBuffer.h"
+
+#include <QElapsedTimer>
+#include <QMutexLocker>
+#include <QThread>
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+constexpr size_t kMaxQueuedFrames = 3;  // decoder frames pinned at most while the worker catches up
+} // namespace
+
+FrameCopier::FrameCopier(QObject* parent) : QObject(parent) {
+  thread_ = QThread::create([this]() { run(); });
+  thread_->setObjectName(QStringLiteral("FrameCopier"));
+  thread_->start(QThread::LowPriority);
+}
+
+FrameCopier::~FrameCopier() {
+  {
+    QMutexLocker locker(&mutex_);
+    stopping_ = true;
+    jobs_.clear();
+    wake_.wakeOne();
+  }
+  thread_->wait();
+  delete thread_;
+}
+
+void FrameCopier::submit(qint64 timeMs, const QVideoFrame& frame) {
+  if (!frame.isValid()) return;
+  ++submitted_;
+  QMutexLocker locker(&mutex_);
+  if (jobs_.size() >= kMaxQueuedFrames) {
+    ++dropped_;
+    return;
+  }
+  jobs_.push_back({generation_, timeMs, frame});
+  wake_.wakeOne();
+}
+
+void FrameCopier::reset() {
+  ++generation_;
+  QMutexLocker locker(&mutex_);
+  jobs_.clear();
+}
+
+FrameCopier::Stats FrameCopier::stats() const {
+  Stats s;
+  s.submitted = submitted_;
+  s.dropped = dropped_;
+  s.copied = copied_;
+  s.totalCopyNs = totalCopyNs_;
+  s.maxCopyNs = maxCopyNs_;
+  return s;
+}
+
+void FrameCopier::run() {
+  for (;;) {
+    Job job;
+    {
+      QMutexLocker locker(&mutex_);
+      while (jobs_.empty() && !stopping_) wake_.wait(&mutex_);
+      if (stopping_) return;
+      job = std::move(jobs_.front());
+      jobs_.pop_front();
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    qint64 bytes = 0;
+    QVideoFrame copy = FrameRingBuffer::copyFrame(job.frame, &bytes);
+    job.frame = QVideoFrame();  // release the decoder's buffer before handing the copy over
+    const qint64 ns = timer.nsecsElapsed();
+    ++copied_;
+    totalCopyNs_ += ns;
+    maxCopyNs_ = std::max<qint64>(maxCopyNs_, ns);
+
+    if (copy.isValid()) emit frameCopied(job.generation, job.timeMs, copy, bytes);
+  }
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <QMutex>
+#include <QObject>
+#include <QVideoFrame>
+#include <QWaitCondition>
+#include <QtGlobal>
+
+#include <atomic>
+#include <deque>
+
+class QThread;
+
+/// Makes the CPU copies for the frame-step buffer on a worker thread, so playback never waits on
+/// a map or a hardware readback. Holds at most a few decoder frames at once; when the worker falls
+/// behind, new frames are dropped and the ring buffer sees the gap and starts a new window.
+class FrameCopier final : public QObject {
+  Q_OBJECT
+public:
+  struct Stats {
+    qint64 submitted = 0;
+    qint64 dropped = 0;
+    qint64 copied = 0;
+    qint64 totalCopyNs = 0;   // worker thread
+    qint64 maxCopyNs = 0;
+  };
+
+  explicit FrameCopier(QObject* parent = nullptr);
+  ~FrameCopier() override;
+
+  void submit(qint64 timeMs, const QVideoFrame& frame);
+  /// Drops queued frames; copies already in flight arrive with an old generation and are ignored.
+  void reset();
+  quint64 generation() const { return generation_; }
+  Stats stats() const;
+
+signals:
+  /// Queued to the owner's thread.
+  void frameCopied(quint64 generation, qint64 timeMs, const QVideoFrame& copy, qint64 bytes);
+
+private:
+  struct Job {
+    quint64 generation = 0;
+    qint64 timeMs = 0;
+    QVideoFrame frame;
+  };
+
+  void run();
+
+  QThread* thread_ = nullptr;
+  QMutex mutex_;
+  QWaitCondition wake_;
+  std::deque<Job> jobs_;
+  bool stopping_ = false;
+  quint64 generation_ = 0;    // owner thread
+  qint64 submitted_ = 0;      // owner thread
+  qint64 dropped_ = 0;        // owner thread
+  std::atomic<qint64> copied_{0};
+  std::atomic<qint64> totalCopyNs_{0};
+  std::atomic<qint64> maxCopyNs_{0};
+};
@@ -0,0 +1,100 @@
+#include "FrameRingBuffer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace {
+constexpr qint64 kMaxContinuityGapMs = 250;  // larger jumps between captures mean the user seeked
+constexpr qint64 kSameFrameToleranceMs = 2;
+} // namespace
+
+QVideoFrame FrameRingBuffer::copyFrame(const QVideoFrame& source, qint64* outBytes) {
+  QVideoFrame in(source);
+  if (!in.map(QVideoFrame::ReadOnly)) return {};
+
+  QVideoFrame out(in.surfaceFormat());
+  if (!out.map(QVideoFrame::WriteOnly)) {
+    in.unmap();
+    return {};
+  }
+
+  qint64 bytes = 0;
+  for (int plane = 0; plane < in.planeCount(); ++plane) {
+    const int srcStride = in.bytesPerLine(plane);
+    const int dstStride = out.bytesPerLine(plane);
+    if (srcStride <= 0 || dstStride <= 0) continue;
+    const int rows = std::min(in.mappedBytes(plane) / srcStride, out.mappedBytes(plane) / dstStride);
+    const int rowBytes = std::min(srcStride, dstStride);
+    const uchar* src = in.bits(plane);
+    uchar* dst = out.bits(plane);
+    if (srcStride == dstStride) {
+      std::memcpy(dst, src, size_t(rows) * size_t(srcStride));
+    } else {
+      for (int row = 0; row < rows; ++row) {
+        std::memcpy(dst + qint64(row) * dstStride, src + qint64(row) * srcStride, size_t(rowBytes));
+      }
+    }
+    bytes += out.mappedBytes(plane);
+  }
+
+  out.unmap();
+  in.unmap();
+  out.setStartTime(source.startTime());
+  out.setEndTime(source.endTime());
+  *outBytes = bytes;
+  return out;
+}
+
+void FrameRingBuffer::setBudgetBytes(qint64 bytes) {
+  budgetBytes_ = std::max<qint64>(0, bytes);
+  evictOverBudget();
+}
+
+void FrameRingBuffer::clear() {
+  entries_.clear();
+  usedBytes_ = 0;
+}
+
+void FrameRingBuffer::capture(qint64 timeMs, const QVideoFrame& frame) {
+  if (!isEnabled() || !frame.isValid()) return;
+  if (!entries_.empty() && qAbs(timeMs - entries_.back().timeMs) <= kSameFrameToleranceMs) return;
+
+  qint64 bytes = 0;
+  QVideoFrame copy = copyFrame(frame, &bytes);
+  append(timeMs, std::move(copy), bytes);
+}
+
+void FrameRingBuffer::append(qint64 timeMs, QVideoFrame copy, qint64 bytes) {
+  if (!isEnabled() || !copy.isValid() || bytes <= 0 || bytes > budgetBytes_) return;
+
+  if (!entries_.empty()) {
+    const qint64 lastMs = entries_.back().timeMs;
+    if (qAbs(timeMs - lastMs) <= kSameFrameToleranceMs) return;
+    if (timeMs < lastMs || timeMs - lastMs > kMaxContinuityGapMs) clear();
+  }
+
+  entries_.push_back({timeMs, std::move(copy), bytes});
+  usedBytes_ += bytes;
+  evictOverBudget();
+}
+
+const FrameRingBuffer::Entry* FrameRingBuffer::frameBefore(qint64 timeMs) const {
+  const auto it = std::lower_bound(entries_.cbegin(), entries_.cend(), timeMs - kSameFrameToleranceMs,
+                                   [](const Entry& e, qint64 ms) { return e.timeMs < ms; });
+  if (it == entries_.cbegin()) return nullptr;
+  return &*std::prev(it);
+}
+
+const FrameRingBuffer::Entry* FrameRingBuffer::frameAfter(qint64 timeMs) const {
+  const auto it = std::upper_bound(entries_.cbegin(), entries_.cend(), timeMs + kSameFrameToleranceMs,
+                                   [](qint64 ms, const Entry& e) { return ms < e.timeMs; });
+  return it == entries_.cend() ? nullptr : &*it;
+}
+
+void FrameRingBuffer::evictOverBudget() {
+  while (!entries_.empty() && usedBytes_ > budgetBytes_) {
+    usedBytes_ -= entries_.front().bytes;
+    entries_.pop_front();
+  }
+}
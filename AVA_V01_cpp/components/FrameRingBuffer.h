@@ -0,0 +1,47 @@
+#pragma once
+
+#include <QVideoFrame>
+#include <QtGlobal>
+
+#include <deque>
+
+/// Byte-bounded FIFO of CPU copies of recently decoded frames around the playhead.
+/// Frames are kept contiguous in time; a jump (seek) starts a new window.
+class FrameRingBuffer final {
+public:
+  struct Entry {
+    qint64 timeMs = 0;
+    QVideoFrame frame;
+    qint64 bytes = 0;
+  };
+
+  void setBudgetBytes(qint64 bytes);
+  qint64 budgetBytes() const { return budgetBytes_; }
+  qint64 usedBytes() const { return usedBytes_; }
+  bool isEnabled() const { return budgetBytes_ > 0; }
+  bool isEmpty() const { return entries_.empty(); }
+
+  void clear();
+
+  /// Deep-copies `frame` (releasing the decoder's buffer) and appends it, evicting the oldest frames over budget.
+  void capture(qint64 timeMs, const QVideoFrame& frame);
+  /// Appends a frame already copied with copyFrame() (e.g. on a worker thread).
+  void append(qint64 timeMs, QVideoFrame copy, qint64 bytes);
+
+  /// CPU copy so buffered frames don't pin the backend's (possibly hardware) frame pool. Safe to call
+  /// from any thread; returns an invalid frame when the source cannot be mapped.
+  static QVideoFrame copyFrame(const QVideoFrame& source, qint64* outBytes);
+
+  /// Closest buffered frame strictly before / after timeMs (ignoring the frame at timeMs itself), or nullptr.
+  const Entry* frameBefore(qint64 timeMs) const;
+  const Entry* frameAfter(qint64 timeMs) const;
+  /// Earliest buffered frame, or nullptr.
+  const Entry* oldest() const { return entries_.empty() ? nullptr : &entries_.front(); }
+
+private:
+  void evictOverBudget();
+
+  std::deque<Entry> entries_;  // ascending by timeMs
+  qint64 budgetBytes_ = 0;
+  qint64 usedBytes_ = 0;
+};
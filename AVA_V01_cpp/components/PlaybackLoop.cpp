@@ -0,0 +1,64 @@
+#include "PlaybackLoop.h"
+
+#include <algorithm>
+
+namespace {
+constexpr qint64 kHeadWindowMs = 500;                      // covers the seek back to A on the original file
+constexpr qint64 kHeadBudgetBytes = 64LL * 1024 * 1024;    // ~20 frames of 1080p NV12
+constexpr qint64 kHeadStartToleranceMs = 100;              // first cached frame must really be A's frame
+} // namespace
+
+PlaybackLoop::PlaybackLoop() {
+  head_.setBudgetBytes(kHeadBudgetBytes);
+}
+
+void PlaybackLoop::setInMs(qint64 ms) {
+  ms = std::max<qint64>(0, ms);
+  if (ms == inMs_) return;
+  inMs_ = ms;
+  if (outMs_ >= 0 && outMs_ <= inMs_) outMs_ = -1;
+  resetHead();
+}
+
+void PlaybackLoop::setOutMs(qint64 ms) {
+  if (ms <= 0) return;
+  if (inMs_ < 0 || ms <= inMs_) {
+    // Out without a usable in point loops from the start.
+    inMs_ = 0;
+    resetHead();
+  }
+  outMs_ = ms;
+}
+
+void PlaybackLoop::setRegion(qint64 inMs, qint64 outMs) {
+  clear();
+  setInMs(inMs);
+  setOutMs(outMs);
+}
+
+void PlaybackLoop::clear() {
+  inMs_ = -1;
+  outMs_ = -1;
+  resetHead();
+}
+
+void PlaybackLoop::captureHead(qint64 timeMs, const QVideoFrame& frame) {
+  if (!isActive() || headComplete_) return;
+  if (timeMs < inMs_) return;
+  if (timeMs >= inMs_ + kHeadWindowMs || timeMs >= outMs_) {
+    headComplete_ = !head_.isEmpty();
+    return;
+  }
+  head_.capture(timeMs, frame);
+}
+
+const FrameRingBuffer::Entry* PlaybackLoop::headFrame() const {
+  if (!headComplete_) return nullptr;
+  const FrameRingBuffer::Entry* first = head_.oldest();
+  return (first && first->timeMs - inMs_ <= kHeadStartToleranceMs) ? first : nullptr;
+}
+
+void PlaybackLoop::resetHead() {
+  head_.clear();
+  headComplete_ = false;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "FrameRingBuffer.h"
+
+#include <QtGlobal>
+
+/// A-B loop region plus a small cache of the first decoded frames after A.
+/// When playback wraps, the cached head is shown immediately while the decoder seeks back, so repeats
+/// don't flash the stale frame or stall on the GOP roll-forward to A.
+class PlaybackLoop final {
+public:
+  PlaybackLoop();
+
+  /// Either point may be moved while playing; an in point at or past the out point drops the out point.
+  void setInMs(qint64 ms);
+  void setOutMs(qint64 ms);
+  void setRegion(qint64 inMs, qint64 outMs);
+  void clear();
+
+  bool isActive() const { return inMs_ >= 0 && outMs_ > inMs_; }
+  qint64 inMs() const { return inMs_; }
+  qint64 outMs() const { return outMs_; }
+  bool shouldWrap(qint64 posMs) const { return isActive() && posMs >= outMs_; }
+
+  /// Feeds decoded frames; only frames in [in, in + head window) are kept, and only on the first pass.
+  void captureHead(qint64 timeMs, const QVideoFrame& frame);
+  /// First cached frame at or after the in point, or nullptr while the head is not buffered yet.
+  const FrameRingBuffer::Entry* headFrame() const;
+  /// Drops cached frames (e.g. playback switched to the proxy) without touching the region.
+  void resetHead();
+
+private:
+  qint64 inMs_ = -1;
+  qint64 outMs_ = -1;
+  FrameRingBuffer head_;
+  bool headComplete_ = false;
+};
@@ -0,0 +1,314 @@
+#include "PlaybackTelemetry.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QFontDatabase>
+#include <QGuiApplication>
+#include <QLabel>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QStandardPaths>
+#include <QTextStream>
+#include <QTimer>
+#include <QVideoFrame>
+#include <QVideoSink>
+#include <QWidget>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+constexpr int kWatchdogIntervalMs = 100;
+constexpr int kHudRefreshMs = 250;
+constexpr qint64 kMinStallMs = 400;
+constexpr qint64 kSeekGraceMs = 1500;   // a slow seek on a heavy file is not a stall
+constexpr qint64 kNearEndMs = 400;
+constexpr qint64 kSummaryIntervalMs = 10000;
+constexpr qint64 kMaxLogBytes = 5 * 1024 * 1024;
+constexpr double kDefaultFps = 25.0;
+constexpr double kLateFactor = 1.5;
+constexpr double kEmaWeight = 0.1;
+constexpr int kMaxStallAttempts = 3;    // nudge, reload, reload; then give up until the user plays again
+
+// One log for every player in the process: lines are written whole under the lock and tagged with
+// the player's instance number, so two players never interleave or rotate each other's file.
+struct SharedLog {
+  QMutex mutex;
+  QFile file;
+  int instances = 0;
+};
+
+SharedLog& sharedLog() {
+  static SharedLog* log = []() {
+    auto* shared = new SharedLog;  // leaked on purpose: players may log during static destruction
+    QString logDir = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
+    if (logDir.isEmpty()) logDir = QDir::tempPath();
+    logDir = QDir(logDir).filePath(QStringLiteral("logs"));
+    QDir().mkpath(logDir);
+    const QString logPath = QDir(logDir).filePath(QStringLiteral("playback.log"));
+    if (QFileInfo(logPath).size() > kMaxLogBytes) {
+      QFile::remove(logPath + QStringLiteral(".1"));
+      QFile::rename(logPath, logPath + QStringLiteral(".1"));
+    }
+    shared->file.setFileName(logPath);
+    shared->file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text);
+    return shared;
+  }();
+  return *log;
+}
+} // namespace
+
+PlaybackTelemetry::PlaybackTelemetry(QMediaPlayer* player, QVideoSink* sink, QObject* parent)
+  : QObject(parent), player_(player) {
+  clock_.start();
+
+  watchdog_ = new QTimer(this);
+  watchdog_->setInterval(kWatchdogIntervalMs);
+  connect(watchdog_, &QTimer::timeout, this, &PlaybackTelemetry::onWatchdogTick);
+
+  hudTimer_ = new QTimer(this);
+  hudTimer_->setInterval(kHudRefreshMs);
+  connect(hudTimer_, &QTimer::timeout, this, &PlaybackTelemetry::refreshHud);
+
+  if (sink) connect(sink, &QVideoSink::videoFrameChanged, this, &PlaybackTelemetry::onVideoFrame);
+  if (player_) {
+    connect(player_, &QMediaPlayer::playbackStateChanged, this, &PlaybackTelemetry::onPlaybackStateChanged);
+    connect(player_, &QMediaPlayer::mediaStatusChanged, this, &PlaybackTelemetry::onMediaStatusChanged);
+  }
+
+  // Events only (no per-frame lines), so the log stays small enough to attach to bug reports.
+  SharedLog& log = sharedLog();
+  QMutexLocker locker(&log.mutex);
+  instance_ = ++log.instances;
+}
+
+PlaybackTelemetry::~PlaybackTelemetry() {
+  delete hud_;
+}
+
+void PlaybackTelemetry::resetStats() {
+  stats_ = Stats();
+  lastFrameWallMs_ = -1;
+  lastFramePtsMs_ = -1;
+  seekIssuedWallMs_ = -1;
+  stallAttempt_ = 0;
+  stallAbandoned_ = false;
+}
+
+void PlaybackTelemetry::noteSeekIssued() {
+  seekIssuedWallMs_ = clock_.elapsed();
+  lastFrameWallMs_ = -1;
+  watchStartWallMs_ = seekIssuedWallMs_;
+}
+
+void PlaybackTelemetry::noteSeekLatency(qint64 latencyMs) {
+  ++stats_.seeksMeasured;
+  stats_.lastSeekLatencyMs = latencyMs;
+  stats_.maxSeekLatencyMs = std::max(stats_.maxSeekLatencyMs, latencyMs);
+  stats_.avgSeekLatencyMs += (double(latencyMs) - stats_.avgSeekLatencyMs) / double(stats_.seeksMeasured);
+}
+
+void PlaybackTelemetry::noteRecovery(const QString& action) {
+  ++stats_.recoveries;
+  logEvent(QStringLiteral("recovery %1").arg(action));
+}
+
+double PlaybackTelemetry::expectedFrameIntervalMs() const {
+  const double fps = nominalFps_ > 0.0 ? nominalFps_ : kDefaultFps;
+  const double rate = player_ ? std::max(0.01, player_->playbackRate()) : 1.0;
+  return 1000.0 / fps / rate;
+}
+
+qint64 PlaybackTelemetry::stallThresholdMs() const {
+  return std::max<qint64>(kMinStallMs, qRound64(expectedFrameIntervalMs() * 6.0));
+}
+
+void PlaybackTelemetry::onVideoFrame(const QVideoFrame& frame) {
+  if (injectingFrame_) return;
+  const qint64 now = clock_.elapsed();
+  const qint64 ptsMs = frame.startTime() >= 0 ? frame.startTime() / 1000 : -1;
+  ++stats_.framesDelivered;
+
+  if (seekIssuedWallMs_ >= 0) {
+    noteSeekLatency(now - seekIssuedWallMs_);
+    seekIssuedWallMs_ = -1;
+  } else if (lastFrameWallMs_ >= 0 && player_ && player_->playbackState() == QMediaPlayer::PlayingState) {
+    const double interval = double(now - lastFrameWallMs_);
+    const double expected = expectedFrameIntervalMs();
+    stats_.lastFrameIntervalMs = interval;
+    stats_.frameJitterMs += kEmaWeight * (std::abs(interval - expected) - stats_.frameJitterMs);
+    if (interval > expected * kLateFactor) ++stats_.lateFrames;
+
+    // Gaps in presentation time beyond one frame mean the backend skipped frames to keep up.
+    if (ptsMs >= 0 && lastFramePtsMs_ >= 0 && ptsMs > lastFramePtsMs_) {
+      const double frameMs = 1000.0 / (nominalFps_ > 0.0 ? nominalFps_ : kDefaultFps);
+      const qint64 missing = qRound64(double(ptsMs - lastFramePtsMs_) / frameMs) - 1;
+      if (missing > 0) stats_.droppedFrames += missing;
+    }
+  }
+
+  if (stallAttempt_ > 0) {
+    logEvent(QStringLiteral("stall cleared after %1 ms")
+                 .arg(now - std::max(lastFrameWallMs_, watchStartWallMs_)));
+    stallAttempt_ = 0;
+    stallAbandoned_ = false;
+  }
+  lastFrameWallMs_ = now;
+  lastFramePtsMs_ = ptsMs;
+  emit frameDelivered(ptsMs);
+}
+
+void PlaybackTelemetry::onPlaybackStateChanged(QMediaPlayer::PlaybackState state) {
+  // Recovery itself pauses (nudge) and stops (reload) the player, so neither may restart escalation;
+  // only a delivered frame, a new source, or the user pressing play after we gave up does.
+  if (state == QMediaPlayer::PlayingState && stallAbandoned_) {
+    stallAttempt_ = 0;
+    stallAbandoned_ = false;
+  }
+  lastFrameWallMs_ = -1;
+  if (state == QMediaPlayer::PlayingState) {
+    watchStartWallMs_ = clock_.elapsed();
+    watchdog_->start();
+  } else {
+    watchdog_->stop();
+  }
+}
+
+void PlaybackTelemetry::onMediaStatusChanged(QMediaPlayer::MediaStatus status) {
+  switch (status) {
+  case QMediaPlayer::BufferingMedia:
+    ++stats_.bufferingEvents;
+    logEvent(QStringLiteral("buffering"));
+    break;
+  case QMediaPlayer::StalledMedia:
+    ++stats_.bufferingEvents;
+    logEvent(QStringLiteral("backend reported stalled media"));
+    break;
+  case QMediaPlayer::InvalidMedia:
+    logEvent(QStringLiteral("invalid media: %1").arg(player_ ? player_->errorString() : QString()));
+    break;
+  case QMediaPlayer::LoadedMedia:
+    logEvent(QStringLiteral("loaded %1").arg(player_ ? player_->source().toLocalFile() : QString()));
+    break;
+  default:
+    break;
+  }
+}
+
+void PlaybackTelemetry::onWatchdogTick() {
+  if (stallAbandoned_ || !player_ || player_->playbackState() != QMediaPlayer::PlayingState) return;
+  if (!player_->hasVideo()) return;
+  const qint64 dur = player_->duration();
+  if (dur > 0 && player_->position() >= dur - kNearEndMs) return;
+
+  const qint64 now = clock_.elapsed();
+  if (now - lastSummaryWallMs_ >= kSummaryIntervalMs) {
+    lastSummaryWallMs_ = now;
+    logEvent(QStringLiteral("summary frames=%1 late=%2 dropped=%3 jitter=%4ms seekAvg=%5ms seekMax=%6ms")
+                 .arg(stats_.framesDelivered)
+                 .arg(stats_.lateFrames)
+                 .arg(stats_.droppedFrames)
+                 .arg(stats_.frameJitterMs, 0, 'f', 1)
+                 .arg(stats_.avgSeekLatencyMs, 0, 'f', 0)
+                 .arg(stats_.maxSeekLatencyMs));
+  }
+
+  // Escalation schedule: first attempt at the threshold, then at 3x, 6x, ... while frames stay absent.
+  const qint64 since = now - std::max(lastFrameWallMs_, watchStartWallMs_);
+  const qint64 threshold =
+      seekIssuedWallMs_ >= 0 ? std::max(stallThresholdMs(), kSeekGraceMs) : stallThresholdMs();
+  const qint64 due = threshold * (stallAttempt_ == 0 ? 1 : 3 * stallAttempt_);
+  if (since < due) return;
+
+  if (stallAttempt_ == 0) ++stats_.stallEvents;
+  if (stallAttempt_ >= kMaxStallAttempts) {
+    stallAbandoned_ = true;
+    ++stats_.abandonedStalls;
+    logEvent(QStringLiteral("stall unrecovered after %1 attempts noFrameFor=%2ms pos=%3ms source=%4")
+                 .arg(stallAttempt_)
+                 .arg(since)
+                 .arg(player_->position())
+                 .arg(player_->source().toLocalFile()));
+    emit stallAbandoned(since);
+    return;
+  }
+  ++stallAttempt_;
+  logEvent(QStringLiteral("stall attempt=%1 noFrameFor=%2ms pos=%3ms")
+               .arg(stallAttempt_)
+               .arg(since)
+               .arg(player_->position()));
+  emit stallDetected(stallAttempt_, since);
+}
+
+void PlaybackTelemetry::setHudVisible(bool visible) {
+  if (visible && !hud_) {
+    // Top-level tool tip window: QVideoWidget renders into a native surface that would cover a child overlay.
+    hud_ = new QLabel(nullptr, Qt::ToolTip | Qt::FramelessWindowHint | Qt::WindowTransparentForInput |
+                                   Qt::WindowDoesNotAcceptFocus);
+    hud_->setAttribute(Qt::WA_ShowWithoutActivating);
+    hud_->setAttribute(Qt::WA_TransparentForMouseEvents);
+    hud_->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    hud_->setStyleSheet(QStringLiteral("background-color: rgba(0, 0, 0, 170); color: #9eff9e; padding: 6px;"));
+  }
+  if (visible) {
+    hudTimer_->start();
+    refreshHud();
+  } else {
+    hudTimer_->stop();
+    if (hud_) hud_->hide();
+  }
+}
+
+bool PlaybackTelemetry::isHudVisible() const {
+  return hudTimer_->isActive();
+}
+
+void PlaybackTelemetry::refreshHud() {
+  if (!hud_) return;
+  const bool hostShown = hudHost_ && hudHost_->isVisible();
+  if (!hostShown || QGuiApplication::applicationState() != Qt::ApplicationActive) {
+    hud_->hide();
+    return;
+  }
+
+  const QString text =
+      QStringLiteral("pos %1 ms   rate %2x\n"
+                     "frames %3   late %4   dropped %5\n"
+                     "interval %6 ms   jitter %7 ms\n"
+                     "seek last %8 ms   avg %9 ms   max %10 ms\n"
+                     "buffering %11   stalls %12   recoveries %13   unrecovered %14")
+          .arg(player_ ? player_->position() : 0)
+          .arg(player_ ? player_->playbackRate() : 0.0, 0, 'f', 2)
+          .arg(stats_.framesDelivered)
+          .arg(stats_.lateFrames)
+          .arg(stats_.droppedFrames)
+          .arg(stats_.lastFrameIntervalMs, 0, 'f', 1)
+          .arg(stats_.frameJitterMs, 0, 'f', 1)
+          .arg(stats_.lastSeekLatencyMs)
+          .arg(stats_.avgSeekLatencyMs, 0, 'f', 0)
+          .arg(stats_.maxSeekLatencyMs)
+          .arg(stats_.bufferingEvents)
+          .arg(stats_.stallEvents)
+          .arg(stats_.recoveries)
+          .arg(stats_.abandonedStalls);
+  hud_->setText(text);
+  hud_->adjustSize();
+  hud_->move(hudHost_->mapToGlobal(QPoint(8, 8)));
+  if (!hud_->isVisible()) hud_->show();
+}
+
+QString PlaybackTelemetry::logFilePath() const {
+  return sharedLog().file.fileName();
+}
+
+void PlaybackTelemetry::logEvent(const QString& line) {
+  SharedLog& log = sharedLog();
+  QMutexLocker locker(&log.mutex);
+  if (!log.file.isOpen()) return;
+  QTextStream out(&log.file);
+  out << QDateTime::currentDateTime().toString(Qt::ISODateWithMs) << " [player " << instance_ << "] " << line
+      << '\n';
+  out.flush();
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QMediaPlayer>
+#include <QObject>
+#include <QString>
+#include <QtGlobal>
+
+class QLabel;
+class QTimer;
+class QVideoFrame;
+class QVideoSink;
+class QWidget;
+
+/// Playback health from real backend signals: frame delivery cadence, late/dropped frames, seek latency,
+/// buffering and stalls. Drives stall recovery, an optional on-screen HUD and an append-only log file
+/// shared by every player in the process (each line carries the player's instance number).
+class PlaybackTelemetry final : public QObject {
+  Q_OBJECT
+public:
+  struct Stats {
+    qint64 framesDelivered = 0;
+    qint64 lateFrames = 0;
+    qint64 droppedFrames = 0;
+    double lastFrameIntervalMs = 0.0;
+    double frameJitterMs = 0.0;       // EMA of |interval - expected|
+    qint64 lastSeekLatencyMs = -1;
+    double avgSeekLatencyMs = 0.0;
+    qint64 maxSeekLatencyMs = 0;
+    qint64 seeksMeasured = 0;
+    qint64 bufferingEvents = 0;
+    qint64 stallEvents = 0;
+    qint64 recoveries = 0;
+    qint64 abandonedStalls = 0;       // ladder exhausted without a frame
+  };
+
+  PlaybackTelemetry(QMediaPlayer* player, QVideoSink* sink, QObject* parent = nullptr);
+  ~PlaybackTelemetry() override;
+
+  const Stats& stats() const { return stats_; }
+  void resetStats();
+
+  /// Marks a user/programmatic seek; latency is measured to the next delivered frame.
+  void noteSeekIssued();
+  void noteSeekLatency(qint64 latencyMs);
+  void noteRecovery(const QString& action);
+  /// While set, frames reaching the sink are replays from the player's own buffers: not delivered
+  /// frames, not a seek's first frame, and no sign that a stall has cleared.
+  void setInjectingFrame(bool injecting) { injectingFrame_ = injecting; }
+
+  /// Expected frame rate of the current media (from the keyframe index); 0 = unknown.
+  void setNominalFrameRate(double fps) { nominalFps_ = fps; }
+
+  void setHudHost(QWidget* host) { hudHost_ = host; }
+  void setHudVisible(bool visible);
+  bool isHudVisible() const;
+
+  QString logFilePath() const;
+
+signals:
+  /// Emitted while playing and no frame arrived for the stall threshold; attempt grows while the stall persists.
+  void stallDetected(int attempt, qint64 stalledForMs);
+  /// Every recovery attempt failed; no more stallDetected until a frame arrives or the user plays again.
+  void stallAbandoned(qint64 stalledForMs);
+  void frameDelivered(qint64 presentationMs);
+
+private:
+  void onVideoFrame(const QVideoFrame& frame);
+  void onPlaybackStateChanged(QMediaPlayer::PlaybackState state);
+  void onMediaStatusChanged(QMediaPlayer::MediaStatus status);
+  void onWatchdogTick();
+  void refreshHud();
+  void logEvent(const QString& line);
+  double expectedFrameIntervalMs() const;
+  qint64 stallThresholdMs() const;
+
+  QMediaPlayer* player_ = nullptr;
+  QTimer* watchdog_ = nullptr;
+  QTimer* hudTimer_ = nullptr;
+  QWidget* hudHost_ = nullptr;
+  QLabel* hud_ = nullptr;
+  int instance_ = 0;
+
+  Stats stats_;
+  double nominalFps_ = 0.0;
+  QElapsedTimer clock_;
+  qint64 lastFrameWallMs_ = -1;      // -1 = no cadence yet (just started, paused or seeked)
+  qint64 watchStartWallMs_ = -1;     // when playback (re)started; stall reference before the first frame
+  qint64 lastFramePtsMs_ = -1;
+  qint64 seekIssuedWallMs_ = -1;
+  int stallAttempt_ = 0;
+  bool stallAbandoned_ = false;
+  bool injectingFrame_ = false;
+  qint64 lastSummaryWallMs_ = 0;
+};
@@ -0,0 +1,96 @@
+#include "SceneStrip.h"
+#include "SceneAnalysis.h"
+
+#include <QPainter>
+#include <QPaintEvent>
+#include <QResizeEvent>
+
+#include <algorithm>
+
+namespace {
+constexpr int kHeight = 10;
+constexpr float kMotionFullScale = 0.08f;   // residual luma change that fills the strip (busy play)
+const QColor kMotionColor(0xa1, 0xa1, 0xaa);
+const QColor kCutColor(0xef, 0x44, 0x44);
+} // namespace
+
+SceneStrip::SceneStrip(QWidget* parent)
+  : QWidget(parent) {
+  setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+  setFixedHeight(kHeight);
+}
+
+QSize SceneStrip::sizeHint() const {
+  return QSize(200, kHeight);
+}
+
+void SceneStrip::setAnalysisSource(SceneAnalyzer* analyzer) {
+  if (analyzer_ == analyzer) return;
+  if (analyzer_) disconnect(analyzer_, nullptr, this, nullptr);
+  analyzer_ = analyzer;
+  if (analyzer_) connect(analyzer_, &SceneAnalyzer::analysisChanged, this, &SceneStrip::invalidateCache);
+  invalidateCache();
+}
+
+void SceneStrip::setViewRangeMs(qint64 startMs, qint64 spanMs) {
+  if (startMs == viewStartMs_ && spanMs == viewSpanMs_) return;
+  viewStartMs_ = std::max<qint64>(0, startMs);
+  viewSpanMs_ = std::max<qint64>(0, spanMs);
+  invalidateCache();
+}
+
+void SceneStrip::invalidateCache() {
+  cacheValid_ = false;
+  update();
+}
+
+void SceneStrip::renderCache() {
+  const qreal dpr = devicePixelRatioF();
+  cache_ = QPixmap(size() * dpr);
+  cache_.setDevicePixelRatio(dpr);
+  cache_.fill(Qt::transparent);
+  cacheValid_ = true;
+
+  if (!analyzer_ || viewSpanMs_ <= 0 || width() <= 1) return;
+  const SceneAnalysis& analysis = analyzer_->analysis();
+  if (analysis.isEmpty()) return;
+
+  const double msPerPx = static_cast<double>(viewSpanMs_) / (width() - 1);
+  const int sampleCount = analysis.motionEnergy.size();
+
+  QPainter p(&cache_);
+  p.setPen(kMotionColor);
+  for (int x = 0; x < width(); ++x) {
+    const qint64 fromMs = viewStartMs_ + static_cast<qint64>(x * msPerPx);
+    const qint64 toMs = viewStartMs_ + static_cast<qint64>((x + 1) * msPerPx);
+    const int first = static_cast<int>(fromMs / SceneAnalysis::kSampleMs);
+    const int last = std::min(sampleCount, static_cast<int>(toMs / SceneAnalysis::kSampleMs) + 1);
+    if (first >= sampleCount) break;
+    const float motion = *std::max_element(analysis.motionEnergy.cbegin() + first,
+                                           analysis.motionEnergy.cbegin() + std::max(first + 1, last));
+    const int barHeight = static_cast<int>(std::min(1.0f, motion / kMotionFullScale) * (height() - 1));
+    if (barHeight > 0) p.drawLine(x, height() - 1, x, height() - 1 - barHeight);
+  }
+
+  p.setPen(kCutColor);
+  const auto firstCut = std::lower_bound(analysis.cutsMs.cbegin(), analysis.cutsMs.cend(), viewStartMs_);
+  for (auto it = firstCut; it != analysis.cutsMs.cend() && *it <= viewStartMs_ + viewSpanMs_; ++it) {
+    const int x = static_cast<int>((*it - viewStartMs_) / msPerPx);
+    p.drawLine(x, 0, x, height() - 1);
+  }
+}
+
+void SceneStrip::paintEvent(QPaintEvent* event) {
+  if (!cacheValid_ || cache_.size() != size() * devicePixelRatioF()) renderCache();
+
+  QPainter p(this);
+  if (!isEnabled()) p.setOpacity(0.5);
+  const QRect dirty = event->rect();
+  const qreal dpr = cache_.devicePixelRatio();
+  p.drawPixmap(dirty, cache_, QRectF(dirty.topLeft() * dpr, dirty.size() * dpr));
+}
+
+void SceneStrip::resizeEvent(QResizeEvent* event) {
+  QWidget::resizeEvent(event);
+  cacheValid_ = false;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <QPixmap>
+#include <QWidget>
+#include <QtGlobal>
+
+class SceneAnalyzer;
+
+// Motion-energy curve with shot cuts, drawn under the waveform with the viewport's ms -> x mapping.
+// Each column shows the peak motion of the samples it covers so short bursts survive zooming out;
+// cuts are full-height ticks. Cached until the view, size or analysis change.
+class SceneStrip final : public QWidget {
+  Q_OBJECT
+public:
+  explicit SceneStrip(QWidget* parent = nullptr);
+
+  void setAnalysisSource(SceneAnalyzer* analyzer);
+  void setViewRangeMs(qint64 startMs, qint64 spanMs);  // follows the TimelineViewport zoom
+
+  QSize sizeHint() const override;
+
+protected:
+  void paintEvent(QPaintEvent* event) override;
+  void resizeEvent(QResizeEvent* event) override;
+
+private:
+  void invalidateCache();
+  void renderCache();
+
+  SceneAnalyzer* analyzer_ = nullptr;
+  qint64 viewStartMs_ = 0;
+  qint64 viewSpanMs_ = 0;
+
+  QPixmap cache_;
+  bool cacheValid_ = false;
+};
@@ -2,8 +2,6 @@
 #include "../state/TagSession.h"
 #include "../style/StyleProps.h"
 
-#include <algorithm>
-
 #include <QLabel>
 #include <QHBoxLayout>
 #include <QFont>
@@ -69,14 +67,10 @@ void Scoreboard::setTagSession(TagSession* session) {
         if (tagSession_) disconnect(tagSession_, nullptr, this, nullptr);
         tagSession_ = session;
         if (tagSession_) {
-            connect(tagSession_, &TagSession::statsChanged, this, [this]() {
-                rebuildGoalTimeline();
-                updateScores();
-            });
+            connect(tagSession_, &TagSession::statsChanged, this, &Scoreboard::updateScores);
         }
     }
     updateTeamDisplay();
-    rebuildGoalTimeline();
     updateScores();
 }
 
@@ -86,34 +80,14 @@ void Scoreboard::setCurrentTimestampMs(qint64 positionMs) {
     updateScores();
 }
 
-void Scoreboard::rebuildGoalTimeline() {
-    homeGoalTimesMs_.clear();
-    awayGoalTimesMs_.clear();
-    if (!tagSession_) return;
-    for (const auto& tag : tagSession_->tags()) {
-        if (tag.mainEvent != QStringLiteral("Goal")) continue;
-        if (tag.team == QStringLiteral("Home")) {
-            homeGoalTimesMs_.append(tag.positionMs);
-        } else if (tag.team == QStringLiteral("Away")) {
-            awayGoalTimesMs_.append(tag.positionMs);
-        }
-    }
-    std::sort(homeGoalTimesMs_.begin(), homeGoalTimesMs_.end());
-    std::sort(awayGoalTimesMs_.begin(), awayGoalTimesMs_.end());
-}
-
-int Scoreboard::countGoalsAtOrBefore(const QVector<qint64>& sortedGoalTimesMs,
-                                     qint64 positionMs) const {
-    if (sortedGoalTimesMs.isEmpty()) return 0;
-    const auto it = std::upper_bound(sortedGoalTimesMs.begin(), sortedGoalTimesMs.end(), positionMs);
-    return static_cast<int>(it - sortedGoalTimesMs.begin());
-}
-
 void Scoreboard::updateScores() {
-    const int homeGoals = countGoalsAtOrBefore(homeGoalTimesMs_, currentTimestampMs_);
-    const int awayGoals = countGoalsAtOrBefore(awayGoalTimesMs_, currentTimestampMs_);
-    if (homeScoreLabel_) homeScoreLabel_->setText(QString::number(homeGoals));
-    if (awayScoreLabel_) awayScoreLabel_->setText(QString::number(awayGoals));
+    // The session's game-state timeline answers in O(log n), cheap enough for every frame.
+    const GameState state = tagSession_ ? tagSession_->gameState().stateAt(currentTimestampMs_) : GameState();
+    if (state.home.goals == shownHomeGoals_ && state.away.goals == shownAwayGoals_) return;
+    shownHomeGoals_ = state.home.goals;
+    shownAwayGoals_ = state.away.goals;
+    if (homeScoreLabel_) homeScoreLabel_->setText(QString::number(shownHomeGoals_));
+    if (awayScoreLabel_) awayScoreLabel_->setText(QString::number(shownAwayGoals_));
 }
 
 void Scoreboard::updateTeamDisplay() {
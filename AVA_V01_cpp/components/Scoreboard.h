@@ -1,6 +1,5 @@
 #pragma once
 
-#include <QVector>
 #include <QWidget>
 #include <QtGlobal>
 
@@ -18,15 +17,13 @@ public:
 
 private:
   void buildUi();
-  void rebuildGoalTimeline();
   void updateScores();
   void updateTeamDisplay();
-  int countGoalsAtOrBefore(const QVector<qint64>& sortedGoalTimesMs, qint64 positionMs) const;
 
   TagSession* tagSession_ = nullptr;
   qint64 currentTimestampMs_ = 0;
-  QVector<qint64> homeGoalTimesMs_;
-  QVector<qint64> awayGoalTimesMs_;
+  int shownHomeGoals_ = -1;
+  int shownAwayGoals_ = -1;
 
   QWidget* homeColorSwatch_ = nullptr;
   QLabel* homeTeamNameLabel_ = nullptr;
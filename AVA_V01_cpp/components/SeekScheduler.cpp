@@ -0,0 +1,106 @@
+#include "SeekScheduler.h"
+
+#include <QMediaPlayer>
+#include <QTimer>
+#include <QVideoSink>
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+constexpr qint64 kMinIntervalMs = 8;    // ~120 Hz ceiling on light files
+constexpr qint64 kMaxIntervalMs = 120;
+constexpr qint64 kMinTimeoutMs = 150;
+constexpr qint64 kMaxTimeoutMs = 1000;
+constexpr double kLatencyEmaWeight = 0.25;
+} // namespace
+
+SeekScheduler::SeekScheduler(QMediaPlayer* player, QVideoSink* sink, QObject* parent)
+  : QObject(parent), player_(player) {
+  paceTimer_ = new QTimer(this);
+  paceTimer_->setSingleShot(true);
+  paceTimer_->setTimerType(Qt::PreciseTimer);
+  connect(paceTimer_, &QTimer::timeout, this, &SeekScheduler::pump);
+
+  timeoutTimer_ = new QTimer(this);
+  timeoutTimer_->setSingleShot(true);
+  connect(timeoutTimer_, &QTimer::timeout, this, [this]() { completeInFlight(false); });
+
+  if (sink) {
+    connect(sink, &QVideoSink::videoFrameChanged, this, [this]() {
+      if (inFlight_ && !injectingFrame_) completeInFlight(true);
+    });
+  }
+}
+
+void SeekScheduler::requestSeek(qint64 posMs) {
+  const qint64 target = std::max<qint64>(0, posMs);
+  // Keyframe snapping maps a whole GOP of drag positions to one target; re-seeking to it changes nothing.
+  if (target == (inFlight_ ? inFlightMs_ : settledMs_)) {
+    pendingMs_ = -1;
+    return;
+  }
+  pendingMs_ = target;
+  pump();
+}
+
+void SeekScheduler::cancel() {
+  pendingMs_ = -1;
+  inFlightMs_ = -1;
+  settledMs_ = -1;  // the exact seek that follows moves off any keyframe target
+  inFlight_ = false;
+  paceTimer_->stop();
+  timeoutTimer_->stop();
+}
+
+void SeekScheduler::pump() {
+  if (inFlight_ || pendingMs_ < 0 || !player_) return;
+
+  if (sinceLastIssue_.isValid()) {
+    const qint64 wait = minIntervalMs() - sinceLastIssue_.elapsed();
+    if (wait > 0) {
+      if (!paceTimer_->isActive()) paceTimer_->start(int(wait));
+      return;
+    }
+  }
+
+  const qint64 target = pendingMs_;
+  pendingMs_ = -1;
+  issue(target);
+}
+
+void SeekScheduler::issue(qint64 posMs) {
+  inFlight_ = true;
+  inFlightMs_ = posMs;
+  inFlightClock_.start();
+  sinceLastIssue_.start();
+  timeoutTimer_->start(int(timeoutMs()));
+  player_->setPosition(posMs);
+}
+
+void SeekScheduler::completeInFlight(bool frameDelivered) {
+  timeoutTimer_->stop();
+  inFlight_ = false;
+
+  // A timeout is not a latency sample: feeding the timeout back in would raise the next timeout and
+  // interval with it. A stuck backend is already paced by the one-in-flight rule and the timeout.
+  if (frameDelivered) {
+    const qint64 latency = inFlightClock_.elapsed();
+    latencyEmaMs_ += kLatencyEmaWeight * (double(latency) - latencyEmaMs_);
+    emit seekLatencyMeasured(latency);
+  }
+  // Also after a timeout: the usual cause is a seek to the position already shown.
+  settledMs_ = std::exchange(inFlightMs_, -1);
+
+  pump();
+}
+
+qint64 SeekScheduler::minIntervalMs() const {
+  // The one-in-flight rule already bounds heavy files; the interval only keeps light files from
+  // spending the whole event loop on decode.
+  return std::clamp<qint64>(qRound64(latencyEmaMs_ * 0.25), kMinIntervalMs, kMaxIntervalMs);
+}
+
+qint64 SeekScheduler::timeoutMs() const {
+  return std::clamp<qint64>(qRound64(latencyEmaMs_ * 3.0), kMinTimeoutMs, kMaxTimeoutMs);
+}
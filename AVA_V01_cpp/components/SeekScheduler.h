@@ -0,0 +1,51 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QtGlobal>
+
+class QMediaPlayer;
+class QTimer;
+class QVideoSink;
+
+/// Latest-wins seek queue for live scrubbing.
+/// Keeps at most one seek in flight (completed when the sink delivers the next frame), coalesces
+/// everything requested meanwhile into a single pending target, and paces issues by measured latency.
+/// A request for the target already in flight or last shown is dropped: such a seek delivers no
+/// frame, so it would only wait out the timeout.
+class SeekScheduler final : public QObject {
+  Q_OBJECT
+public:
+  SeekScheduler(QMediaPlayer* player, QVideoSink* sink, QObject* parent = nullptr);
+
+  void requestSeek(qint64 posMs);
+  void cancel();                      // drop pending/in-flight bookkeeping (before an exact seek)
+  /// While set, frames reaching the sink are replays from the player's own buffers, not the decoder
+  /// answering a seek, and do not complete the one in flight.
+  void setInjectingFrame(bool injecting) { injectingFrame_ = injecting; }
+
+  qint64 averageLatencyMs() const { return qRound64(latencyEmaMs_); }
+
+signals:
+  void seekLatencyMeasured(qint64 latencyMs);
+
+private:
+  void pump();
+  void issue(qint64 posMs);
+  void completeInFlight(bool frameDelivered);
+  qint64 minIntervalMs() const;
+  qint64 timeoutMs() const;
+
+  QMediaPlayer* player_ = nullptr;
+  QTimer* paceTimer_ = nullptr;       // fires when the min interval since the last issue has elapsed
+  QTimer* timeoutTimer_ = nullptr;    // gives up on a seek whose frame never arrives
+
+  qint64 pendingMs_ = -1;
+  qint64 inFlightMs_ = -1;
+  qint64 settledMs_ = -1;             // target of the last completed seek
+  bool inFlight_ = false;
+  bool injectingFrame_ = false;
+  QElapsedTimer inFlightClock_;
+  QElapsedTimer sinceLastIssue_;
+  double latencyEmaMs_ = 40.0;
+};
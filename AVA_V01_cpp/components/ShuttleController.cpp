@@ -0,0 +1,75 @@
+#include "ShuttleController.h"
+
+#include "MediaIndex.h"
+
+#include <QTimer>
+
+#include <algorithm>
+
+namespace {
+constexpr int kTickMs = 40;  // 25 updates/s; SeekScheduler drops whatever the decoder can't keep up with
+} // namespace
+
+ShuttleController::ShuttleController(QObject* parent) : QObject(parent) {
+  tickTimer_ = new QTimer(this);
+  tickTimer_->setInterval(kTickMs);
+  tickTimer_->setTimerType(Qt::PreciseTimer);
+  connect(tickTimer_, &QTimer::timeout, this, &ShuttleController::tick);
+}
+
+void ShuttleController::start(double speed, qint64 startMs, qint64 durationMs, const MediaIndex* index) {
+  index_ = (index && index->isValid()) ? index : nullptr;
+  durationMs_ = durationMs;
+  virtualMs_ = double(std::max<qint64>(0, startMs));
+  lastRequestedMs_ = -1;
+  speed_ = speed;
+  active_ = true;
+  sinceLastTick_.start();
+  tickTimer_->start();
+}
+
+void ShuttleController::setSpeed(double speed) {
+  if (!active_) return;
+  advance();  // bank the distance covered at the old speed
+  speed_ = speed;
+}
+
+qint64 ShuttleController::stop() {
+  if (active_) advance();
+  active_ = false;
+  tickTimer_->stop();
+  return positionMs();
+}
+
+qint64 ShuttleController::positionMs() const {
+  return qRound64(virtualMs_);
+}
+
+bool ShuttleController::advance() {
+  const qint64 elapsed = sinceLastTick_.restart();
+  virtualMs_ += speed_ * double(elapsed);
+
+  if (virtualMs_ <= 0.0) {
+    virtualMs_ = 0.0;
+    return speed_ < 0.0;
+  }
+  if (durationMs_ > 0 && virtualMs_ >= double(durationMs_)) {
+    virtualMs_ = double(durationMs_);
+    return speed_ > 0.0;
+  }
+  return false;
+}
+
+void ShuttleController::tick() {
+  if (!active_) return;
+  const bool atBoundary = advance();
+
+  const qint64 pos = positionMs();
+  const qint64 target = index_ ? index_->keyframeAtOrBeforeMs(pos) : pos;
+  if (target != lastRequestedMs_) {
+    lastRequestedMs_ = target;
+    emit seekRequested(target);
+  }
+  emit positionChanged(pos);
+  if (atBoundary) emit boundaryReached();
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QtGlobal>
+
+class QTimer;
+struct MediaIndex;
+
+/// High-speed forward/reverse shuttle (8x-32x) without continuous decoding.
+/// Advances a virtual playhead on a timer and asks for seeks to the keyframe at or before it, so the
+/// decoder only ever produces one intra frame per update. The virtual playhead is the authoritative
+/// position while active (tags use it).
+class ShuttleController final : public QObject {
+  Q_OBJECT
+public:
+  explicit ShuttleController(QObject* parent = nullptr);
+
+  /// `index` may be nullptr (e.g. all-intra proxy): seeks then go to the virtual position itself.
+  void start(double speed, qint64 startMs, qint64 durationMs, const MediaIndex* index);
+  void setSpeed(double speed);
+  /// Stops and returns the virtual position.
+  qint64 stop();
+
+  bool isActive() const { return active_; }
+  double speed() const { return speed_; }
+  qint64 positionMs() const;
+
+signals:
+  void seekRequested(qint64 posMs);       // keyframe to show
+  void positionChanged(qint64 posMs);     // virtual playhead (timeline / tagging)
+  void boundaryReached();                 // start or end of media
+
+private:
+  void tick();
+  bool advance();  // moves the virtual playhead; true when it hit the end it is heading for
+
+  QTimer* tickTimer_ = nullptr;
+  QElapsedTimer sinceLastTick_;
+  const MediaIndex* index_ = nullptr;
+  bool active_ = false;
+  double speed_ = 0.0;
+  double virtualMs_ = 0.0;
+  qint64 durationMs_ = 0;
+  qint64 lastRequestedMs_ = -1;
+};
@@ -0,0 +1,423 @@
+#include "TagMarkerTrack.h"
+
+#include <QMouseEvent>
+#include <QPainter>
+#include <QPaintEvent>
+#include <QResizeEvent>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+constexpr qint64 kLevel0BucketMs = 100;
+constexpr int kMaxLevels = 40;
+constexpr int kMinSpacingPx = 8;   // markers closer than this merge into one cluster
+constexpr int kHitSlopPx = 5;
+const QColor kMixedClusterColor(150, 150, 150);
+} // namespace
+
+TagMarkerTrack::TagMarkerTrack(QWidget* parent)
+  : QWidget(parent) {
+  setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+  setFixedHeight(14);
+  setMouseTracking(true);
+  setAttribute(Qt::WA_OpaquePaintEvent, false);
+}
+
+QSize TagMarkerTrack::sizeHint() const {
+  return QSize(200, 14);
+}
+
+void TagMarkerTrack::setMarkers(QVector<Marker> markers) {
+  std::stable_sort(markers.begin(), markers.end(), [](const Marker& a, const Marker& b) {
+    return a.timeMs < b.timeMs;
+  });
+  markers_ = std::move(markers);
+  markerTimes_.clear();
+  for (const Marker& m : std::as_const(markers_)) {
+    if (m.key != 0) markerTimes_.insert(m.key, m.timeMs);
+  }
+  rebuildLevels();
+  invalidateCache();
+}
+
+void TagMarkerTrack::updateMarkers(const QVector<quint64>& removedKeys, const QVector<Marker>& upserts) {
+  QVector<qint64> touchedMs;
+  touchedMs.reserve(removedKeys.size() + upserts.size() * 2);
+  qint64 timeMs = 0;
+  for (const quint64 key : removedKeys) {
+    if (removeMarker(key, &timeMs)) touchedMs.append(timeMs);
+  }
+  for (const Marker& m : upserts) {
+    if (removeMarker(m.key, &timeMs)) touchedMs.append(timeMs);
+    insertMarker(m);
+    touchedMs.append(m.timeMs);
+  }
+  if (touchedMs.isEmpty()) return;
+
+  if (markers_.isEmpty() || levels_.isEmpty()) {
+    rebuildLevels();
+  } else {
+    // Several changes often share a bucket (same play, undo of a batch); each bucket is recomputed once.
+    std::sort(touchedMs.begin(), touchedMs.end());
+    qint64 previousBucket = -1;
+    for (const qint64 ms : std::as_const(touchedMs)) {
+      if (ms / kLevel0BucketMs == previousBucket) continue;
+      previousBucket = ms / kLevel0BucketMs;
+      refreshBuckets(ms);
+    }
+    fitLevelCount();
+  }
+  invalidateCache();
+}
+
+bool TagMarkerTrack::removeMarker(quint64 key, qint64* timeMs) {
+  const auto found = markerTimes_.constFind(key);
+  if (key == 0 || found == markerTimes_.cend()) return false;
+  *timeMs = found.value();
+  markerTimes_.erase(found);
+  auto it = std::lower_bound(markers_.begin(), markers_.end(), *timeMs,
+                             [](const Marker& m, qint64 ms) { return m.timeMs < ms; });
+  for (; it != markers_.end() && it->timeMs == *timeMs; ++it) {
+    if (it->key == key) {
+      markers_.erase(it);
+      return true;
+    }
+  }
+  return true;
+}
+
+void TagMarkerTrack::insertMarker(const Marker& marker) {
+  const auto it = std::upper_bound(markers_.begin(), markers_.end(), marker.timeMs,
+                                   [](qint64 ms, const Marker& m) { return ms < m.timeMs; });
+  markers_.insert(it, marker);
+  if (marker.key != 0) markerTimes_.insert(marker.key, marker.timeMs);
+}
+
+// Recomputes the one bucket per level that contains timeMs: level 0 from the markers in it, each coarser
+// level from the (at most two) finer clusters it covers. Buckets that became empty are erased.
+void TagMarkerTrack::refreshBuckets(qint64 timeMs) {
+  for (int k = 0; k < levels_.size(); ++k) {
+    const qint64 bucketMs = kLevel0BucketMs << k;
+    const qint64 startMs = (timeMs / bucketMs) * bucketMs;
+    const qint64 endMs = startMs + bucketMs;
+
+    Cluster cluster;
+    if (k == 0) {
+      auto m = std::lower_bound(markers_.cbegin(), markers_.cend(), startMs,
+                                [](const Marker& marker, qint64 ms) { return marker.timeMs < ms; });
+      for (; m != markers_.cend() && m->timeMs < endMs; ++m) {
+        const Cluster single{m->timeMs, m->timeMs, m->timeMs, 1, m->color.rgb(), false};
+        if (cluster.count == 0) cluster = single;
+        else cluster.absorb(single);
+      }
+    } else {
+      const QVector<Cluster>& finer = levels_.at(k - 1);
+      auto c = std::lower_bound(finer.cbegin(), finer.cend(), startMs,
+                                [](const Cluster& f, qint64 ms) { return f.firstMs < ms; });
+      for (; c != finer.cend() && c->firstMs < endMs; ++c) {
+        if (cluster.count == 0) cluster = *c;
+        else cluster.absorb(*c);
+      }
+    }
+
+    QVector<Cluster>& level = levels_[k];
+    const auto slot = std::lower_bound(level.begin(), level.end(), startMs,
+                                       [](const Cluster& c, qint64 ms) { return c.firstMs < ms; });
+    const bool present = slot != level.end() && slot->firstMs < endMs;
+    if (cluster.count == 0) {
+      if (present) level.erase(slot);
+    } else if (present) {
+      *slot = cluster;
+    } else {
+      level.insert(slot, cluster);
+    }
+  }
+}
+
+// Keeps the invariant of rebuildLevels(): levels stop at the first one with a single cluster.
+void TagMarkerTrack::fitLevelCount() {
+  for (int k = 0; k < levels_.size(); ++k) {
+    if (levels_.at(k).size() <= 1) {
+      levels_.resize(k + 1);
+      break;
+    }
+  }
+  while (levels_.size() < kMaxLevels && levels_.constLast().size() > 1) {
+    levels_.append(coarsen(levels_.constLast(), kLevel0BucketMs << levels_.size()));
+  }
+}
+
+void TagMarkerTrack::setSuggestions(QVector<Marker> suggestions) {
+  std::stable_sort(suggestions.begin(), suggestions.end(), [](const Marker& a, const Marker& b) {
+    return a.timeMs < b.timeMs;
+  });
+  suggestions_ = std::move(suggestions);
+  invalidateCache();
+}
+
+void TagMarkerTrack::setDurationMs(qint64 durMs) {
+  durMs = std::max<qint64>(0, durMs);
+  if (durMs == durationMs_) return;
+  durationMs_ = durMs;
+  viewStartMs_ = 0;
+  viewSpanMs_ = durMs;
+  invalidateCache();
+}
+
+void TagMarkerTrack::setViewRangeMs(qint64 startMs, qint64 spanMs) {
+  if (startMs == viewStartMs_ && spanMs == viewSpanMs_) return;
+  viewStartMs_ = std::max<qint64>(0, startMs);
+  viewSpanMs_ = std::max<qint64>(0, spanMs);
+  invalidateCache();
+}
+
+void TagMarkerTrack::setPlayheadMs(qint64 posMs) {
+  if (posMs == playheadMs_) return;
+  const qint64 previousMs = playheadMs_;
+  playheadMs_ = posMs;
+  if (viewSpanMs_ <= 0 || xForMs(previousMs) == xForMs(posMs)) return;
+  // Only the two playhead columns are repainted; the cached marker layer is blitted underneath.
+  update(playheadRect(previousMs));
+  update(playheadRect(posMs));
+}
+
+void TagMarkerTrack::clear() {
+  markers_.clear();
+  markerTimes_.clear();
+  levels_.clear();
+  suggestions_.clear();
+  durationMs_ = 0;
+  viewStartMs_ = 0;
+  viewSpanMs_ = 0;
+  playheadMs_ = 0;
+  invalidateCache();
+}
+
+void TagMarkerTrack::rebuildLevels() {
+  levels_.clear();
+  if (markers_.isEmpty()) return;
+
+  QVector<Cluster> level;
+  level.reserve(markers_.size());
+  for (const Marker& m : markers_) {
+    const QRgb rgb = m.color.rgb();
+    if (!level.isEmpty() && level.constLast().firstMs / kLevel0BucketMs == m.timeMs / kLevel0BucketMs) {
+      Cluster& c = level.last();
+      c.lastMs = m.timeMs;
+      c.sumMs += m.timeMs;
+      ++c.count;
+      c.mixed = c.mixed || c.color != rgb;
+      continue;
+    }
+    level.append({m.timeMs, m.timeMs, m.timeMs, 1, rgb, false});
+  }
+  levels_.append(level);
+
+  // Each level halves the resolution of the previous one by merging neighbouring buckets.
+  for (int k = 1; k < kMaxLevels && levels_.constLast().size() > 1; ++k) {
+    levels_.append(coarsen(levels_.constLast(), kLevel0BucketMs << k));
+  }
+}
+
+QVector<TagMarkerTrack::Cluster> TagMarkerTrack::coarsen(const QVector<Cluster>& finer, qint64 bucketMs) {
+  QVector<Cluster> coarser;
+  coarser.reserve(finer.size() / 2 + 1);
+  for (const Cluster& c : finer) {
+    if (!coarser.isEmpty() && coarser.constLast().firstMs / bucketMs == c.firstMs / bucketMs) {
+      coarser.last().absorb(c);
+      continue;
+    }
+    coarser.append(c);
+  }
+  return coarser;
+}
+
+int TagMarkerTrack::levelForWidth() const {
+  if (levels_.isEmpty() || width() <= 0 || viewSpanMs_ <= 0) return 0;
+  const double minBucketMs = static_cast<double>(kMinSpacingPx) * viewSpanMs_ / width();
+  int level = 0;
+  while (level + 1 < levels_.size() && static_cast<double>(kLevel0BucketMs << level) < minBucketMs) ++level;
+  return level;
+}
+
+const QVector<TagMarkerTrack::Cluster>* TagMarkerTrack::visibleClusters() const {
+  if (levels_.isEmpty()) return nullptr;
+  return &levels_.at(levelForWidth());
+}
+
+int TagMarkerTrack::clusterAt(int x) const {
+  const QVector<Cluster>* clusters = visibleClusters();
+  if (!clusters || clusters->isEmpty() || viewSpanMs_ <= 0) return -1;
+
+  const qint64 targetMs = msForX(x);
+  const auto it = std::lower_bound(clusters->cbegin(), clusters->cend(), targetMs,
+                                   [](const Cluster& c, qint64 ms) { return c.centerMs() < ms; });
+  const int right = static_cast<int>(it - clusters->cbegin());
+
+  int best = -1;
+  int bestDistance = kHitSlopPx + 1;
+  for (int i : {right - 1, right}) {
+    if (i < 0 || i >= clusters->size()) continue;
+    const int distance = std::abs(xForMs(clusters->at(i).centerMs()) - x);
+    if (distance < bestDistance) {
+      bestDistance = distance;
+      best = i;
+    }
+  }
+  return best;
+}
+
+int TagMarkerTrack::suggestionAt(int x) const {
+  if (suggestions_.isEmpty() || viewSpanMs_ <= 0) return -1;
+
+  const auto it = std::lower_bound(suggestions_.cbegin(), suggestions_.cend(), msForX(x),
+                                   [](const Marker& m, qint64 ms) { return m.timeMs < ms; });
+  const int right = static_cast<int>(it - suggestions_.cbegin());
+
+  int best = -1;
+  int bestDistance = kHitSlopPx + 1;
+  for (int i : {right - 1, right}) {
+    if (i < 0 || i >= suggestions_.size()) continue;
+    const int distance = std::abs(xForMs(suggestions_.at(i).timeMs) - x);
+    if (distance < bestDistance) {
+      bestDistance = distance;
+      best = i;
+    }
+  }
+  return best;
+}
+
+// Same mapping as TimelineViewport so markers line up with the groove at every zoom level.
+int TagMarkerTrack::xForMs(qint64 ms) const {
+  if (viewSpanMs_ <= 0 || width() <= 1) return 0;
+  const double x = static_cast<double>(ms - viewStartMs_) * (width() - 1) / viewSpanMs_;
+  return static_cast<int>(std::floor(std::clamp(x, -1.0e6, 1.0e6)));
+}
+
+qint64 TagMarkerTrack::msForX(int x) const {
+  if (viewSpanMs_ <= 0 || width() <= 1) return 0;
+  return viewStartMs_ + (static_cast<qint64>(x) * viewSpanMs_) / (width() - 1);
+}
+
+QRect TagMarkerTrack::playheadRect(qint64 posMs) const {
+  return QRect(xForMs(posMs) - 1, 0, 3, height());
+}
+
+void TagMarkerTrack::invalidateCache() {
+  cacheValid_ = false;
+  update();
+}
+
+void TagMarkerTrack::renderCache() {
+  const qreal dpr = devicePixelRatioF();
+  cache_ = QPixmap(size() * dpr);
+  cache_.setDevicePixelRatio(dpr);
+  cache_.fill(Qt::transparent);
+  cacheValid_ = true;
+
+  QPainter p(&cache_);
+  p.setRenderHint(QPainter::Antialiasing, true);
+
+  // Static track
+  const int midY = height() / 2;
+  QColor trackColor = palette().color(QPalette::Mid);
+  trackColor.setAlpha(90);
+  p.fillRect(QRect(0, midY - 1, width(), 2), trackColor);
+
+  if (viewSpanMs_ <= 0) return;
+
+  // Suggestions first (hollow rings) so real tags stay on top; one ring per kMinSpacingPx at most.
+  const int ringDiameter = height() - 6;
+  if (!suggestions_.isEmpty()) {
+    const qint64 slopMs = (static_cast<qint64>(ringDiameter) * viewSpanMs_) / std::max(1, width() - 1);
+    auto it = std::lower_bound(suggestions_.cbegin(), suggestions_.cend(), viewStartMs_ - slopMs,
+                               [](const Marker& m, qint64 ms) { return m.timeMs < ms; });
+    int lastX = std::numeric_limits<int>::min();
+    p.setBrush(Qt::NoBrush);
+    for (; it != suggestions_.cend() && it->timeMs <= viewStartMs_ + viewSpanMs_ + slopMs; ++it) {
+      const int x = xForMs(it->timeMs);
+      if (x - lastX < kMinSpacingPx) continue;
+      lastX = x;
+      p.setPen(QPen(it->color, 1.5));
+      p.drawEllipse(QRectF(x - ringDiameter / 2.0, midY - ringDiameter / 2.0, ringDiameter, ringDiameter));
+    }
+  }
+
+  const QVector<Cluster>* clusters = visibleClusters();
+  if (!clusters) return;
+
+  // Markers: single tags are thin ticks, clusters are dots sized by log2(count) with the count inside.
+  QFont countFont = font();
+  countFont.setPixelSize(std::max(7, height() - 6));
+  p.setFont(countFont);
+  const int maxDiameter = height() - 2;
+  // Only clusters inside the visible range (plus a dot's width either side) are drawn.
+  const qint64 slopMs = (static_cast<qint64>(maxDiameter) * viewSpanMs_) / std::max(1, width() - 1);
+  const qint64 viewEndMs = viewStartMs_ + viewSpanMs_ + slopMs;
+  auto it = std::lower_bound(clusters->cbegin(), clusters->cend(), viewStartMs_ - slopMs,
+                             [](const Cluster& c, qint64 ms) { return c.centerMs() < ms; });
+  for (; it != clusters->cend() && it->centerMs() <= viewEndMs; ++it) {
+    const Cluster& c = *it;
+    const QColor color = c.mixed ? kMixedClusterColor : QColor::fromRgb(c.color);
+    const int x = xForMs(c.centerMs());
+    if (c.count == 1) {
+      p.fillRect(QRect(x - 1, 2, 2, height() - 4), color);
+      continue;
+    }
+    const int diameter = std::min(maxDiameter, 6 + 2 * static_cast<int>(std::log2(c.count)));
+    const QRect dot(x - diameter / 2, midY - diameter / 2, diameter, diameter);
+    p.setPen(Qt::NoPen);
+    p.setBrush(color);
+    p.drawEllipse(dot);
+    if (diameter >= 10) {
+      p.setPen(qGray(color.rgb()) > 140 ? QColor(20, 20, 20) : QColor(252, 252, 252));
+      p.drawText(dot, Qt::AlignCenter, c.count > 99 ? QStringLiteral("99+") : QString::number(c.count));
+    }
+  }
+}
+
+void TagMarkerTrack::paintEvent(QPaintEvent* event) {
+  if (!cacheValid_ || cache_.size() != size() * devicePixelRatioF()) renderCache();
+
+  QPainter p(this);
+  const QRect dirty = event->rect();
+  const qreal dpr = cache_.devicePixelRatio();
+  p.drawPixmap(dirty, cache_, QRectF(dirty.topLeft() * dpr, dirty.size() * dpr));
+
+  if (viewSpanMs_ > 0 && isEnabled()) {
+    p.fillRect(QRect(xForMs(playheadMs_), 0, 1, height()), palette().color(QPalette::Highlight));
+  }
+}
+
+void TagMarkerTrack::resizeEvent(QResizeEvent* event) {
+  QWidget::resizeEvent(event);
+  cacheValid_ = false;
+}
+
+void TagMarkerTrack::mousePressEvent(QMouseEvent* event) {
+  if (event->button() == Qt::LeftButton && isEnabled()) {
+    const int x = event->position().toPoint().x();
+    const int index = clusterAt(x);
+    if (index >= 0) {
+      emit markerClicked(visibleClusters()->at(index).firstMs);
+      event->accept();
+      return;
+    }
+    const int suggestion = suggestionAt(x);
+    if (suggestion >= 0) {
+      emit markerClicked(suggestions_.at(suggestion).timeMs);
+      event->accept();
+      return;
+    }
+  }
+  QWidget::mousePressEvent(event);
+}
+
+void TagMarkerTrack::mouseMoveEvent(QMouseEvent* event) {
+  const int x = event->position().toPoint().x();
+  const bool overMarker = isEnabled() && (clusterAt(x) >= 0 || suggestionAt(x) >= 0);
+  setCursor(overMarker ? Qt::PointingHandCursor : Qt::ArrowCursor);
+  QWidget::mouseMoveEvent(event);
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <QColor>
+#include <QHash>
+#include <QPixmap>
+#include <QVector>
+#include <QWidget>
+#include <QtGlobal>
+
+// Strip above the timeline viewport that draws one marker per tag, colored by team.
+// Tags are pre-clustered into power-of-two time buckets (level 0 = 100 ms); paint picks the coarsest
+// level that keeps markers at least a few pixels apart at the current zoom, so thousands of tags stay readable.
+// Rendering is layered: the track and markers live in a cached pixmap rebuilt only when tags, size or the
+// visible range change; the playhead is drawn on top and a position update only invalidates its old/new column.
+// Keyed markers can be patched with updateMarkers(), which recomputes only the buckets holding the changed
+// times (one per level) instead of re-clustering every tag.
+class TagMarkerTrack final : public QWidget {
+  Q_OBJECT
+public:
+  struct Marker {
+    qint64 timeMs = 0;
+    QColor color;
+    quint64 key = 0;                  // identifies a tag for updateMarkers(); unused by suggestions
+  };
+
+  explicit TagMarkerTrack(QWidget* parent = nullptr);
+
+  void setMarkers(QVector<Marker> markers);
+  /// Drops the markers with removedKeys, then adds or replaces each of upserts by key.
+  void updateMarkers(const QVector<quint64>& removedKeys, const QVector<Marker>& upserts);
+  void setSuggestions(QVector<Marker> suggestions);   // drawn hollow; not clustered, thinned by spacing
+  void setDurationMs(qint64 durMs);
+  void setViewRangeMs(qint64 startMs, qint64 spanMs);  // follows the TimelineViewport zoom
+  void setPlayheadMs(qint64 posMs);
+  void clear();
+
+  QSize sizeHint() const override;
+
+signals:
+  void markerClicked(qint64 timeMs);  // earliest tag of the clicked cluster, or the clicked suggestion
+
+protected:
+  void paintEvent(QPaintEvent* event) override;
+  void resizeEvent(QResizeEvent* event) override;
+  void mousePressEvent(QMouseEvent* event) override;
+  void mouseMoveEvent(QMouseEvent* event) override;
+
+private:
+  struct Cluster {
+    qint64 firstMs = 0;
+    qint64 lastMs = 0;
+    qint64 sumMs = 0;
+    int count = 0;
+    QRgb color = 0;
+    bool mixed = false;               // tags of more than one color fall in this bucket
+
+    qint64 centerMs() const { return sumMs / count; }
+    void absorb(const Cluster& later) {
+      lastMs = later.lastMs;
+      sumMs += later.sumMs;
+      count += later.count;
+      mixed = mixed || later.mixed || color != later.color;
+    }
+  };
+
+  void rebuildLevels();
+  static QVector<Cluster> coarsen(const QVector<Cluster>& finer, qint64 bucketMs);
+  bool removeMarker(quint64 key, qint64* timeMs);
+  void insertMarker(const Marker& marker);
+  void refreshBuckets(qint64 timeMs);
+  void fitLevelCount();
+  int levelForWidth() const;
+  const QVector<Cluster>* visibleClusters() const;
+  int clusterAt(int x) const;
+  int suggestionAt(int x) const;
+  int xForMs(qint64 ms) const;
+  qint64 msForX(int x) const;
+  QRect playheadRect(qint64 posMs) const;
+  void invalidateCache();
+  void renderCache();
+
+  QVector<Marker> markers_;           // sorted by timeMs
+  QHash<quint64, qint64> markerTimes_;  // key -> timeMs, to find a keyed marker by binary search
+  QVector<QVector<Cluster>> levels_;  // levels_[k] buckets are kLevel0BucketMs << k wide, sorted by time
+  QVector<Marker> suggestions_;       // sorted by timeMs
+  qint64 durationMs_ = 0;
+  qint64 viewStartMs_ = 0;
+  qint64 viewSpanMs_ = 0;
+  qint64 playheadMs_ = 0;
+
+  QPixmap cache_;                     // track + markers; playhead is painted over it
+  bool cacheValid_ = false;
+};
@@ -1,51 +1,23 @@
 #include "TimelineBar.h"
 #include "../style/StyleProps.h"
+#include "ThumbnailSprites.h"
+#include "TimelineViewport.h"
+#include "WaveformStrip.h"
+#include "SceneStrip.h"
 
+#include <QCoreApplication>
 #include <QHBoxLayout>
 #include <QLabel>
 #include <QLineEdit>
-#include <QSlider>
-#include <QElapsedTimer>
 #include <QEvent>
 #include <QKeyEvent>
 #include <QMouseEvent>
-#include <QStyle>
-#include <QStyleOptionSlider>
+#include <QVBoxLayout>
+#include <QPixmap>
 
 
 namespace {
-constexpr qint64 kScrubThrottleMs = 33; // ~30Hz
 constexpr qint64 kSeekCommitToleranceMs = 250;
-
-// Click-to-seek slider (keeps your "real player" feel).
-class ClickSeekSlider final : public QSlider {
-public:
-  explicit ClickSeekSlider(Qt::Orientation o, QWidget* parent = nullptr)
-    : QSlider(o, parent) {}
-
-protected:
-  void mousePressEvent(QMouseEvent* e) override {
-    if (e->button() == Qt::LeftButton) {
-      QStyleOptionSlider opt;
-      initStyleOption(&opt);
-
-      const QRect handleRect =
-        style()->subControlRect(QStyle::CC_Slider, &opt, QStyle::SC_SliderHandle, this);
-
-      const QPoint p = e->position().toPoint();
-      const bool clickedHandle = handleRect.contains(p);
-
-      if (!clickedHandle) {
-        const int pos = (orientation() == Qt::Horizontal) ? p.x() : p.y();
-        const int span = (orientation() == Qt::Horizontal) ? width() : height();
-        const int v = QStyle::sliderValueFromPosition(minimum(), maximum(), pos, span);
-        setValue(v);
-        // Let the default behavior continue; we'll treat this as an immediate scrub-release.
-      }
-    }
-    QSlider::mousePressEvent(e);
-  }
-};
 } // namespace
 
 TimelineBar::TimelineBar(QWidget* parent)
@@ -62,14 +34,32 @@ void TimelineBar::buildUi() {
   layout->setSpacing(10);
   layout->setAlignment(Qt::AlignVCenter);
 
-  slider_ = new ClickSeekSlider(Qt::Horizontal, this);
-  slider_->setObjectName("TimelineSlider");
-  slider_->setRange(0, 0);
-  slider_->setSingleStep(50);
-  slider_->setPageStep(1000);
-  slider_->setTracking(false); // you already found this feels better
-  slider_->setMinimumHeight(40);
-  slider_->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+  viewport_ = new TimelineViewport(this);
+  viewport_->installEventFilter(this);
+
+  markerTrack_ = new TagMarkerTrack(this);
+  markerTrack_->installEventFilter(this);
+
+  waveform_ = new WaveformStrip(this);
+  waveform_->installEventFilter(this);
+
+  sceneStrip_ = new SceneStrip(this);
+  sceneStrip_->installEventFilter(this);
+
+  // Hover preview: a tooltip-style window so it can float above the video without reflowing layouts.
+  hoverPopup_ = new QWidget(this, Qt::ToolTip | Qt::FramelessWindowHint);
+  hoverPopup_->setAttribute(Qt::WA_TransparentForMouseEvents, true);
+  hoverPopup_->setAttribute(Qt::WA_ShowWithoutActivating, true);
+  hoverPopup_->setStyleSheet(QStringLiteral("background-color: rgba(0, 0, 0, 200); color: white;"));
+  auto* popupLayout = new QVBoxLayout(hoverPopup_);
+  popupLayout->setContentsMargins(3, 3, 3, 3);
+  popupLayout->setSpacing(2);
+  hoverImage_ = new QLabel(hoverPopup_);
+  hoverTime_ = new QLabel(hoverPopup_);
+  hoverTime_->setAlignment(Qt::AlignCenter);
+  popupLayout->addWidget(hoverImage_);
+  popupLayout->addWidget(hoverTime_);
+  hoverPopup_->hide();
 
   label_ = new QLabel("00:00 / 00:00", this);
   Style::setRole(label_, "muted");
@@ -86,36 +76,39 @@ void TimelineBar::buildUi() {
   timeEntry_->hide();
   timeEntry_->installEventFilter(this);
 
-  layout->addWidget(slider_, 1);
+  // Markers above and the waveform and scene strips below share the viewport's horizontal extent (and so its ms -> x mapping).
+  auto* trackColumn = new QVBoxLayout();
+  trackColumn->setContentsMargins(0, 0, 0, 0);
+  trackColumn->setSpacing(0);
+  trackColumn->addWidget(markerTrack_);
+  trackColumn->addWidget(viewport_);
+  trackColumn->addWidget(waveform_);
+  trackColumn->addWidget(sceneStrip_);
+
+  layout->addLayout(trackColumn, 1);
   layout->addWidget(label_);
   layout->addWidget(timeEntry_);
 }
 
 void TimelineBar::wireSignals() {
-  scrubThrottleTimer_.invalidate();
-
-  connect(slider_, &QSlider::sliderPressed, this, [this]() {
+  connect(viewport_, &TimelineViewport::scrubStarted, this, [this]() {
     isScrubbing_ = true;
     waitingForSeekCommit_ = false;
     pendingSeekMs_ = -1;
-    scrubThrottleTimer_.invalidate();
     emit scrubStarted();
   });
 
-  connect(slider_, &QSlider::sliderMoved, this, [this](int value) {
-    updateLabel(value, durationMs_);
+  connect(viewport_, &TimelineViewport::scrubSeekTo, this, [this](qint64 posMs) {
+    updateLabel(posMs, durationMs_);
+    markerTrack_->setPlayheadMs(posMs);
 
     if (!enableLiveScrubSeek_) return;
 
-    if (!scrubThrottleTimer_.isValid()) scrubThrottleTimer_.start();
-    if (scrubThrottleTimer_.elapsed() >= kScrubThrottleMs) {
-      emit scrubSeekTo(static_cast<qint64>(value));
-      scrubThrottleTimer_.restart();
-    }
+    // Every move is forwarded; VideoPlayer's SeekScheduler coalesces them (latest wins).
+    emit scrubSeekTo(posMs);
   });
 
-  connect(slider_, &QSlider::sliderReleased, this, [this]() {
-    const qint64 releasedPosMs = static_cast<qint64>(slider_->value());
+  connect(viewport_, &TimelineViewport::scrubFinished, this, [this](qint64 releasedPosMs) {
     waitingForSeekCommit_ = true;
     pendingSeekMs_ = releasedPosMs;
     isScrubbing_ = false;
@@ -123,6 +116,15 @@ void TimelineBar::wireSignals() {
     emit scrubFinished(releasedPosMs);
   });
 
+  connect(viewport_, &TimelineViewport::viewChanged, markerTrack_, &TagMarkerTrack::setViewRangeMs);
+  connect(viewport_, &TimelineViewport::viewChanged, waveform_, &WaveformStrip::setViewRangeMs);
+  connect(viewport_, &TimelineViewport::viewChanged, sceneStrip_, &SceneStrip::setViewRangeMs);
+
+  connect(markerTrack_, &TagMarkerTrack::markerClicked, this, [this](qint64 timeMs) {
+    if (!viewport_->isEnabled() || isEditingTimeEntry_) return;
+    emit markerSeekRequested(timeMs);
+  });
+
   connect(timeEntry_, &QLineEdit::returnPressed, this, [this]() {
     commitTimeEntry();
   });
@@ -130,13 +132,6 @@ void TimelineBar::wireSignals() {
   connect(timeEntry_, &QLineEdit::editingFinished, this, [this]() {
     commitTimeEntry();
   });
-
-  // If user clicks somewhere (not dragging), sliderMoved might not fire.
-  connect(slider_, &QSlider::valueChanged, this, [this](int v) {
-    if (isScrubbing_) return;
-    // Keep label in sync even for click-to-seek
-    updateLabel(v, durationMs_);
-  });
 }
 
 void TimelineBar::reset() {
@@ -146,26 +141,40 @@ void TimelineBar::reset() {
   isEditingTimeEntry_ = false;
   waitingForSeekCommit_ = false;
   pendingSeekMs_ = -1;
-  slider_->setRange(0, 0);
-  slider_->setValue(0);
-  slider_->setEnabled(false);
+  viewport_->setDurationMs(0);
+  viewport_->setPositionMs(0);
+  viewport_->setEnabled(false);
+  markerTrack_->setDurationMs(0);
+  markerTrack_->setPlayheadMs(0);
+  markerTrack_->setEnabled(false);
   if (timeEntry_) timeEntry_->hide();
   if (label_) label_->show();
+  hideHoverPreview();
   updateLabel(0, 0);
 }
 
 void TimelineBar::setEnabledForMedia(bool on) {
-  slider_->setEnabled(on && durationMs_ > 0);
-  if (!slider_->isEnabled() && isEditingTimeEntry_) {
+  viewport_->setEnabled(on && durationMs_ > 0);
+  markerTrack_->setEnabled(viewport_->isEnabled());
+  if (!viewport_->isEnabled() && isEditingTimeEntry_) {
     cancelTimeEntry();
   }
 }
 
 void TimelineBar::setDurationMs(qint64 durMs) {
   durationMs_ = std::max<qint64>(0, durMs);
-  slider_->setRange(0, static_cast<int>(durationMs_));
-  slider_->setEnabled(durationMs_ > 0);
-  updateLabel(slider_->value(), durationMs_);
+  viewport_->setDurationMs(durationMs_);
+  viewport_->setEnabled(durationMs_ > 0);
+  markerTrack_->setDurationMs(durationMs_);
+  markerTrack_->setViewRangeMs(viewport_->viewStartMs(), viewport_->viewSpanMs());
+  waveform_->setViewRangeMs(viewport_->viewStartMs(), viewport_->viewSpanMs());
+  sceneStrip_->setViewRangeMs(viewport_->viewStartMs(), viewport_->viewSpanMs());
+  markerTrack_->setEnabled(viewport_->isEnabled());
+  updateLabel(viewport_->positionMs(), durationMs_);
+}
+
+void TimelineBar::setFrameDurationMs(qint64 frameMs) {
+  viewport_->setFrameDurationMs(frameMs);
 }
 
 void TimelineBar::setPositionMs(qint64 posMs) {
@@ -180,19 +189,84 @@ void TimelineBar::setPositionMs(qint64 posMs) {
     }
   }
   if (!isScrubbing_) {
-    slider_->setValue(static_cast<int>(posMs));
+    viewport_->setPositionMs(posMs);
+    markerTrack_->setPlayheadMs(posMs);
   }
   lastKnownPositionMs_ = posMs;
   updateLabel(posMs, durationMs_);
 }
 
+void TimelineBar::setTagMarkers(QVector<TagMarkerTrack::Marker> markers) {
+  markerTrack_->setMarkers(std::move(markers));
+}
+
+void TimelineBar::updateTagMarkers(const QVector<quint64>& removedKeys,
+                                   const QVector<TagMarkerTrack::Marker>& upserts) {
+  markerTrack_->updateMarkers(removedKeys, upserts);
+}
+
+void TimelineBar::setSuggestionMarkers(QVector<TagMarkerTrack::Marker> suggestions) {
+  markerTrack_->setSuggestions(std::move(suggestions));
+}
+
+void TimelineBar::setThumbnailSource(ThumbnailSprites* sprites) {
+  if (thumbnails_) disconnect(thumbnails_, nullptr, this, nullptr);
+  thumbnails_ = sprites;
+  if (!thumbnails_) return;
+  connect(thumbnails_, &ThumbnailSprites::thumbnailReady, this, [this]() {
+    if (hoverPopup_ && hoverPopup_->isVisible()) showHoverPreview(hoverPos_);
+  });
+}
+
+void TimelineBar::setAudioPeaks(AudioPeaksBuilder* peaks) {
+  waveform_->setPeakSource(peaks);
+}
+
+void TimelineBar::setSceneAnalysis(SceneAnalyzer* analyzer) {
+  sceneStrip_->setAnalysisSource(analyzer);
+}
+
 void TimelineBar::updateLabel(qint64 posMs, qint64 durMs) {
   if (!isEditingTimeEntry_) {
     label_->setText(QString("%1 / %2").arg(formatMs(posMs), formatMs(durMs)));
   }
 }
 
+void TimelineBar::showHoverPreview(const QPoint& viewportPos) {
+  if (!hoverPopup_ || durationMs_ <= 0 || !viewport_->isEnabled()) return;
+  hoverPos_ = viewportPos;
+  const qint64 hoverMs = viewport_->msAtPoint(viewportPos);
+
+  const QImage thumb = thumbnails_ ? thumbnails_->thumbnailAt(hoverMs) : QImage();
+  hoverImage_->setVisible(!thumb.isNull());
+  if (!thumb.isNull()) hoverImage_->setPixmap(QPixmap::fromImage(thumb));
+  hoverTime_->setText(formatMs(hoverMs));
+  hoverPopup_->adjustSize();
+
+  const QPoint anchor = markerTrack_->mapToGlobal(QPoint(viewportPos.x(), 0));
+  hoverPopup_->move(anchor.x() - hoverPopup_->width() / 2, anchor.y() - hoverPopup_->height() - 6);
+  hoverPopup_->show();
+}
+
+void TimelineBar::hideHoverPreview() {
+  if (hoverPopup_) hoverPopup_->hide();
+}
+
 bool TimelineBar::eventFilter(QObject* watched, QEvent* event) {
+  if ((watched == markerTrack_ || watched == waveform_ || watched == sceneStrip_) && event && event->type() == QEvent::Wheel) {
+    // Zooming over the markers, waveform or scene strip behaves like zooming over the track (same x mapping).
+    QCoreApplication::sendEvent(viewport_, event);
+    return true;
+  }
+
+  if (watched == viewport_ && event) {
+    if (event->type() == QEvent::MouseMove) {
+      showHoverPreview(static_cast<QMouseEvent*>(event)->position().toPoint());
+    } else if (event->type() == QEvent::Leave || event->type() == QEvent::Hide) {
+      hideHoverPreview();
+    }
+  }
+
   if (watched == label_ && event && event->type() == QEvent::MouseButtonPress) {
     auto* mouse = static_cast<QMouseEvent*>(event);
     if (mouse->button() == Qt::LeftButton) {
@@ -213,15 +287,15 @@ bool TimelineBar::eventFilter(QObject* watched, QEvent* event) {
 }
 
 void TimelineBar::beginTimeEntry() {
-  if (!slider_ || !timeEntry_ || !label_) return;
-  if (!slider_->isEnabled() || durationMs_ <= 0 || isEditingTimeEntry_) return;
+  if (!viewport_ || !timeEntry_ || !label_) return;
+  if (!viewport_->isEnabled() || durationMs_ <= 0 || isEditingTimeEntry_) return;
 
   emit timeEntryStarted();
   isEditingTimeEntry_ = true;
   waitingForSeekCommit_ = false;
   pendingSeekMs_ = -1;
 
-  const qint64 currentMs = static_cast<qint64>(slider_->value());
+  const qint64 currentMs = viewport_->positionMs();
   timeEntry_->setText(formatMs(currentMs));
   label_->hide();
   timeEntry_->show();
@@ -230,7 +304,7 @@ void TimelineBar::beginTimeEntry() {
 }
 
 void TimelineBar::commitTimeEntry() {
-  if (!isEditingTimeEntry_ || !timeEntry_ || !label_ || !slider_) return;
+  if (!isEditingTimeEntry_ || !timeEntry_ || !label_ || !viewport_) return;
 
   qint64 targetMs = -1;
   if (!parseTimeEntryMs(timeEntry_->text(), &targetMs)) {
@@ -243,7 +317,8 @@ void TimelineBar::commitTimeEntry() {
   pendingSeekMs_ = targetMs;
   isEditingTimeEntry_ = false;
 
-  slider_->setValue(static_cast<int>(targetMs));
+  viewport_->setPositionMs(targetMs);
+  markerTrack_->setPlayheadMs(targetMs);
   lastKnownPositionMs_ = targetMs;
   label_->show();
   timeEntry_->hide();
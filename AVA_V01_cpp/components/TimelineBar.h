@@ -1,29 +1,43 @@
 #pragma once
 
-#include <QElapsedTimer>
+#include "TagMarkerTrack.h"
+
 #include <QWidget>
 #include <QtGlobal>
 
 class QLabel;
-class QSlider;
 class QLineEdit;
 class QEvent;
+class ThumbnailSprites;
+class TimelineViewport;
+class WaveformStrip;
+class SceneStrip;
+class AudioPeaksBuilder;
+class SceneAnalyzer;
 
 class TimelineBar final : public QWidget {
   Q_OBJECT
 public:
   explicit TimelineBar(QWidget* parent = nullptr);
 
-  void reset();                       // 00:00 / 00:00, disabled slider
+  void reset();                       // 00:00 / 00:00, disabled viewport
   void setEnabledForMedia(bool on);   // main enable toggle
   void setDurationMs(qint64 durMs);
   void setPositionMs(qint64 posMs);
+  void setFrameDurationMs(qint64 frameMs);  // sets the deepest zoom level
+  void setThumbnailSource(ThumbnailSprites* sprites);
+  void setTagMarkers(QVector<TagMarkerTrack::Marker> markers);
+  void updateTagMarkers(const QVector<quint64>& removedKeys, const QVector<TagMarkerTrack::Marker>& upserts);
+  void setSuggestionMarkers(QVector<TagMarkerTrack::Marker> suggestions);
+  void setAudioPeaks(AudioPeaksBuilder* peaks);
+  void setSceneAnalysis(SceneAnalyzer* analyzer);
 
 signals:
-  void scrubStarted();                // user grabbed the handle
-  void scrubSeekTo(qint64 posMs);     // optional throttled live seeking
+  void scrubStarted();                // user pressed on the track
+  void scrubSeekTo(qint64 posMs);     // live seeking on every move (consumer coalesces)
   void scrubFinished(qint64 posMs);   // definitive seek on release/click
   void timeEntryStarted();            // user clicked timestamp entry and requested pause
+  void markerSeekRequested(qint64 posMs); // user clicked a tag marker
 
 private:
   bool eventFilter(QObject* watched, QEvent* event) override;
@@ -33,13 +47,24 @@ private:
   void commitTimeEntry();
   void cancelTimeEntry();
   void updateLabel(qint64 posMs, qint64 durMs);
+  void showHoverPreview(const QPoint& viewportPos);
+  void hideHoverPreview();
   static bool parseTimeEntryMs(const QString& text, qint64* outMs);
   static QString formatMs(qint64 ms);
 
-  QSlider* slider_ = nullptr;
+  TimelineViewport* viewport_ = nullptr;
+  TagMarkerTrack* markerTrack_ = nullptr;
+  WaveformStrip* waveform_ = nullptr;
+  SceneStrip* sceneStrip_ = nullptr;
   QLabel* label_ = nullptr;
   QLineEdit* timeEntry_ = nullptr;
 
+  ThumbnailSprites* thumbnails_ = nullptr;
+  QWidget* hoverPopup_ = nullptr;     // floating thumbnail + time above the timeline
+  QLabel* hoverImage_ = nullptr;
+  QLabel* hoverTime_ = nullptr;
+  QPoint hoverPos_;                   // viewport position the popup shows; refreshed when a sheet decodes
+
   qint64 durationMs_ = 0;
   qint64 lastKnownPositionMs_ = 0;
   bool isScrubbing_ = false;
@@ -47,5 +72,4 @@ private:
   bool enableLiveScrubSeek_ = true;   // you can tweak this later
   qint64 pendingSeekMs_ = -1;
   bool waitingForSeekCommit_ = false;
-  QElapsedTimer scrubThrottleTimer_;
 };
@@ -0,0 +1,392 @@
+#include "TimelineViewport.h"
+
+#include <QEvent>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QPaintEvent>
+#include <QResizeEvent>
+#include <QWheelEvent>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+constexpr int kHeight = 40;
+constexpr int kRulerHeight = 12;
+constexpr int kGrooveCenterY = 20;
+constexpr int kGrooveHeight = 6;
+constexpr int kHandleDiameter = 14;
+constexpr int kMinimapHeight = 6;
+constexpr int kMinPxPerFrame = 12;      // deepest zoom: one frame spans this many pixels
+constexpr int kMinMinorTickPx = 6;
+constexpr int kMinMajorTickPx = 80;
+constexpr double kWheelZoomStep = 0.8;  // span factor per wheel notch (in)
+
+// Same palette as the former QSlider#TimelineSlider stylesheet.
+const QColor kGrooveColor(0xe4, 0xe4, 0xe7);
+const QColor kPlayedColor(0x18, 0x18, 0x1b);
+const QColor kHandleColor(0xff, 0xff, 0xff);
+const QColor kTickColor(0xa1, 0xa1, 0xaa);
+const QColor kLabelColor(0x71, 0x71, 0x7a);
+const QColor kMinimapColor(0xf4, 0xf4, 0xf5);
+const QColor kMinimapWindowColor(0xa1, 0xa1, 0xaa, 150);
+
+QString formatTickLabel(qint64 ms, bool withMillis, bool withHours) {
+  const qint64 totalSeconds = ms / 1000;
+  const qint64 hours = totalSeconds / 3600;
+  const qint64 minutes = withHours ? (totalSeconds / 60) % 60 : totalSeconds / 60;
+  const qint64 seconds = totalSeconds % 60;
+  QString text = withHours
+    ? QStringLiteral("%1:%2:%3").arg(hours).arg(minutes, 2, 10, QChar('0')).arg(seconds, 2, 10, QChar('0'))
+    : QStringLiteral("%1:%2").arg(minutes, 2, 10, QChar('0')).arg(seconds, 2, 10, QChar('0'));
+  if (withMillis) text += QStringLiteral(".%1").arg(ms % 1000, 3, 10, QChar('0'));
+  return text;
+}
+} // namespace
+
+TimelineViewport::TimelineViewport(QWidget* parent)
+  : QWidget(parent) {
+  setObjectName("TimelineViewport");
+  setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+  setFixedHeight(kHeight);
+  setMouseTracking(true);
+}
+
+QSize TimelineViewport::sizeHint() const {
+  return QSize(400, kHeight);
+}
+
+void TimelineViewport::setDurationMs(qint64 durMs) {
+  durationMs_ = std::max<qint64>(0, durMs);
+  positionMs_ = std::min(positionMs_, durationMs_);
+  viewStartMs_ = 0;
+  viewSpanMs_ = durationMs_;
+  invalidateCache();
+  emit viewChanged(viewStartMs_, viewSpanMs_);
+}
+
+void TimelineViewport::setFrameDurationMs(qint64 frameMs) {
+  frameMs_ = std::max<qint64>(1, frameMs);
+  setView(viewStartMs_, viewSpanMs_);  // re-clamp the zoom floor
+}
+
+void TimelineViewport::setPositionMs(qint64 posMs) {
+  posMs = std::clamp<qint64>(posMs, 0, durationMs_);
+  if (posMs == positionMs_) return;
+  const qint64 previousMs = positionMs_;
+  positionMs_ = posMs;
+
+  // Playback follows the playhead page by page, but only if it was on screen (a user who panned away stays put).
+  const qint64 viewEndMs = viewStartMs_ + viewSpanMs_;
+  const bool wasVisible = previousMs >= viewStartMs_ && previousMs <= viewEndMs;
+  if (drag_ == DragMode::None && viewSpanMs_ < durationMs_ && wasVisible &&
+      (posMs < viewStartMs_ || posMs > viewEndMs)) {
+    setView(posMs - viewSpanMs_ / 10, viewSpanMs_);
+    return;
+  }
+
+  update(playheadDirtyRect(previousMs, posMs));
+  const QRect mm = minimapRect();
+  update(QRect(minimapXForMs(previousMs) - 1, mm.top(), 3, mm.height()));
+  update(QRect(minimapXForMs(posMs) - 1, mm.top(), 3, mm.height()));
+}
+
+void TimelineViewport::fitAll() {
+  setView(0, durationMs_);
+}
+
+qint64 TimelineViewport::msAtPoint(const QPoint& p) const {
+  return inMinimap(p) ? minimapMsForX(p.x()) : msForX(p.x());
+}
+
+void TimelineViewport::setView(qint64 startMs, qint64 spanMs) {
+  if (durationMs_ <= 0) {
+    startMs = 0;
+    spanMs = 0;
+  } else {
+    spanMs = std::clamp<qint64>(spanMs, std::min(minSpanMs(), durationMs_), durationMs_);
+    startMs = std::clamp<qint64>(startMs, 0, durationMs_ - spanMs);
+  }
+  if (startMs == viewStartMs_ && spanMs == viewSpanMs_) return;
+  viewStartMs_ = startMs;
+  viewSpanMs_ = spanMs;
+  invalidateCache();
+  emit viewChanged(viewStartMs_, viewSpanMs_);
+}
+
+void TimelineViewport::zoomAround(int x, double factor) {
+  if (durationMs_ <= 0 || width() <= 1) return;
+  const qint64 anchorMs = msForX(x);
+  const qint64 newSpan = std::max<qint64>(1, static_cast<qint64>(std::llround(viewSpanMs_ * factor)));
+  const double anchorFraction = static_cast<double>(std::clamp(x, 0, width() - 1)) / (width() - 1);
+  setView(anchorMs - static_cast<qint64>(anchorFraction * newSpan), newSpan);
+}
+
+void TimelineViewport::centerViewOn(qint64 ms) {
+  setView(ms - viewSpanMs_ / 2, viewSpanMs_);
+}
+
+qint64 TimelineViewport::minSpanMs() const {
+  return std::max<qint64>(1, (static_cast<qint64>(std::max(1, width() - 1)) * frameMs_) / kMinPxPerFrame);
+}
+
+int TimelineViewport::xForMs(qint64 ms) const {
+  if (viewSpanMs_ <= 0 || width() <= 1) return 0;
+  const double x = static_cast<double>(ms - viewStartMs_) * (width() - 1) / viewSpanMs_;
+  return static_cast<int>(std::floor(std::clamp(x, -1.0e6, 1.0e6)));
+}
+
+qint64 TimelineViewport::msForX(int x) const {
+  if (viewSpanMs_ <= 0 || width() <= 1) return 0;
+  const qint64 ms = viewStartMs_ + (static_cast<qint64>(x) * viewSpanMs_) / (width() - 1);
+  return std::clamp<qint64>(ms, 0, durationMs_);
+}
+
+int TimelineViewport::minimapXForMs(qint64 ms) const {
+  if (durationMs_ <= 0 || width() <= 1) return 0;
+  return static_cast<int>((std::clamp<qint64>(ms, 0, durationMs_) * (width() - 1)) / durationMs_);
+}
+
+qint64 TimelineViewport::minimapMsForX(int x) const {
+  if (durationMs_ <= 0 || width() <= 1) return 0;
+  return (static_cast<qint64>(std::clamp(x, 0, width() - 1)) * durationMs_) / (width() - 1);
+}
+
+QRect TimelineViewport::minimapRect() const {
+  return QRect(0, height() - kMinimapHeight - 1, width(), kMinimapHeight);
+}
+
+bool TimelineViewport::inMinimap(const QPoint& p) const {
+  return p.y() >= minimapRect().top() - 1;
+}
+
+QRect TimelineViewport::playheadDirtyRect(qint64 fromMs, qint64 toMs) const {
+  // Covers the played-fill change between both positions plus the handle at each end.
+  const int x1 = xForMs(std::min(fromMs, toMs));
+  const int x2 = xForMs(std::max(fromMs, toMs));
+  const int r = kHandleDiameter / 2 + 2;
+  const int top = kGrooveCenterY - r;
+  return QRect(QPoint(x1 - r, top), QPoint(x2 + r, kGrooveCenterY + r)).intersected(rect());
+}
+
+void TimelineViewport::invalidateCache() {
+  cacheValid_ = false;
+  update();
+}
+
+void TimelineViewport::renderCache() {
+  const qreal dpr = devicePixelRatioF();
+  cache_ = QPixmap(size() * dpr);
+  cache_.setDevicePixelRatio(dpr);
+  cache_.fill(Qt::transparent);
+  cacheValid_ = true;
+
+  QPainter p(&cache_);
+  p.setRenderHint(QPainter::Antialiasing, true);
+
+  // Groove
+  const QRectF groove(0, kGrooveCenterY - kGrooveHeight / 2.0, width(), kGrooveHeight);
+  p.setPen(Qt::NoPen);
+  p.setBrush(kGrooveColor);
+  p.drawRoundedRect(groove, kGrooveHeight / 2.0, kGrooveHeight / 2.0);
+
+  // Minimap: whole game with the visible window
+  const QRect mm = minimapRect();
+  p.setBrush(kMinimapColor);
+  p.drawRoundedRect(mm, 2, 2);
+  if (durationMs_ > 0) {
+    const int wx1 = minimapXForMs(viewStartMs_);
+    const int wx2 = std::max(wx1 + 3, minimapXForMs(viewStartMs_ + viewSpanMs_));
+    p.setBrush(kMinimapWindowColor);
+    p.drawRoundedRect(QRect(QPoint(wx1, mm.top()), QPoint(wx2, mm.bottom())), 2, 2);
+  }
+
+  if (viewSpanMs_ <= 0 || width() <= 1) return;
+
+  // Ruler: pick minor/major steps from a ladder so ticks keep a readable spacing at any zoom.
+  std::vector<qint64> ladder = {frameMs_, frameMs_ * 5, 500, 1000, 2000, 5000, 10000, 15000, 30000,
+                                60000, 120000, 300000, 600000, 900000, 1800000, 3600000};
+  std::sort(ladder.begin(), ladder.end());
+  ladder.erase(std::unique(ladder.begin(), ladder.end()), ladder.end());
+  const double pxPerMs = static_cast<double>(width() - 1) / viewSpanMs_;
+  auto firstStepWithSpacing = [&](int minPx) {
+    for (qint64 step : ladder) {
+      if (step * pxPerMs >= minPx) return step;
+    }
+    return ladder.back();
+  };
+  const qint64 minorStep = firstStepWithSpacing(kMinMinorTickPx);
+  const qint64 majorStep = std::max(minorStep, firstStepWithSpacing(kMinMajorTickPx));
+  const bool withMillis = majorStep < 1000;
+  const bool withHours = durationMs_ >= 3600000;
+
+  p.setRenderHint(QPainter::Antialiasing, false);
+  const qint64 viewEndMs = viewStartMs_ + viewSpanMs_;
+  p.setPen(kTickColor);
+  for (qint64 t = (viewStartMs_ / minorStep) * minorStep; t <= viewEndMs; t += minorStep) {
+    if (t < viewStartMs_ || t % majorStep == 0) continue;
+    const int x = xForMs(t);
+    p.drawLine(x, kRulerHeight - 3, x, kRulerHeight - 1);
+  }
+
+  QFont labelFont = font();
+  labelFont.setPixelSize(9);
+  p.setFont(labelFont);
+  for (qint64 t = (viewStartMs_ / majorStep) * majorStep; t <= viewEndMs; t += majorStep) {
+    if (t < viewStartMs_) continue;
+    const int x = xForMs(t);
+    p.setPen(kTickColor);
+    p.drawLine(x, 1, x, kRulerHeight - 1);
+    p.setPen(kLabelColor);
+    p.drawText(QRect(x + 3, 0, kMinMajorTickPx, kRulerHeight), Qt::AlignLeft | Qt::AlignVCenter,
+               formatTickLabel(t, withMillis, withHours));
+  }
+}
+
+void TimelineViewport::paintEvent(QPaintEvent* event) {
+  if (!cacheValid_ || cache_.size() != size() * devicePixelRatioF()) renderCache();
+
+  QPainter p(this);
+  if (!isEnabled()) p.setOpacity(0.5);
+  const QRect dirty = event->rect();
+  const qreal dpr = cache_.devicePixelRatio();
+  p.drawPixmap(dirty, cache_, QRectF(dirty.topLeft() * dpr, dirty.size() * dpr));
+
+  if (durationMs_ <= 0 || viewSpanMs_ <= 0) return;
+
+  p.setRenderHint(QPainter::Antialiasing, true);
+  p.setPen(Qt::NoPen);
+
+  // Played portion of the groove (from the left edge of the view to the playhead)
+  const int playheadX = xForMs(positionMs_);
+  const int playedRight = std::min(playheadX, width());
+  if (playedRight > 0) {
+    p.setBrush(kPlayedColor);
+    p.drawRoundedRect(QRectF(0, kGrooveCenterY - kGrooveHeight / 2.0, playedRight, kGrooveHeight),
+                      kGrooveHeight / 2.0, kGrooveHeight / 2.0);
+  }
+
+  // Handle
+  if (playheadX >= -kHandleDiameter && playheadX <= width() + kHandleDiameter) {
+    p.setBrush(kHandleColor);
+    p.setPen(QPen(kPlayedColor, 2));
+    p.drawEllipse(QPointF(playheadX, kGrooveCenterY), kHandleDiameter / 2.0 - 1, kHandleDiameter / 2.0 - 1);
+  }
+
+  // Playhead in the minimap
+  const QRect mm = minimapRect();
+  p.setRenderHint(QPainter::Antialiasing, false);
+  p.fillRect(QRect(minimapXForMs(positionMs_), mm.top(), 1, mm.height()), kPlayedColor);
+}
+
+void TimelineViewport::resizeEvent(QResizeEvent* event) {
+  QWidget::resizeEvent(event);
+  cacheValid_ = false;
+  setView(viewStartMs_, viewSpanMs_);  // the zoom floor depends on width
+}
+
+void TimelineViewport::changeEvent(QEvent* event) {
+  QWidget::changeEvent(event);
+  if (event->type() == QEvent::EnabledChange) update();
+}
+
+void TimelineViewport::mousePressEvent(QMouseEvent* event) {
+  if (durationMs_ <= 0 || drag_ != DragMode::None) {
+    QWidget::mousePressEvent(event);
+    return;
+  }
+  const QPoint pos = event->position().toPoint();
+
+  if (event->button() == Qt::LeftButton && inMinimap(pos)) {
+    drag_ = DragMode::Minimap;
+    centerViewOn(minimapMsForX(pos.x()));
+  } else if (event->button() == Qt::LeftButton) {
+    drag_ = DragMode::Scrub;
+    scrubMs_ = msForX(pos.x());
+    emit scrubStarted();
+    setPositionMs(scrubMs_);
+    emit scrubSeekTo(scrubMs_);
+  } else if (event->button() == Qt::MiddleButton || event->button() == Qt::RightButton) {
+    drag_ = DragMode::Pan;
+    dragOriginX_ = pos.x();
+    dragOriginStartMs_ = viewStartMs_;
+    setCursor(Qt::ClosedHandCursor);
+  } else {
+    QWidget::mousePressEvent(event);
+    return;
+  }
+  dragButton_ = event->button();
+  event->accept();
+}
+
+void TimelineViewport::mouseMoveEvent(QMouseEvent* event) {
+  const QPoint pos = event->position().toPoint();
+  switch (drag_) {
+  case DragMode::Scrub: {
+    // Dragging past either edge while zoomed pushes the view along.
+    if (pos.x() < 0 || pos.x() > width() - 1) {
+      const int overflowPx = pos.x() < 0 ? pos.x() : pos.x() - (width() - 1);
+      setView(viewStartMs_ + (static_cast<qint64>(overflowPx) * viewSpanMs_) / std::max(1, width() - 1),
+              viewSpanMs_);
+    }
+    const qint64 ms = msForX(pos.x());
+    if (ms != scrubMs_) {
+      scrubMs_ = ms;
+      setPositionMs(scrubMs_);
+      emit scrubSeekTo(scrubMs_);
+    }
+    break;
+  }
+  case DragMode::Pan: {
+    const qint64 deltaMs = (static_cast<qint64>(pos.x() - dragOriginX_) * viewSpanMs_) / std::max(1, width() - 1);
+    setView(dragOriginStartMs_ - deltaMs, viewSpanMs_);
+    break;
+  }
+  case DragMode::Minimap:
+    centerViewOn(minimapMsForX(pos.x()));
+    break;
+  case DragMode::None:
+    QWidget::mouseMoveEvent(event);
+    return;
+  }
+  event->accept();
+}
+
+void TimelineViewport::mouseReleaseEvent(QMouseEvent* event) {
+  if (drag_ == DragMode::None || event->button() != dragButton_) {
+    QWidget::mouseReleaseEvent(event);
+    return;
+  }
+  const DragMode finished = drag_;
+  drag_ = DragMode::None;
+  dragButton_ = Qt::NoButton;
+  if (finished == DragMode::Pan) unsetCursor();
+  if (finished == DragMode::Scrub) emit scrubFinished(scrubMs_);
+  event->accept();
+}
+
+void TimelineViewport::mouseDoubleClickEvent(QMouseEvent* event) {
+  if (event->button() == Qt::LeftButton && inMinimap(event->position().toPoint())) {
+    fitAll();
+    event->accept();
+    return;
+  }
+  mousePressEvent(event);
+}
+
+void TimelineViewport::wheelEvent(QWheelEvent* event) {
+  if (durationMs_ <= 0) {
+    QWidget::wheelEvent(event);
+    return;
+  }
+  const QPoint delta = event->angleDelta();
+  const bool pan = (event->modifiers() & Qt::ShiftModifier) || std::abs(delta.x()) > std::abs(delta.y());
+  if (pan) {
+    const int notches = delta.x() != 0 ? delta.x() : delta.y();
+    setView(viewStartMs_ - static_cast<qint64>(notches / 120.0 * viewSpanMs_ / 8), viewSpanMs_);
+  } else if (delta.y() != 0) {
+    zoomAround(static_cast<int>(event->position().x()), std::pow(kWheelZoomStep, delta.y() / 120.0));
+  }
+  event->accept();
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <QPixmap>
+#include <QWidget>
+#include <QtGlobal>
+
+// Custom-painted, zoomable timeline track that replaces the plain slider.
+// Wheel zooms around the cursor (Shift+wheel or horizontal wheel pans), middle/right drag pans, and a
+// minimap strip along the bottom shows the visible window over the whole game (click or drag it to move
+// the window, double-click to fit the whole game). Zoom goes down to a few pixels per frame.
+// The ruler, groove and minimap are cached per view; a position update only repaints the strip between
+// the old and new playhead, so paint cost does not depend on the zoom level.
+class TimelineViewport final : public QWidget {
+  Q_OBJECT
+public:
+  explicit TimelineViewport(QWidget* parent = nullptr);
+
+  void setDurationMs(qint64 durMs);     // also fits the view to the whole game
+  void setFrameDurationMs(qint64 frameMs);
+  void setPositionMs(qint64 posMs);
+  qint64 positionMs() const { return positionMs_; }
+
+  void fitAll();
+  qint64 viewStartMs() const { return viewStartMs_; }
+  qint64 viewSpanMs() const { return viewSpanMs_; }
+
+  /// Time under a point of this widget (the minimap maps to the whole game).
+  qint64 msAtPoint(const QPoint& p) const;
+
+  QSize sizeHint() const override;
+
+signals:
+  void scrubStarted();
+  void scrubSeekTo(qint64 posMs);
+  void scrubFinished(qint64 posMs);
+  void viewChanged(qint64 startMs, qint64 spanMs);
+
+protected:
+  void paintEvent(QPaintEvent* event) override;
+  void resizeEvent(QResizeEvent* event) override;
+  void mousePressEvent(QMouseEvent* event) override;
+  void mouseMoveEvent(QMouseEvent* event) override;
+  void mouseReleaseEvent(QMouseEvent* event) override;
+  void mouseDoubleClickEvent(QMouseEvent* event) override;
+  void wheelEvent(QWheelEvent* event) override;
+  void changeEvent(QEvent* event) override;
+
+private:
+  enum class DragMode { None, Scrub, Pan, Minimap };
+
+  void setView(qint64 startMs, qint64 spanMs);
+  void zoomAround(int x, double factor);
+  void centerViewOn(qint64 ms);
+  qint64 minSpanMs() const;
+  int xForMs(qint64 ms) const;
+  qint64 msForX(int x) const;
+  int minimapXForMs(qint64 ms) const;
+  qint64 minimapMsForX(int x) const;
+  QRect minimapRect() const;
+  bool inMinimap(const QPoint& p) const;
+  QRect playheadDirtyRect(qint64 fromMs, qint64 toMs) const;
+  void invalidateCache();
+  void renderCache();
+
+  qint64 durationMs_ = 0;
+  qint64 frameMs_ = 40;
+  qint64 positionMs_ = 0;
+  qint64 viewStartMs_ = 0;
+  qint64 viewSpanMs_ = 0;
+
+  DragMode drag_ = DragMode::None;
+  Qt::MouseButton dragButton_ = Qt::NoButton;
+  int dragOriginX_ = 0;
+  qint64 dragOriginStartMs_ = 0;
+  qint64 scrubMs_ = 0;
+
+  QPixmap cache_;                       // ruler + groove + minimap window
+  bool cacheValid_ = false;
+};
@@ -184,6 +184,55 @@ void VideoControlsBar::buildKeyboardShortcuts() {
   connect(resetSpeedAction_, &QAction::triggered, this, &VideoControlsBar::resetSpeedRequested);
   addAction(resetSpeedAction_);
 
+  // J / K / L shuttle (same media + focus gates, so typing in notes never shuttles)
+  shuttleReverseAction_ = new QAction(this);
+  shuttleReverseAction_->setShortcut(QKeySequence(Qt::Key_J));
+  shuttleReverseAction_->setShortcutContext(Qt::ApplicationShortcut);
+  connect(shuttleReverseAction_, &QAction::triggered, this, [this]() { emit shuttleStepRequested(-1); });
+  addAction(shuttleReverseAction_);
+
+  shuttleStopAction_ = new QAction(this);
+  shuttleStopAction_->setShortcut(QKeySequence(Qt::Key_K));
+  shuttleStopAction_->setShortcutContext(Qt::ApplicationShortcut);
+  connect(shuttleStopAction_, &QAction::triggered, this, &VideoControlsBar::flashPauseButton);
+  connect(shuttleStopAction_, &QAction::triggered, this, &VideoControlsBar::shuttleStopRequested);
+  addAction(shuttleStopAction_);
+
+  shuttleForwardAction_ = new QAction(this);
+  shuttleForwardAction_->setShortcut(QKeySequence(Qt::Key_L));
+  shuttleForwardAction_->setShortcutContext(Qt::ApplicationShortcut);
+  connect(shuttleForwardAction_, &QAction::triggered, this, [this]() { emit shuttleStepRequested(+1); });
+  addAction(shuttleForwardAction_);
+
+  // I / O: A-B loop points, Shift+I / Shift+O: clear loop, P: instant replay of the last tag
+  loopInAction_ = new QAction(this);
+  loopInAction_->setShortcut(QKeySequence(Qt::Key_I));
+  loopInAction_->setShortcutContext(Qt::ApplicationShortcut);
+  connect(loopInAction_, &QAction::triggered, this, &VideoControlsBar::loopInRequested);
+  addAction(loopInAction_);
+
+  loopOutAction_ = new QAction(this);
+  loopOutAction_->setShortcut(QKeySequence(Qt::Key_O));
+  loopOutAction_->setShortcutContext(Qt::ApplicationShortcut);
+  connect(loopOutAction_, &QAction::triggered, this, &VideoControlsBar::loopOutRequested);
+  addAction(loopOutAction_);
+
+  loopClearAction_ = new QAction(this);
+  loopClearAction_->setShortcuts({
+      QKeySequence(Qt::SHIFT | Qt::Key_I),
+      QKeySequence(Qt::SHIFT | Qt::Key_O),
+  });
+  loopClearAction_->setShortcutContext(Qt::ApplicationShortcut);
+  connect(loopClearAction_, &QAction::triggered, this, &VideoControlsBar::loopClearRequested);
+  addAction(loopClearAction_);
+
+  instantReplayAction_ = new QAction(this);
+  instantReplayAction_->setShortcut(QKeySequence(Qt::Key_P));
+  instantReplayAction_->setShortcutContext(Qt::ApplicationShortcut);
+  connect(instantReplayAction_, &QAction::triggered, this, &VideoControlsBar::flashPlayButton);
+  connect(instantReplayAction_, &QAction::triggered, this, &VideoControlsBar::instantReplayRequested);
+  addAction(instantReplayAction_);
+
   updatePlaybackShortcutEnablement();
 }
 
@@ -211,6 +260,27 @@ void VideoControlsBar::updatePlaybackShortcutEnablement() {
   if (resetSpeedAction_) {
     resetSpeedAction_->setEnabled(shortcutsActive);
   }
+  if (shuttleReverseAction_) {
+    shuttleReverseAction_->setEnabled(shortcutsActive);
+  }
+  if (shuttleStopAction_) {
+    shuttleStopAction_->setEnabled(shortcutsActive);
+  }
+  if (shuttleForwardAction_) {
+    shuttleForwardAction_->setEnabled(shortcutsActive);
+  }
+  if (loopInAction_) {
+    loopInAction_->setEnabled(shortcutsActive);
+  }
+  if (loopOutAction_) {
+    loopOutAction_->setEnabled(shortcutsActive);
+  }
+  if (loopClearAction_) {
+    loopClearAction_->setEnabled(shortcutsActive);
+  }
+  if (instantReplayAction_) {
+    instantReplayAction_->setEnabled(shortcutsActive);
+  }
 }
 
 void VideoControlsBar::setEnabledForMedia(bool enabled) {
@@ -48,6 +48,16 @@ signals:
 
   void togglePlayPauseFromKeyboardShortcut();
 
+  // J / K / L shuttle keys (shuttleStep: -1 = J, +1 = L; K stops)
+  void shuttleStepRequested(int direction);
+  void shuttleStopRequested();
+
+  // I / O set the loop points at the playhead, Shift+I or Shift+O clears the loop; P replays the last tag
+  void loopInRequested();
+  void loopOutRequested();
+  void loopClearRequested();
+  void instantReplayRequested();
+
 private:
   void buildUi();
   void wireSignals();
@@ -72,6 +82,13 @@ private:
   QAction* slowerPlaybackAction_ = nullptr;
   QAction* fasterPlaybackAction_ = nullptr;
   QAction* resetSpeedAction_ = nullptr;
+  QAction* shuttleReverseAction_ = nullptr;
+  QAction* shuttleStopAction_ = nullptr;
+  QAction* shuttleForwardAction_ = nullptr;
+  QAction* loopInAction_ = nullptr;
+  QAction* loopOutAction_ = nullptr;
+  QAction* loopClearAction_ = nullptr;
+  QAction* instantReplayAction_ = nullptr;
 
   bool playbackShortcutMediaGate_ = false;
   bool playbackShortcutFocusGate_ = false;
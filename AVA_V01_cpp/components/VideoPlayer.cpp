@@ -1,6 +1,15 @@
 #include "VideoPlayer.h"
 #include "VideoControlsBar.h"
 #include "TimelineBar.h"
+#include "MediaIndex.h"
+#include "SeekScheduler.h"
+#include "ProxyGenerator.h"
+#include "PlaybackTelemetry.h"
+#include "ShuttleController.h"
+#include "FrameCopier.h"
+#include "ThumbnailSprites.h"
+#include "AudioPeaks.h"
+#include "SceneAnalysis.h"
 
 #ifdef Q_OS_MACOS
 #include "../macos/PlaybackActivity.h"
@@ -14,15 +23,19 @@ static void avaEndPlaybackUserActivity() {}
 #include <QAudioOutput>
 #include <QGuiApplication>
 #include <QMediaPlayer>
-#include <QTimer>
 #include <QUrl>
+#include <QVideoSink>
 #include <QVideoWidget>
 #include <QAction>
 #include <QKeySequence>
 #include <QApplication>
 #include <QMediaDevices>
+#include <QMediaMetaData>
+#include <QFileInfo>
 #include <QMouseEvent>
+#include <QSettings>
 #include <algorithm>
+#include <iterator>
 
 namespace {
     constexpr double kMinRate  = 0.25;
@@ -31,10 +44,29 @@ namespace {
   
     constexpr qint64 kSeekSmallMs = 250;
     constexpr qint64 kSeekBigMs   = 3000;
+
+    constexpr char kSettingsGroup[]      = "playback";
+    constexpr char kFrameBufferMbKey[]   = "frameBufferMB";
+    constexpr int  kDefaultFrameBufferMb = 256;
+    constexpr int  kMaxFrameBufferMb     = 4096;
+    constexpr char kProxyEnabledKey[]    = "proxyEnabled";
+    constexpr char kAnalysisEnabledKey[] = "backgroundAnalysis";  // thumbnails, audio peaks, scene cuts
+    constexpr qint64 kFallbackFrameMs    = 40;
+
+    constexpr int kProxySourceMinHeight = 1440; // above 1080p the decoder can't keep up with scrubbing
+
+    // J/K/L ladder. |speed| <= kMaxRate plays normally; beyond that the shuttle shows keyframes only.
+    constexpr double kShuttleLadder[] = {-32.0, -16.0, -8.0, 0.0, 1.0, 2.0, 4.0, 8.0, 16.0, 32.0};
+    constexpr int kShuttleLadderSize  = int(sizeof(kShuttleLadder) / sizeof(kShuttleLadder[0]));
+    constexpr int kShuttlePausedLevel = 3;
+
+    constexpr qint64 kReplayPreRollMs  = 4000;   // instant replay: loop around the tag
+    constexpr qint64 kReplayPostRollMs = 2000;
 } // namespace
 
 VideoPlayer::VideoPlayer(QWidget* parent) : QWidget(parent) {
     buildUi();
+    loadPlaybackSettings();
     wireSignals();
     setupPlaybackReliabilityHooks();
     buildKeyboardShortcuts();
@@ -46,16 +78,228 @@ VideoPlayer::~VideoPlayer() {
 }
 
 qint64 VideoPlayer::currentPositionMs() const {
+    if (shuttle_ && shuttle_->isActive()) return shuttle_->positionMs();
+    if (steppedPositionMs_ >= 0) return steppedPositionMs_;
     return player_ ? player_->position() : 0;
 }
 
+const MediaIndex* VideoPlayer::mediaIndex() const {
+    return (mediaIndexer_ && mediaIndexer_->isReady()) ? &mediaIndexer_->index() : nullptr;
+}
+
+void VideoPlayer::cancelBackgroundJobs() {
+    if (mediaIndexer_) mediaIndexer_->cancel();
+    if (proxyGenerator_) proxyGenerator_->cancel();
+    if (thumbnails_) thumbnails_->cancel();
+    if (audioPeaks_) audioPeaks_->cancel();
+    if (sceneAnalyzer_) sceneAnalyzer_->cancel();
+    pendingProxyPath_.clear();
+}
+
+void VideoPlayer::maybeStartProxyGeneration() {
+    if (!proxyEnabled_ || loadedSourcePath_.isEmpty() || isPlayingFromProxy()) return;
+    if (proxyGenerator_->state() != ProxyGenerator::State::Idle) return;
+
+    const QString suffix = QFileInfo(loadedSourcePath_).suffix().toLower();
+    const bool interlacedAvchd = (suffix == QStringLiteral("mts") || suffix == QStringLiteral("m2ts"));
+    const QSize resolution = player_->metaData().value(QMediaMetaData::Resolution).toSize();
+    const bool highResolution = resolution.height() >= kProxySourceMinHeight;
+    if (!interlacedAvchd && !highResolution) return;
+
+    proxyGenerator_->start(loadedSourcePath_, player_->duration());
+}
+
+void VideoPlayer::switchPlaybackSource(const QString& path, qint64 positionMs) {
+    if (!player_ || path.isEmpty() || path == playbackSourcePath_) return;
+    leaveShuttle(false);
+    const bool resumePlaying = (player_->playbackState() == QMediaPlayer::PlayingState);
+
+    seekScheduler_->cancel();
+    clearSteppedFrame();
+    clearFrameBuffer();
+    loop_.resetHead();
+    pendingProxyPath_.clear();
+    playbackSourcePath_ = path;
+
+    player_->setSource(QUrl::fromLocalFile(path));
+    player_->setPlaybackRate(playbackRate_);
+    player_->setPosition(positionMs);
+    if (resumePlaying) player_->play();
+}
+
 void VideoPlayer::seekToMs(qint64 posMs) {
     if (!player_) return;
+    leaveShuttle(false);
+    clearSteppedFrame();
     const qint64 dur = player_->duration();
     const qint64 target = (dur > 0) ? std::clamp(posMs, qint64{0}, dur) : std::max<qint64>(0, posMs);
+    telemetry_->noteSeekIssued();
     player_->setPosition(target);
 }
 
+void VideoPlayer::stepFrame(int direction) {
+    if (!player_ || loadedSourcePath_.isEmpty() || direction == 0) return;
+    leaveShuttle(true);
+    if (player_->playbackState() == QMediaPlayer::PlayingState) player_->pause();
+
+    const qint64 pos = currentPositionMs();
+    const FrameRingBuffer::Entry* entry =
+        (direction < 0) ? frameBuffer_.frameBefore(pos) : frameBuffer_.frameAfter(pos);
+    if (entry) {
+        showBufferedFrame(*entry);
+        return;
+    }
+
+    // Outside the buffered window: exact seek by one nominal frame (decodes from the previous keyframe).
+    const MediaIndex* index = mediaIndex();
+    const qint64 frameMs = index ? index->frameDurationMs() : kFallbackFrameMs;
+    seekToMs(pos + (direction < 0 ? -frameMs : frameMs));
+}
+
+bool VideoPlayer::isShuttling() const {
+    return shuttle_ && shuttle_->isActive();
+}
+
+void VideoPlayer::shuttleStep(int direction) {
+    if (!player_ || loadedSourcePath_.isEmpty() || direction == 0) return;
+
+    // Current rung: the shuttle speed, else the (highest rung not above the) playback rate, else paused.
+    int level = kShuttlePausedLevel;
+    if (isShuttling()) {
+        const double speed = shuttle_->speed();
+        level = int(std::find(std::begin(kShuttleLadder), std::end(kShuttleLadder), speed) - std::begin(kShuttleLadder));
+        if (level >= kShuttleLadderSize) level = kShuttlePausedLevel;
+    } else if (player_->playbackState() == QMediaPlayer::PlayingState) {
+        level = kShuttlePausedLevel + 1;
+        while (level + 1 < kShuttleLadderSize && kShuttleLadder[level + 1] <= playbackRate_) ++level;
+    }
+
+    applyShuttleLevel(std::clamp(level + (direction < 0 ? -1 : 1), 0, kShuttleLadderSize - 1));
+}
+
+void VideoPlayer::shuttleStop() {
+    if (!player_ || loadedSourcePath_.isEmpty()) return;
+    applyShuttleLevel(kShuttlePausedLevel);
+}
+
+void VideoPlayer::applyShuttleLevel(int level) {
+    const double speed = kShuttleLadder[level];
+    if (speed == 0.0) {
+        leaveShuttle(true);
+        player_->pause();
+        return;
+    }
+    if (speed > 0.0 && speed <= kMaxRate) {
+        leaveShuttle(true);
+        setPlaybackRateAndPlay(speed);
+        return;
+    }
+
+    // Shuttle: the player sits paused and only shows the keyframes the controller seeks to. The all-intra
+    // proxy can show any frame, so it gets exact targets.
+    if (isShuttling()) {
+        shuttle_->setSpeed(speed);
+    } else {
+        const qint64 startMs = currentPositionMs();
+        if (player_->playbackState() == QMediaPlayer::PlayingState) player_->pause();
+        clearSteppedFrame();
+        shuttle_->start(speed, startMs, player_->duration(), isPlayingFromProxy() ? nullptr : mediaIndex());
+    }
+    if (videoControlsBar_) videoControlsBar_->setPlaybackRate(speed);
+}
+
+void VideoPlayer::leaveShuttle(bool seekToShuttlePosition) {
+    if (!isShuttling()) return;
+    const qint64 posMs = shuttle_->stop();
+    seekScheduler_->cancel();
+    if (videoControlsBar_) videoControlsBar_->setPlaybackRate(playbackRate_);
+    if (!seekToShuttlePosition) return;
+
+    // Land exactly where the virtual playhead stopped (the screen shows the keyframe before it).
+    telemetry_->noteSeekIssued();
+    player_->setPosition(posMs);
+    if (videoTimelineBar_) videoTimelineBar_->setPositionMs(posMs);
+    emit positionChangedMs(posMs);
+}
+
+void VideoPlayer::setLoopInAtPlayhead() {
+    if (!player_ || loadedSourcePath_.isEmpty()) return;
+    loop_.setInMs(currentPositionMs());
+    emitLoopChanged();
+}
+
+void VideoPlayer::setLoopOutAtPlayhead() {
+    if (!player_ || loadedSourcePath_.isEmpty()) return;
+    loop_.setOutMs(currentPositionMs());
+    emitLoopChanged();
+}
+
+void VideoPlayer::clearLoop() {
+    loop_.clear();
+    emitLoopChanged();
+}
+
+void VideoPlayer::replayAroundMs(qint64 positionMs) {
+    if (!player_ || loadedSourcePath_.isEmpty()) return;
+    const qint64 dur = player_->duration();
+    const qint64 inMs = std::max<qint64>(0, positionMs - kReplayPreRollMs);
+    const qint64 outMs = (dur > 0) ? std::min(dur, positionMs + kReplayPostRollMs) : positionMs + kReplayPostRollMs;
+    loop_.setRegion(inMs, outMs);
+    emitLoopChanged();
+    seekToMs(inMs);
+    player_->play();
+}
+
+void VideoPlayer::emitLoopChanged() {
+    if (loop_.isActive()) {
+        emit loopChanged(loop_.inMs(), loop_.outMs());
+    } else {
+        emit loopChanged(-1, -1);
+    }
+}
+
+void VideoPlayer::wrapLoop() {
+    // Show the cached head at once; the decoder catches up behind it.
+    if (const FrameRingBuffer::Entry* head = loop_.headFrame()) injectFrame(head->frame);
+    telemetry_->noteSeekIssued();
+    player_->setPosition(loop_.inMs());
+}
+
+void VideoPlayer::showBufferedFrame(const FrameRingBuffer::Entry& entry) {
+    steppedPositionMs_ = entry.timeMs;
+    injectFrame(entry.frame);
+
+    if (videoTimelineBar_) videoTimelineBar_->setPositionMs(entry.timeMs);
+    emit positionChangedMs(entry.timeMs);
+}
+
+// Puts a buffered frame on screen. The sink delivers it synchronously, so the flags cover exactly this
+// frame: it is not fed back into the buffers, not counted by telemetry, and does not complete a seek.
+void VideoPlayer::injectFrame(const QVideoFrame& frame) {
+    injectingSteppedFrame_ = true;
+    telemetry_->setInjectingFrame(true);
+    seekScheduler_->setInjectingFrame(true);
+    videoWidget_->videoSink()->setVideoFrame(frame);
+    seekScheduler_->setInjectingFrame(false);
+    telemetry_->setInjectingFrame(false);
+    injectingSteppedFrame_ = false;
+}
+
+void VideoPlayer::clearFrameBuffer() {
+    frameCopier_->reset();
+    frameBuffer_.clear();
+}
+
+void VideoPlayer::loadPlaybackSettings() {
+    QSettings settings;
+    settings.beginGroup(QLatin1String(kSettingsGroup));
+    const int mb = settings.value(QLatin1String(kFrameBufferMbKey), kDefaultFrameBufferMb).toInt();
+    proxyEnabled_ = settings.value(QLatin1String(kProxyEnabledKey), true).toBool();
+    analysisEnabled_ = settings.value(QLatin1String(kAnalysisEnabledKey), true).toBool();
+    settings.endGroup();
+    frameBuffer_.setBudgetBytes(qint64(std::clamp(mb, 0, kMaxFrameBufferMb)) * 1024 * 1024);
+}
+
 void VideoPlayer::buildUi() {
     // VideoPlayer manages the video widget and player logic
     // Controls and timeline are exposed separately for WorkWindow to lay out
@@ -77,6 +321,28 @@ void VideoPlayer::buildUi() {
     player_->setAudioOutput(audioOutput_);
     player_->setVideoOutput(videoWidget_);
 
+    // keyframe index (built in the background on load; scrubbing snaps to it once ready):
+    mediaIndexer_ = new MediaIndexer(this);
+    seekScheduler_ = new SeekScheduler(player_, videoWidget_->videoSink(), this);
+    proxyGenerator_ = new ProxyGenerator(this);
+    telemetry_ = new PlaybackTelemetry(player_, videoWidget_->videoSink(), this);
+    telemetry_->setHudHost(videoWidget_);
+    shuttle_ = new ShuttleController(this);
+    frameCopier_ = new FrameCopier(this);
+    thumbnails_ = new ThumbnailSprites(this);
+    videoTimelineBar_->setThumbnailSource(thumbnails_);
+    audioPeaks_ = new AudioPeaksBuilder(this);
+    videoTimelineBar_->setAudioPeaks(audioPeaks_);
+    sceneAnalyzer_ = new SceneAnalyzer(this);
+    videoTimelineBar_->setSceneAnalysis(sceneAnalyzer_);
+    connect(seekScheduler_, &SeekScheduler::seekLatencyMeasured, telemetry_, &PlaybackTelemetry::noteSeekLatency);
+    connect(mediaIndexer_, &MediaIndexer::indexReady, this, [this]() {
+        telemetry_->setNominalFrameRate(mediaIndexer_->index().frameRate);
+        if (videoTimelineBar_) videoTimelineBar_->setFrameDurationMs(mediaIndexer_->index().frameDurationMs());
+        // Scene analysis splits the decode at keyframes, so it waits for the index.
+        if (analysisEnabled_) sceneAnalyzer_->start(mediaIndexer_->sourcePath(), mediaIndexer_->index());
+    });
+
     // initial visibility: hidden until video is loaded
     if (videoWidget_) videoWidget_->hide();
     if (videoControlsBar_) videoControlsBar_->hide();
@@ -96,11 +362,36 @@ void VideoPlayer::wireSignals() {
     });
     connect(videoControlsBar_, &VideoControlsBar::togglePlayPauseFromKeyboardShortcut, this,
             &VideoPlayer::togglePlayPauseWithControlFlash);
+    connect(videoControlsBar_, &VideoControlsBar::shuttleStepRequested, this, &VideoPlayer::shuttleStep);
+    connect(videoControlsBar_, &VideoControlsBar::shuttleStopRequested, this, &VideoPlayer::shuttleStop);
+    connect(videoControlsBar_, &VideoControlsBar::loopInRequested, this, &VideoPlayer::setLoopInAtPlayhead);
+    connect(videoControlsBar_, &VideoControlsBar::loopOutRequested, this, &VideoPlayer::setLoopOutAtPlayhead);
+    connect(videoControlsBar_, &VideoControlsBar::loopClearRequested, this, &VideoPlayer::clearLoop);
+
+    // Shuttle -> scheduler (one keyframe seek in flight) and timeline (virtual playhead)
+    connect(shuttle_, &ShuttleController::seekRequested, seekScheduler_, &SeekScheduler::requestSeek);
+    connect(shuttle_, &ShuttleController::positionChanged, this, [this](qint64 posMs) {
+        if (videoTimelineBar_) videoTimelineBar_->setPositionMs(posMs);
+        emit positionChangedMs(posMs);
+    });
+    connect(shuttle_, &ShuttleController::boundaryReached, this, &VideoPlayer::shuttleStop);
 
     // play pause button sensible to state changes:
     connect(player_, &QMediaPlayer::playbackStateChanged, this, [this](QMediaPlayer::PlaybackState state) {
         if (videoControlsBar_) videoControlsBar_->setPlaying(state == QMediaPlayer::PlayingState);
         updateStallMonitorForPlaybackState(state);
+        emit playingChanged(state == QMediaPlayer::PlayingState);
+
+        // Resuming from a buffered frame: the decoder is still parked where stepping started.
+        if (state == QMediaPlayer::PlayingState && steppedPositionMs_ >= 0) {
+            const qint64 resumeMs = steppedPositionMs_;
+            clearSteppedFrame();
+            player_->setPosition(resumeMs);
+        }
+    });
+
+    connect(player_, &QMediaPlayer::playbackRateChanged, this, [this](qreal rate) {
+        emit playbackRateChanged(double(rate));
     });
 
     // Player -> timeline widget
@@ -110,36 +401,66 @@ void VideoPlayer::wireSignals() {
     });
 
     connect(player_, &QMediaPlayer::positionChanged, this, [this](qint64 pos) {
+        if (steppedPositionMs_ >= 0 || isShuttling()) return;
+        const qint64 previousMs = lastPlayerPositionMs_;
+        lastPlayerPositionMs_ = pos;
+        if (loop_.shouldWrap(pos) && previousMs >= loop_.inMs() && previousMs < loop_.outMs() &&
+            player_->playbackState() == QMediaPlayer::PlayingState && !scrubbing_) {
+            wrapLoop();
+            return;
+        }
         if (videoTimelineBar_) videoTimelineBar_->setPositionMs(pos);
         emit positionChangedMs(pos);
     });
 
     // Timeline widget -> Player (scrub behavior)
-    connect(videoTimelineBar_, &TimelineBar::scrubStarted, this, [this]() {
-        wasPlayingBeforeScrub_ = (player_->playbackState() == QMediaPlayer::PlayingState);
-        if (wasPlayingBeforeScrub_) player_->pause();
-    });
+    connect(videoTimelineBar_, &TimelineBar::scrubStarted, this, &VideoPlayer::beginScrub);
+    connect(videoTimelineBar_, &TimelineBar::scrubSeekTo, this, &VideoPlayer::scrubTo);
+    connect(videoTimelineBar_, &TimelineBar::scrubFinished, this, &VideoPlayer::endScrub);
 
-    // Live seeking while dragging (TimelineBar throttles; you just apply)
-    connect(videoTimelineBar_, &TimelineBar::scrubSeekTo, this, [this](qint64 posMs) {
-        player_->setPosition(posMs);
+    // Proxy: decide once the original is loaded (resolution known), switch as soon as it's ready.
+    connect(player_, &QMediaPlayer::mediaStatusChanged, this, [this](QMediaPlayer::MediaStatus status) {
+        if (status == QMediaPlayer::LoadedMedia) maybeStartProxyGeneration();
     });
-
-    // Final seek + resume if needed
-    connect(videoTimelineBar_, &TimelineBar::scrubFinished, this, [this](qint64 posMs) {
-        player_->setPosition(posMs);
-        if (wasPlayingBeforeScrub_) player_->play();
-        wasPlayingBeforeScrub_ = false;
+    connect(proxyGenerator_, &ProxyGenerator::proxyReady, this, [this](const QString& proxyPath) {
+        if (loadedSourcePath_.isEmpty()) return;
+        if (scrubbing_) {
+            pendingProxyPath_ = proxyPath;
+            return;
+        }
+        switchPlaybackSource(proxyPath, currentPositionMs());
     });
+    connect(proxyGenerator_, &ProxyGenerator::failed, this, [](const QString& message) {
+        qWarning("VideoPlayer: proxy generation failed: %s", qPrintable(message));
+    });
+
+    connect(videoTimelineBar_, &TimelineBar::markerSeekRequested, this, &VideoPlayer::seekToMs);
 
     // Time-entry seek should pause and stay paused after jumping.
     connect(videoTimelineBar_, &TimelineBar::timeEntryStarted, this, [this]() {
         wasPlayingBeforeScrub_ = false;
+        leaveShuttle(true);
         if (player_->playbackState() == QMediaPlayer::PlayingState) {
             player_->pause();
         }
     });
 
+    // Decoded frames -> loop head cache and frame-step buffer (skipped for scrub previews and our own injected
+    // frames; the step buffer also skips fast playback). Only the loop head window is copied here; step-buffer
+    // copies run on the FrameCopier worker so the frame path stays a queue push.
+    connect(videoWidget_->videoSink(), &QVideoSink::videoFrameChanged, this, [this](const QVideoFrame& frame) {
+        if (injectingSteppedFrame_ || scrubbing_ || isShuttling()) return;
+        const qint64 timeMs = (frame.startTime() >= 0) ? frame.startTime() / 1000 : player_->position();
+        loop_.captureHead(timeMs, frame);
+        if (!frameBuffer_.isEnabled() || playbackRate_ > 1.0) return;
+        frameCopier_->submit(timeMs, frame);
+    });
+    connect(frameCopier_, &FrameCopier::frameCopied, this,
+            [this](quint64 generation, qint64 timeMs, const QVideoFrame& copy, qint64 bytes) {
+                if (generation != frameCopier_->generation()) return;  // from before a seek or source switch
+                frameBuffer_.append(timeMs, copy, bytes);
+            });
+
     // Mouse click on video widget toggles play/pause
     videoWidget_->installEventFilter(this);
 }
@@ -181,10 +502,21 @@ void VideoPlayer::buildKeyboardShortcuts() {
         onSeekBigForward();
     });
     
+    // Alt + Arrows: frame step
+    frameStepBackAction_ = makeAction(QKeySequence(Qt::ALT | Qt::Key_Left), [this]() { stepFrame(-1); });
+    frameStepForwardAction_ = makeAction(QKeySequence(Qt::ALT | Qt::Key_Right), [this]() { stepFrame(+1); });
+
     seekSmallBackAction_->setEnabled(false);
     seekSmallForwardAction_->setEnabled(false);
     seekBigBackAction_->setEnabled(false);
     seekBigForwardAction_->setEnabled(false);
+    frameStepBackAction_->setEnabled(false);
+    frameStepForwardAction_->setEnabled(false);
+
+    // Ctrl/Cmd + Shift + D: playback diagnostics HUD (always available, also without media)
+    diagnosticsHudAction_ = makeAction(QKeySequence(Qt::CTRL | Qt::SHIFT | Qt::Key_D), [this]() {
+        telemetry_->setHudVisible(!telemetry_->isHudVisible());
+    });
 }
 
 void VideoPlayer::setControlsVisible(bool visible) {
@@ -216,6 +548,8 @@ void VideoPlayer::updatePlaybackShortcutActionStates() {
     if (seekSmallForwardAction_) seekSmallForwardAction_->setEnabled(shortcutsOn);
     if (seekBigBackAction_) seekBigBackAction_->setEnabled(shortcutsOn);
     if (seekBigForwardAction_) seekBigForwardAction_->setEnabled(shortcutsOn);
+    if (frameStepBackAction_) frameStepBackAction_->setEnabled(shortcutsOn);
+    if (frameStepForwardAction_) frameStepForwardAction_->setEnabled(shortcutsOn);
     if (videoControlsBar_) {
         videoControlsBar_->setPlaybackShortcutMediaGate(shortcutsOn);
     }
@@ -223,33 +557,71 @@ void VideoPlayer::updatePlaybackShortcutActionStates() {
 
 void VideoPlayer::seekByMs(qint64 deltaMs) {
     const qint64 dur  = player_->duration();
-    const qint64 pos  = player_->position();
+    const qint64 pos  = currentPositionMs();
     const qint64 next = pos + deltaMs;
 
     const qint64 target = (dur > 0) ? std::clamp(next, qint64{0}, dur) : std::max<qint64>(0, next);
+    leaveShuttle(false);
+    clearSteppedFrame();
+    telemetry_->noteSeekIssued();
     player_->setPosition(target);
 }
 
-void VideoPlayer::onPlayClicked() { player_->play(); }
-void VideoPlayer::onPauseClicked() { player_->pause(); }
+void VideoPlayer::play() { leaveShuttle(true); player_->play(); }
+void VideoPlayer::pause() { leaveShuttle(true); player_->pause(); }
+
+void VideoPlayer::beginScrub() {
+    leaveShuttle(false);
+    scrubbing_ = true;
+    seekScheduler_->cancel();  // playback may have moved off the last scrub target
+    clearSteppedFrame();
+    wasPlayingBeforeScrub_ = (player_->playbackState() == QMediaPlayer::PlayingState);
+    if (wasPlayingBeforeScrub_) player_->pause();
+}
+
+// Live seeking while dragging: the scheduler keeps one seek in flight and always jumps to the latest
+// position. Preview seeks land on the nearest keyframe so the decoder never rolls forward through a GOP.
+void VideoPlayer::scrubTo(qint64 posMs) {
+    // The all-intra proxy can land anywhere; only the original needs keyframe snapping.
+    const MediaIndex* index = isPlayingFromProxy() ? nullptr : mediaIndex();
+    seekScheduler_->requestSeek(index ? index->nearestKeyframeMs(posMs) : posMs);
+}
+
+// Final exact seek + resume if needed
+void VideoPlayer::endScrub(qint64 posMs) {
+    scrubbing_ = false;
+    seekScheduler_->cancel();
+    clearSteppedFrame();
+    telemetry_->noteSeekIssued();
+    player_->setPosition(posMs);
+    if (wasPlayingBeforeScrub_) player_->play();
+    wasPlayingBeforeScrub_ = false;
+    if (!pendingProxyPath_.isEmpty()) switchPlaybackSource(pendingProxyPath_, posMs);
+}
+
+void VideoPlayer::onPlayClicked() { play(); }
+void VideoPlayer::onPauseClicked() { pause(); }
 void VideoPlayer::onSeekSmallBackward() { seekByMs(-kSeekSmallMs); }
 void VideoPlayer::onSeekSmallForward() { seekByMs(+kSeekSmallMs); }
 void VideoPlayer::onSeekBigBackward() { seekByMs(-kSeekBigMs); }
 void VideoPlayer::onSeekBigForward() { seekByMs(+kSeekBigMs); }
 
 void VideoPlayer::onSlowerClicked() {
+    leaveShuttle(true);
     playbackRate_ = std::max(kMinRate, playbackRate_ - kRateStep);
     player_->setPlaybackRate(playbackRate_);
     if (videoControlsBar_) videoControlsBar_->setPlaybackRate(playbackRate_);
 }
 
 void VideoPlayer::onResetSpeedClicked() {
+    leaveShuttle(true);
     playbackRate_ = 1.0;
     player_->setPlaybackRate(playbackRate_);
     if (videoControlsBar_) videoControlsBar_->setPlaybackRate(playbackRate_);
 }
 
 void VideoPlayer::onFasterClicked() {
+    leaveShuttle(true);
     playbackRate_ = std::min(kMaxRate, playbackRate_ + kRateStep);
     player_->setPlaybackRate(playbackRate_);
     if (videoControlsBar_) videoControlsBar_->setPlaybackRate(playbackRate_);
@@ -262,6 +634,10 @@ void VideoPlayer::onMuteToggled(bool muted) {
 
 void VideoPlayer::onTogglePlayPause() {
     if (!player_) return;
+    if (isShuttling()) {  // Space while shuttling stops on the current position
+        shuttleStop();
+        return;
+    }
     const auto state = player_->playbackState();
     (state == QMediaPlayer::PlayingState) ? player_->pause() : player_->play();
 }
@@ -270,7 +646,7 @@ void VideoPlayer::togglePlayPauseWithControlFlash() {
     if (!player_) return;
     const auto state = player_->playbackState();
     if (videoControlsBar_) {
-        (state == QMediaPlayer::PlayingState) ? videoControlsBar_->flashPauseButton()
+        (state == QMediaPlayer::PlayingState || isShuttling()) ? videoControlsBar_->flashPauseButton()
                                               : videoControlsBar_->flashPlayButton();
     }
     onTogglePlayPause();
@@ -299,31 +675,22 @@ void VideoPlayer::setPlaybackRateAndPlay(double rate) {
 }
 
 void VideoPlayer::setupPlaybackReliabilityHooks() {
-    playbackStallTimer_ = new QTimer(this);
-    playbackStallTimer_->setInterval(3500);
-    connect(playbackStallTimer_, &QTimer::timeout, this, [this]() {
+    // Stall recovery is driven by frame delivery (PlaybackTelemetry watchdog): nudge first, reload if the
+    // sink stays silent, give up after a bounded number of reloads. Detection takes a few hundred ms
+    // instead of the old multi-second position poll.
+    connect(telemetry_, &PlaybackTelemetry::stallDetected, this, [this](int attempt, qint64 /*stalledForMs*/) {
         if (!player_ || loadedSourcePath_.isEmpty()) return;
-        if (player_->playbackState() != QMediaPlayer::PlayingState) return;
-
-        const qint64 dur = player_->duration();
-        const qint64 pos = player_->position();
-        if (dur > 0 && pos >= dur - 400) return;
-
-        if (lastStallCheckPositionMs_ < 0) {
-            lastStallCheckPositionMs_ = pos;
-            return;
-        }
-        if (pos == lastStallCheckPositionMs_) {
-            ++consecutivePlaybackStallTicks_;
+        if (attempt == 1) {
+            telemetry_->noteRecovery(QStringLiteral("nudge"));
             nudgePlaybackAfterBackendStall();
-            if (consecutivePlaybackStallTicks_ >= 2) {
-                reloadCurrentMediaFromDisk();
-                consecutivePlaybackStallTicks_ = 0;
-            }
         } else {
-            consecutivePlaybackStallTicks_ = 0;
+            telemetry_->noteRecovery(QStringLiteral("reload"));
+            reloadCurrentMediaFromDisk();
         }
-        lastStallCheckPositionMs_ = pos;
+    });
+    connect(telemetry_, &PlaybackTelemetry::stallAbandoned, this, [this](qint64 /*stalledForMs*/) {
+        // Leave the player paused on the stuck frame instead of reloading forever; play retries from scratch.
+        if (player_) player_->pause();
     });
 
     if (QGuiApplication::instance() != nullptr) {
@@ -334,28 +701,23 @@ void VideoPlayer::setupPlaybackReliabilityHooks() {
                         player_->playbackState() != QMediaPlayer::PlayingState) {
                         player_->play();
                     }
-                    consecutivePlaybackStallTicks_ = 0;
-                    lastStallCheckPositionMs_ = -1;
                 });
     }
 
     connect(player_, &QMediaPlayer::errorOccurred, this,
             [this](QMediaPlayer::Error error, const QString& /*errorString*/) {
                 if (error == QMediaPlayer::NoError || loadedSourcePath_.isEmpty()) return;
+                if (isPlayingFromProxy()) {
+                    // A broken proxy must never block review; fall back to the original.
+                    switchPlaybackSource(loadedSourcePath_, currentPositionMs());
+                    return;
+                }
                 nudgePlaybackAfterBackendStall();
             });
 }
 
 void VideoPlayer::updateStallMonitorForPlaybackState(QMediaPlayer::PlaybackState state) {
-    if (!playbackStallTimer_) return;
     userRequestedPlaying_ = (state == QMediaPlayer::PlayingState);
-    if (state == QMediaPlayer::PlayingState) {
-        lastStallCheckPositionMs_ = -1;
-        consecutivePlaybackStallTicks_ = 0;
-        playbackStallTimer_->start();
-    } else {
-        playbackStallTimer_->stop();
-    }
 }
 
 void VideoPlayer::nudgePlaybackAfterBackendStall() {
@@ -364,10 +726,11 @@ void VideoPlayer::nudgePlaybackAfterBackendStall() {
     const qint64 dur = player_->duration();
     qint64 bumpMs = 1;
     if (dur > 0 && pos >= dur - 5) bumpMs = 0;
+    const bool resumePlaying = userRequestedPlaying_; // pause() below clears it
 
     player_->pause();
     player_->setPosition(pos + bumpMs);
-    if (userRequestedPlaying_) player_->play();
+    if (resumePlaying) player_->play();
 }
 
 void VideoPlayer::reloadCurrentMediaFromDisk() {
@@ -378,7 +741,7 @@ void VideoPlayer::reloadCurrentMediaFromDisk() {
 
     player_->stop();
     player_->setSource(QUrl());
-    player_->setSource(QUrl::fromLocalFile(loadedSourcePath_));
+    player_->setSource(QUrl::fromLocalFile(playbackSourcePath_));
     player_->setPlaybackRate(savedRate);
     if (videoControlsBar_) videoControlsBar_->setPlaybackRate(savedRate);
     player_->setPosition(pos);
@@ -398,6 +761,16 @@ void VideoPlayer::loadVideoFromFile(const QString& filePath) {
     // Reset timeline UI immediately; durationChanged will set real range later
     durationMs_ = 0;
     wasPlayingBeforeScrub_ = false;
+    scrubbing_ = false;
+    leaveShuttle(false);
+    seekScheduler_->cancel();
+    clearSteppedFrame();
+    clearFrameBuffer();
+    loop_.clear();
+    lastPlayerPositionMs_ = -1;
+    emitLoopChanged();
+    telemetry_->resetStats();
+    telemetry_->setNominalFrameRate(0.0);
     
     if (videoTimelineBar_) videoTimelineBar_->reset();
     audioOutput_->setMuted(false);
@@ -408,7 +781,20 @@ void VideoPlayer::loadVideoFromFile(const QString& filePath) {
     if (videoControlsBar_) videoControlsBar_->setPlaybackRate(playbackRate_);
     
     loadedSourcePath_ = filePath;
+    playbackSourcePath_ = filePath;
+    pendingProxyPath_.clear();
     avaBeginPlaybackUserActivity();
+    mediaIndexer_->start(filePath);
+    if (analysisEnabled_) {
+        thumbnails_->start(filePath);  // cancels the previous video's extraction
+        audioPeaks_->start(filePath);
+    } else {
+        thumbnails_->cancel();
+        audioPeaks_->cancel();
+    }
+    sceneAnalyzer_->cancel();     // restarted from indexReady once the new keyframes are known
+    // A proxy from an earlier session is picked up right away; otherwise mediaStatusChanged decides.
+    if (proxyEnabled_) proxyGenerator_->useCachedProxy(filePath);
 
     // Load (don't assume it will succeed)
     player_->stop();
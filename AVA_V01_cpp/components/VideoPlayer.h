@@ -1,5 +1,8 @@
 #pragma once
 
+#include "FrameRingBuffer.h"
+#include "PlaybackLoop.h"
+
 #include <QMediaPlayer>
 #include <QWidget>
 
@@ -7,9 +10,18 @@ class QVideoWidget;
 class QAudioOutput;
 class QMediaDevices;
 class QAction;
-class QTimer;
 class VideoControlsBar;
 class TimelineBar;
+class MediaIndexer;
+class SeekScheduler;
+class ProxyGenerator;
+class PlaybackTelemetry;
+class ThumbnailSprites;
+class AudioPeaksBuilder;
+class SceneAnalyzer;
+class ShuttleController;
+class FrameCopier;
+struct MediaIndex;
 
 class VideoPlayer final : public QWidget {
   Q_OBJECT
@@ -22,10 +34,53 @@ public:
   QVideoWidget* videoWidget() const { return videoWidget_; }
   VideoControlsBar* controlsBar() const { return videoControlsBar_; }
   TimelineBar* timelineBar() const { return videoTimelineBar_; }
+  AudioPeaksBuilder* audioAnalysis() const { return audioPeaks_; }
+  SceneAnalyzer* sceneAnalysis() const { return sceneAnalyzer_; }
 
   qint64 currentPositionMs() const;
   qint64 durationMs() const { return durationMs_; }
+  bool isPlaying() const { return player_ && player_->playbackState() == QMediaPlayer::PlayingState; }
+  double playbackRate() const { return playbackRate_; }
   void seekToMs(qint64 posMs);
+  /// Same as the play / pause buttons (also leaves shuttle mode).
+  void play();
+  void pause();
+
+  /// A timeline drag: begin pauses if playing, scrubTo shows keyframe previews, endScrub seeks exactly
+  /// to the release point and resumes. The timeline bar drives these; the bench calls them directly.
+  void beginScrub();
+  void scrubTo(qint64 posMs);
+  void endScrub(qint64 posMs);
+
+  /// Pauses and shows the previous (-1) or next (+1) frame; served from the frame buffer when possible.
+  void stepFrame(int direction);
+
+  /// J / K / L: walks the shuttle ladder (-32x … -8x, pause, 1x … 4x normal playback, 8x … 32x keyframe shuttle).
+  void shuttleStep(int direction);
+  void shuttleStop();
+  bool isShuttling() const;
+
+  /// A-B loop (I / O keys); points can be moved while playing. Playback wraps from out to in only when it
+  /// runs into the out point from inside the region, so seeking outside the loop still works.
+  void setLoopInAtPlayhead();
+  void setLoopOutAtPlayhead();
+  void clearLoop();
+  bool hasLoop() const { return loop_.isActive(); }
+  /// Loops the few seconds around `positionMs` (instant replay of a tag) and starts playing from the in point.
+  void replayAroundMs(qint64 positionMs);
+
+  /// Keyframe index of the loaded source, or nullptr while it is still being built.
+  const MediaIndex* mediaIndex() const;
+
+  /// Background proxy for heavy sources (4K, AVCHD). Playback switches to it once ready; export never does.
+  ProxyGenerator* proxyGenerator() const { return proxyGenerator_; }
+  PlaybackTelemetry* telemetry() const { return telemetry_; }
+  /// Worker that fills the frame-step buffer during playback (its stats show the copy cost).
+  FrameCopier* frameCopier() const { return frameCopier_; }
+  bool isPlayingFromProxy() const { return !playbackSourcePath_.isEmpty() && playbackSourcePath_ != loadedSourcePath_; }
+
+  /// Stops index/proxy jobs for the current source (video closed).
+  void cancelBackgroundJobs();
 
   void setControlsVisible(bool visible);
   void setControlsEnabled(bool enabled);
@@ -45,6 +100,9 @@ public:
 signals:
   void videoClosed();
   void positionChangedMs(qint64 positionMs);
+  void loopChanged(qint64 inMs, qint64 outMs);   // -1 / -1 when cleared
+  void playingChanged(bool playing);
+  void playbackRateChanged(double rate);
 
 private slots:
   void onPlayClicked();
@@ -75,6 +133,17 @@ private:
   void updateStallMonitorForPlaybackState(QMediaPlayer::PlaybackState state);
   void nudgePlaybackAfterBackendStall();
   void reloadCurrentMediaFromDisk();
+  void loadPlaybackSettings();
+  void showBufferedFrame(const FrameRingBuffer::Entry& entry);
+  void injectFrame(const QVideoFrame& frame);
+  void clearSteppedFrame() { steppedPositionMs_ = -1; }
+  void clearFrameBuffer();
+  void maybeStartProxyGeneration();
+  void switchPlaybackSource(const QString& path, qint64 positionMs);
+  void applyShuttleLevel(int level);
+  void leaveShuttle(bool seekToShuttlePosition);
+  void wrapLoop();
+  void emitLoopChanged();
 
   QMediaPlayer* player_ = nullptr;
   QAudioOutput* audioOutput_ = nullptr;
@@ -83,12 +152,24 @@ private:
   VideoControlsBar* videoControlsBar_ = nullptr;
   TimelineBar* videoTimelineBar_ = nullptr;
   QVideoWidget* videoWidget_ = nullptr;
+  MediaIndexer* mediaIndexer_ = nullptr;
+  SeekScheduler* seekScheduler_ = nullptr;
+  ProxyGenerator* proxyGenerator_ = nullptr;
+  PlaybackTelemetry* telemetry_ = nullptr;
+  ThumbnailSprites* thumbnails_ = nullptr;
+  AudioPeaksBuilder* audioPeaks_ = nullptr;
+  SceneAnalyzer* sceneAnalyzer_ = nullptr;
+  ShuttleController* shuttle_ = nullptr;
+  FrameCopier* frameCopier_ = nullptr;
 
   // keyboard shortcuts (seek arrows only; play/speed keys are handled in WorkWindow — see buildKeyboardShortcuts):
   QAction* seekSmallBackAction_ = nullptr;
   QAction* seekSmallForwardAction_ = nullptr;
   QAction* seekBigBackAction_ = nullptr;
   QAction* seekBigForwardAction_ = nullptr;
+  QAction* frameStepBackAction_ = nullptr;
+  QAction* frameStepForwardAction_ = nullptr;
+  QAction* diagnosticsHudAction_ = nullptr;
 
   bool mediaControlsEnabled_ = false;
   bool playbackKeyboardShortcutsEnabled_ = true;
@@ -96,11 +177,21 @@ private:
   // Settings or constants:
   double playbackRate_ = 1.0;
   bool wasPlayingBeforeScrub_ = false;
+  bool scrubbing_ = false;
   qint64 durationMs_ = 0;
 
-  QTimer* playbackStallTimer_ = nullptr;
-  QString loadedSourcePath_;
-  qint64 lastStallCheckPositionMs_ = -1;
-  int consecutivePlaybackStallTicks_ = 0;
+  QString loadedSourcePath_;          // original file (what export and the index use)
+  QString playbackSourcePath_;        // what the player is decoding: the original or its proxy
+  QString pendingProxyPath_;          // proxy that became ready mid-scrub; applied on release
+  bool proxyEnabled_ = true;          // QSettings playback/proxyEnabled
+  bool analysisEnabled_ = true;       // QSettings playback/backgroundAnalysis (off in the bench)
   bool userRequestedPlaying_ = false;
+
+  // frame stepping: recent decoded frames, and the position of a buffered frame currently on screen (-1 = none)
+  FrameRingBuffer frameBuffer_;
+  qint64 steppedPositionMs_ = -1;
+  bool injectingSteppedFrame_ = false;
+
+  PlaybackLoop loop_;
+  qint64 lastPlayerPositionMs_ = -1;   // previous positionChanged value, to detect crossing the loop out point
 };
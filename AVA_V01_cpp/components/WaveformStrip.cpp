@@ -0,0 +1,92 @@
+#include "WaveformStrip.h"
+#include "AudioPeaks.h"
+
+#include <QPainter>
+#include <QPaintEvent>
+#include <QResizeEvent>
+
+#include <algorithm>
+
+namespace {
+constexpr int kHeight = 22;
+const QColor kWaveColor(0x71, 0x71, 0x7a);
+} // namespace
+
+WaveformStrip::WaveformStrip(QWidget* parent)
+  : QWidget(parent) {
+  setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+  setFixedHeight(kHeight);
+}
+
+QSize WaveformStrip::sizeHint() const {
+  return QSize(200, kHeight);
+}
+
+void WaveformStrip::setPeakSource(AudioPeaksBuilder* peaks) {
+  if (peaks_ == peaks) return;
+  if (peaks_) disconnect(peaks_, nullptr, this, nullptr);
+  peaks_ = peaks;
+  if (peaks_) connect(peaks_, &AudioPeaksBuilder::peaksUpdated, this, &WaveformStrip::invalidateCache);
+  invalidateCache();
+}
+
+void WaveformStrip::setViewRangeMs(qint64 startMs, qint64 spanMs) {
+  if (startMs == viewStartMs_ && spanMs == viewSpanMs_) return;
+  viewStartMs_ = std::max<qint64>(0, startMs);
+  viewSpanMs_ = std::max<qint64>(0, spanMs);
+  invalidateCache();
+}
+
+void WaveformStrip::invalidateCache() {
+  cacheValid_ = false;
+  update();
+}
+
+void WaveformStrip::renderCache() {
+  const qreal dpr = devicePixelRatioF();
+  cache_ = QPixmap(size() * dpr);
+  cache_.setDevicePixelRatio(dpr);
+  cache_.fill(Qt::transparent);
+  cacheValid_ = true;
+
+  if (!peaks_ || viewSpanMs_ <= 0 || width() <= 1) return;
+  const AudioPeakPyramid& pyramid = peaks_->peaks();
+  if (pyramid.isEmpty()) return;
+
+  // Normalize to the loudest peak so quiet camera audio still shows its whistles.
+  const int amplitude = std::max(1, pyramid.maxAmplitude());
+  const double halfHeight = (height() - 2) / 2.0;
+  const double midY = height() / 2.0;
+  const double msPerPx = static_cast<double>(viewSpanMs_) / (width() - 1);
+  const int level = pyramid.levelForMsPerPixel(msPerPx);
+
+  QPainter p(&cache_);
+  p.setPen(kWaveColor);
+  for (int x = 0; x < width(); ++x) {
+    const qint64 fromMs = viewStartMs_ + static_cast<qint64>(x * msPerPx);
+    const qint64 toMs = std::max(fromMs + 1, viewStartMs_ + static_cast<qint64>((x + 1) * msPerPx));
+    AudioPeakPyramid::Peak peak;
+    // While decoding, coarse levels lag behind level 0 at the tail; fall back to a finer level there.
+    int readLevel = level;
+    while (readLevel >= 0 && !pyramid.peakInRange(readLevel, fromMs, toMs, &peak)) --readLevel;
+    if (readLevel < 0) continue;
+    const int top = static_cast<int>(midY - peak.max * halfHeight / amplitude);
+    const int bottom = static_cast<int>(midY - peak.min * halfHeight / amplitude);
+    p.drawLine(x, top, x, std::max(top, bottom));
+  }
+}
+
+void WaveformStrip::paintEvent(QPaintEvent* event) {
+  if (!cacheValid_ || cache_.size() != size() * devicePixelRatioF()) renderCache();
+
+  QPainter p(this);
+  if (!isEnabled()) p.setOpacity(0.5);
+  const QRect dirty = event->rect();
+  const qreal dpr = cache_.devicePixelRatio();
+  p.drawPixmap(dirty, cache_, QRectF(dirty.topLeft() * dpr, dirty.size() * dpr));
+}
+
+void WaveformStrip::resizeEvent(QResizeEvent* event) {
+  QWidget::resizeEvent(event);
+  cacheValid_ = false;
+}
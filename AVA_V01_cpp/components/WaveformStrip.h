@@ -0,0 +1,37 @@
+#pragma once
+
+#include <QPixmap>
+#include <QWidget>
+#include <QtGlobal>
+
+class AudioPeaksBuilder;
+
+// Audio envelope drawn under the timeline viewport with the same ms -> x mapping.
+// Each column reads the pyramid level whose buckets are just narrower than a pixel, so a repaint
+// touches at most a couple of peaks per column at any zoom; the result is cached until the view,
+// size or peaks change.
+class WaveformStrip final : public QWidget {
+  Q_OBJECT
+public:
+  explicit WaveformStrip(QWidget* parent = nullptr);
+
+  void setPeakSource(AudioPeaksBuilder* peaks);
+  void setViewRangeMs(qint64 startMs, qint64 spanMs);  // follows the TimelineViewport zoom
+
+  QSize sizeHint() const override;
+
+protected:
+  void paintEvent(QPaintEvent* event) override;
+  void resizeEvent(QResizeEvent* event) override;
+
+private:
+  void invalidateCache();
+  void renderCache();
+
+  AudioPeaksBuilder* peaks_ = nullptr;
+  qint64 viewStartMs_ = 0;
+  qint64 viewSpanMs_ = 0;
+
+  QPixmap cache_;
+  bool cacheValid_ = false;
+};
@@ -20,21 +20,31 @@ ClipExporter::~ClipExporter() {
     cleanup();
 }
 
-QString ClipExporter::findFfmpeg() {
-    const QString fromPath = QStandardPaths::findExecutable(QStringLiteral("ffmpeg"));
+namespace {
+QString findFfmpegTool(const QString& name) {
+    const QString fromPath = QStandardPaths::findExecutable(name);
     if (!fromPath.isEmpty()) return fromPath;
 
-    const QStringList commonPaths = {
-        QStringLiteral("/opt/homebrew/bin/ffmpeg"),
-        QStringLiteral("/usr/local/bin/ffmpeg"),
-        QStringLiteral("/usr/bin/ffmpeg"),
+    const QStringList commonDirs = {
+        QStringLiteral("/opt/homebrew/bin"),
+        QStringLiteral("/usr/local/bin"),
+        QStringLiteral("/usr/bin"),
     };
-    for (const QString& candidate : commonPaths) {
+    for (const QString& dir : commonDirs) {
+        const QString candidate = dir + QLatin1Char('/') + name;
         if (QFile::exists(candidate)) return candidate;
     }
     return {};
 }
 
+// Used for mixed-angle exports when the main source's frame rate could not be read.
+const QString kFallbackFrameRate = QStringLiteral("30");
+} // namespace
+
+QString ClipExporter::findFfmpeg() { return findFfmpegTool(QStringLiteral("ffmpeg")); }
+
+QString ClipExporter::findFfprobe() { return findFfmpegTool(QStringLiteral("ffprobe")); }
+
 void ClipExporter::setSourceVideo(const QString& path) { sourceVideoPath_ = path; }
 void ClipExporter::setOutputPath(const QString& path) { outputPath_ = path; }
 void ClipExporter::setClips(const QVector<ClipSegment>& clips) { clips_ = clips; }
@@ -59,6 +69,11 @@ void ClipExporter::startExport() {
     cancelled_ = false;
     currentClipIndex_ = 0;
     tempClipPaths_.clear();
+    normalizeFrameSize_ = std::any_of(clips_.cbegin(), clips_.cend(), [this](const ClipSegment& clip) {
+        return !clip.sourcePath.isEmpty() && clip.sourcePath != sourceVideoPath_;
+    });
+    probedSources_.clear();
+    ffprobePath_ = normalizeFrameSize_ ? findFfprobe() : QString();
 
     cleanup();
     tempDir_ = new QTemporaryDir();
@@ -94,10 +109,14 @@ void ClipExporter::processNextClip() {
         return;
     }
 
+    const ClipSegment& clip = clips_.at(currentClipIndex_);
+    const QString clipSource = clip.sourcePath.isEmpty() ? sourceVideoPath_ : clip.sourcePath;
+    if (normalizeFrameSize_ && probeNextSource(clipSource)) return;  // resumes here once probed
+
     emit progressChanged(currentClipIndex_ + 1, clips_.size());
 
-    const ClipSegment& clip = clips_.at(currentClipIndex_);
-    const double startSeconds = clip.startMs / 1000.0;
+    const qint64 sourceStartMs = std::max<qint64>(0, clip.startMs + (clip.sourcePath.isEmpty() ? 0 : clip.sourceOffsetMs));
+    const double startSeconds = sourceStartMs / 1000.0;
     const double durationSeconds = clip.durationMs / 1000.0;
 
     const QString tempPath = tempDir_->filePath(
@@ -127,7 +146,7 @@ void ClipExporter::processNextClip() {
     QStringList arguments;
     arguments << QStringLiteral("-y")
               << QStringLiteral("-ss") << QString::number(startSeconds, 'f', 3)
-              << QStringLiteral("-i") << sourceVideoPath_;
+              << QStringLiteral("-i") << clipSource;
 
     if (includeBottomOverlay) {
         arguments << QStringLiteral("-loop") << QStringLiteral("1")
@@ -145,14 +164,33 @@ void ClipExporter::processNextClip() {
     const int brandingInput = includeBottomOverlay ? 2 : 1;
     const int firstScoreboardInput = brandingInput + 1;
 
+    // An angle without an audio track gets silence, so every clip has the same streams.
+    QString audioMap = QStringLiteral("0:a?");
+    if (normalizeFrameSize_ && !probedSources_.value(clipSource).hasAudio) {
+        arguments << QStringLiteral("-f") << QStringLiteral("lavfi")
+                  << QStringLiteral("-i") << QStringLiteral("anullsrc=channel_layout=stereo:sample_rate=48000");
+        audioMap = QStringLiteral("%1:a").arg(firstScoreboardInput + scoreboardCount);
+    }
+
+    // Mixed angles: letterbox every clip into 1080p at the main source's frame rate so the
+    // stream-copy concat stays valid.
     QString filterComplex;
+    QString baseVideo = QStringLiteral("[0:v]");
+    if (normalizeFrameSize_) {
+        QString frameRate = probedSources_.value(sourceVideoPath_).frameRate;
+        if (frameRate.isEmpty()) frameRate = kFallbackFrameRate;
+        filterComplex += QStringLiteral(
+            "[0:v]scale=1920:1080:force_original_aspect_ratio=decrease,"
+            "pad=1920:1080:(ow-iw)/2:(oh-ih)/2,setsar=1,fps=%1[base];").arg(frameRate);
+        baseVideo = QStringLiteral("[base]");
+    }
     if (includeBottomOverlay) {
         filterComplex += QStringLiteral(
-            "[0:v][1:v]overlay=24:main_h-overlay_h-72[ov];"
-            "[ov][%1:v]overlay=main_w-overlay_w-16:16").arg(brandingInput);
+            "%2[1:v]overlay=24:main_h-overlay_h-72[ov];"
+            "[ov][%1:v]overlay=main_w-overlay_w-16:16").arg(brandingInput).arg(baseVideo);
     } else {
         filterComplex += QStringLiteral(
-            "[0:v][%1:v]overlay=main_w-overlay_w-16:16").arg(brandingInput);
+            "%2[%1:v]overlay=main_w-overlay_w-16:16").arg(brandingInput).arg(baseVideo);
     }
 
     if (scoreboardCount == 0) {
@@ -204,14 +242,18 @@ void ClipExporter::processNextClip() {
 
     arguments << QStringLiteral("-filter_complex") << filterComplex
               << QStringLiteral("-map") << QStringLiteral("[v]")
-              << QStringLiteral("-map") << QStringLiteral("0:a?")
+              << QStringLiteral("-map") << audioMap
               << QStringLiteral("-t") << QString::number(durationSeconds, 'f', 3)
               << QStringLiteral("-c:v") << QStringLiteral("libx264")
               << QStringLiteral("-preset") << QStringLiteral("fast")
               << QStringLiteral("-crf") << QStringLiteral("23")
               << QStringLiteral("-c:a") << QStringLiteral("aac")
-              << QStringLiteral("-b:a") << QStringLiteral("128k")
-              << QStringLiteral("-movflags") << QStringLiteral("+faststart")
+              << QStringLiteral("-b:a") << QStringLiteral("128k");
+    if (normalizeFrameSize_) {
+        arguments << QStringLiteral("-ar") << QStringLiteral("48000")
+                  << QStringLiteral("-ac") << QStringLiteral("2");
+    }
+    arguments << QStringLiteral("-movflags") << QStringLiteral("+faststart")
               << tempPath;
 
     if (currentProcess_) {
@@ -225,6 +267,49 @@ void ClipExporter::processNextClip() {
     currentProcess_->start(ffmpegPath_, arguments);
 }
 
+bool ClipExporter::probeNextSource(const QString& clipSource) {
+    for (const QString& path : {sourceVideoPath_, clipSource}) {
+        if (probedSources_.contains(path)) continue;
+        if (ffprobePath_.isEmpty()) {
+            probedSources_.insert(path, {});
+            continue;
+        }
+
+        if (currentProcess_) {
+            currentProcess_->deleteLater();
+        }
+        currentProcess_ = new QProcess(this);
+        QProcess* process = currentProcess_;
+        connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this,
+                [this, process, path](int exitCode, QProcess::ExitStatus exitStatus) {
+            // A failed probe keeps the defaults: treated as having audio, frame rate unknown.
+            SourceStreams streams;
+            if (exitStatus == QProcess::NormalExit && exitCode == 0) {
+                streams.hasAudio = false;
+                const QStringList lines =
+                    QString::fromUtf8(process->readAllStandardOutput()).split(QLatin1Char('\n'), Qt::SkipEmptyParts);
+                for (const QString& line : lines) {
+                    const QStringList fields = line.trimmed().split(QLatin1Char(','));
+                    if (fields.value(0) == QLatin1String("audio")) {
+                        streams.hasAudio = true;
+                    } else if (fields.value(0) == QLatin1String("video") && streams.frameRate.isEmpty()
+                               && !fields.value(1).startsWith(QLatin1Char('0'))) {
+                        streams.frameRate = fields.value(1);
+                    }
+                }
+            }
+            probedSources_.insert(path, streams);
+            processNextClip();
+        });
+
+        process->start(ffprobePath_, {QStringLiteral("-v"), QStringLiteral("error"),
+                                      QStringLiteral("-show_entries"), QStringLiteral("stream=codec_type,avg_frame_rate"),
+                                      QStringLiteral("-of"), QStringLiteral("csv=p=0"), path});
+        return true;
+    }
+    return false;
+}
+
 void ClipExporter::onClipProcessFinished(int exitCode, QProcess::ExitStatus exitStatus) {
     if (cancelled_) {
         cleanup();
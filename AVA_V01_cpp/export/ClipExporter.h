@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QHash>
 #include <QObject>
 #include <QProcess>
 #include <QString>
@@ -29,6 +30,14 @@ struct ClipSegment {
     QString overlayText;
     QString secondaryOverlayText;
     QVector<TimedScoreboard> scoreboards;
+    QString sourcePath;          // camera angle to cut from; empty = the main source video
+    qint64 sourceOffsetMs = 0;   // angle time = master time + offset (startMs is in master time)
+};
+
+struct ExportAngle {
+    QString name;
+    QString sourcePath;
+    qint64 offsetMs = 0;
 };
 
 class ClipExporter final : public QObject {
@@ -47,6 +56,7 @@ public:
 
     bool isRunning() const;
     static QString findFfmpeg();
+    static QString findFfprobe();
 
 signals:
     void progressChanged(int currentClip, int totalClips);
@@ -58,6 +68,7 @@ private slots:
 
 private:
     void processNextClip();
+    bool probeNextSource(const QString& clipSource);
     void concatenateClips();
     void cleanup();
     static QString generateOverlayImage(const QString& primaryText,
@@ -78,4 +89,12 @@ private:
     QStringList tempClipPaths_;
     QString ffmpegPath_;
     QString brandingImagePath_;
+    bool normalizeFrameSize_ = false;   // clips come from several angles: concat needs one frame size
+
+    struct SourceStreams {
+        bool hasAudio = true;
+        QString frameRate;   // ffprobe avg_frame_rate, e.g. "30000/1001"; empty when unknown
+    };
+    QHash<QString, SourceStreams> probedSources_;   // filled before a source's first clip when normalizing
+    QString ffprobePath_;
 };
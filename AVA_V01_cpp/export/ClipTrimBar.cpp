@@ -29,6 +29,11 @@ void ClipTrimBar::setPlayheadMs(qint64 posMs) {
     update();
 }
 
+void ClipTrimBar::setSceneCuts(QVector<qint64> cutsMs) {
+    cutsMs_ = std::move(cutsMs);
+    update();
+}
+
 QSize ClipTrimBar::sizeHint() const {
     return {400, kTrackHeight + kLabelGap + kLabelRowHeight};
 }
@@ -65,6 +70,18 @@ QRect ClipTrimBar::outHandleRect() const {
     return {x - kHandleWidth / 2, 0, kHandleWidth, kTrackHeight};
 }
 
+qint64 ClipTrimBar::snapAwayFromCuts(qint64 ms, DragTarget target) const {
+    if (cutsMs_.isEmpty()) return ms;
+    const auto it = std::lower_bound(cutsMs_.cbegin(), cutsMs_.cend(), ms);
+    qint64 nearest = -1;
+    if (it != cutsMs_.cend()) nearest = *it;
+    if (it != cutsMs_.cbegin() && (nearest < 0 || ms - *(it - 1) < nearest - ms)) nearest = *(it - 1);
+    if (nearest < 0 || std::abs(msToX(ms) - msToX(nearest)) > kCutSnapPx) return ms;
+
+    // An in-point starts just after the cut, an out-point ends just before it.
+    return target == DragTarget::InPoint ? nearest + kCutClearanceMs : nearest - kCutClearanceMs;
+}
+
 QString ClipTrimBar::formatMs(qint64 ms) {
     if (ms < 0) ms = 0;
     const qint64 totalSeconds = ms / 1000;
@@ -107,6 +124,14 @@ void ClipTrimBar::paintEvent(QPaintEvent*) {
     painter.setBrush(QColor(147, 197, 253, 50));
     painter.drawRect(inX, 0, outX - inX, kTrackHeight);
 
+    // Shot cuts
+    painter.setPen(QPen(QColor(239, 68, 68, 160), 1));
+    const auto firstCut = std::lower_bound(cutsMs_.cbegin(), cutsMs_.cend(), windowStartMs_);
+    for (auto it = firstCut; it != cutsMs_.cend() && *it <= windowEndMs_; ++it) {
+        const int cutX = msToX(*it);
+        painter.drawLine(cutX, 0, cutX, kTrackHeight);
+    }
+
     // Tag position marker (thin dashed line)
     const int tagX = msToX(tagPositionMs_);
     painter.setPen(QPen(QColor(255, 200, 50, 180), 1, Qt::DashLine));
@@ -199,7 +224,8 @@ void ClipTrimBar::mouseMoveEvent(QMouseEvent* event) {
         return;
     }
 
-    const qint64 rawMs = xToMs(event->pos().x());
+    qint64 rawMs = xToMs(event->pos().x());
+    if (!(event->modifiers() & Qt::AltModifier)) rawMs = snapAwayFromCuts(rawMs, dragTarget_);
 
     if (dragTarget_ == DragTarget::InPoint) {
         const qint64 maxIn = outPointMs_ - kMinClipDurationMs;
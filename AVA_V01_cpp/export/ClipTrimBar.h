@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QVector>
 #include <QWidget>
 #include <QtGlobal>
 
@@ -12,6 +13,9 @@ public:
     void configure(qint64 tagMs, qint64 inMs, qint64 outMs,
                    qint64 windowStartMs, qint64 windowEndMs);
     void setPlayheadMs(qint64 posMs);
+    /// Shot cuts of the source (ascending). A handle dragged near one snaps to the side that keeps the
+    /// clip inside a single shot; holding Alt drags freely.
+    void setSceneCuts(QVector<qint64> cutsMs);
 
     qint64 inPointMs() const { return inPointMs_; }
     qint64 outPointMs() const { return outPointMs_; }
@@ -35,6 +39,7 @@ private:
     qint64 xToMs(int x) const;
     QRect inHandleRect() const;
     QRect outHandleRect() const;
+    qint64 snapAwayFromCuts(qint64 ms, DragTarget target) const;
     static QString formatMs(qint64 ms);
 
     qint64 windowStartMs_ = 0;
@@ -43,6 +48,7 @@ private:
     qint64 inPointMs_ = 0;
     qint64 outPointMs_ = 0;
     qint64 playheadMs_ = 0;
+    QVector<qint64> cutsMs_;
 
     DragTarget dragTarget_ = DragTarget::None;
 
@@ -52,4 +58,6 @@ private:
     static constexpr int kLabelRowHeight = 18;
     static constexpr int kLabelGap = 4;
     static constexpr qint64 kMinClipDurationMs = 500;
+    static constexpr int kCutSnapPx = 8;
+    static constexpr qint64 kCutClearanceMs = 200;
 };
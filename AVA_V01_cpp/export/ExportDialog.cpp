@@ -45,6 +45,20 @@ QString eventLabelForExportSuggestedFileName(const QString& canonicalEvent) {
     }
     return AppLocale::trEvent(canonicalEvent);
 }
+
+QString formatDurationMs(qint64 ms) {
+    const qint64 totalSeconds = std::max<qint64>(0, ms) / 1000;
+    const qint64 hours = totalSeconds / 3600;
+    const qint64 minutes = (totalSeconds / 60) % 60;
+    const qint64 seconds = totalSeconds % 60;
+    if (hours > 0) {
+        return QStringLiteral("%1:%2:%3")
+            .arg(hours)
+            .arg(minutes, 2, 10, QChar('0'))
+            .arg(seconds, 2, 10, QChar('0'));
+    }
+    return QStringLiteral("%1:%2").arg(minutes, 2, 10, QChar('0')).arg(seconds, 2, 10, QChar('0'));
+}
 } // namespace
 
 ExportDialog::ExportDialog(TagSession* session,
@@ -76,6 +90,32 @@ ExportDialog::ExportDialog(TagSession* session,
     updateClipCount();
 }
 
+void ExportDialog::setSceneAnalysis(const SceneAnalysis& analysis) {
+    sceneAnalysis_ = analysis;
+    if (clipTrimBar_) clipTrimBar_->setSceneCuts(sceneAnalysis_.cutsMs);
+    updateModeControls();
+    updateClipCount();
+}
+
+void ExportDialog::setAudioEvents(const QVector<AudioEvent>& events) {
+    audioEvents_ = events;
+    updateModeControls();
+    updateClipCount();
+}
+
+void ExportDialog::setCameraAngles(const QVector<ExportAngle>& angles) {
+    cameraAngles_ = angles;
+    if (!angleCombo_) return;
+    angleCombo_->clear();
+    angleCombo_->addItem(AppLocale::trUi("export.angle_main"));
+    for (const ExportAngle& angle : cameraAngles_) {
+        angleCombo_->addItem(angle.name);
+    }
+    const bool hasAngles = !cameraAngles_.isEmpty();
+    angleLabel_->setVisible(hasAngles);
+    angleCombo_->setVisible(hasAngles);
+}
+
 ExportDialog::~ExportDialog() {
     detachTrimPageKeyboardShortcuts();
     stopPreviewPlayer();
@@ -106,6 +146,14 @@ void ExportDialog::buildSettingsPage() {
     formLayout->setSpacing(10);
     formLayout->setFieldGrowthPolicy(QFormLayout::ExpandingFieldsGrow);
 
+    exportModeCombo_ = new QComboBox(settingsPage_);
+    exportModeCombo_->setMinimumWidth(200);
+    exportModeCombo_->addItem(AppLocale::trUi("export.mode_clips"), QStringLiteral("clips"));
+    exportModeCombo_->addItem(AppLocale::trUi("export.mode_condensed"), QStringLiteral("condensed"));
+    connect(exportModeCombo_, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &ExportDialog::onExportModeChanged);
+    formLayout->addRow(AppLocale::trUi("export.mode"), exportModeCombo_);
+
     eventTypeCombo_ = new QComboBox(settingsPage_);
     eventTypeCombo_->setMinimumWidth(200);
     connect(eventTypeCombo_, QOverload<int>::of(&QComboBox::currentIndexChanged),
@@ -163,6 +211,16 @@ void ExportDialog::buildSettingsPage() {
     includeScoreboardOverlayCheckBox_->setChecked(true);
     formLayout->addRow(QString(), includeScoreboardOverlayCheckBox_);
 
+    useWhistleCuesCheckBox_ =
+        new QCheckBox(AppLocale::trUi("export.use_whistle_cues"), settingsPage_);
+    useWhistleCuesCheckBox_->setCursor(Qt::PointingHandCursor);
+    useWhistleCuesCheckBox_->setChecked(true);
+    useWhistleCuesCheckBox_->hide();
+    connect(useWhistleCuesCheckBox_, &QCheckBox::toggled, this, [this](bool) {
+        updateClipCount();
+    });
+    formLayout->addRow(QString(), useWhistleCuesCheckBox_);
+
     clipCountLabel_ = new QLabel(settingsPage_);
     Style::setRole(clipCountLabel_, "muted");
     formLayout->addRow(QString(), clipCountLabel_);
@@ -286,6 +344,7 @@ void ExportDialog::buildTrimPage() {
 
     // Trim bar
     clipTrimBar_ = new ClipTrimBar(trimPage_);
+    clipTrimBar_->setSceneCuts(sceneAnalysis_.cutsMs);
     connect(clipTrimBar_, &ClipTrimBar::seekRequested,
             this, &ExportDialog::onTrimSeekRequested);
     connect(clipTrimBar_, &ClipTrimBar::inPointChanged, this, [this](qint64) {
@@ -314,6 +373,17 @@ void ExportDialog::buildTrimPage() {
             noteLineEdit_, &QLineEdit::setEnabled);
 
     layout->addLayout(noteRow);
+
+    // Camera angle row (only shown when extra angles are synced)
+    auto* angleRow = new QHBoxLayout();
+    angleRow->setSpacing(8);
+    angleLabel_ = new QLabel(AppLocale::trUi("export.angle"), trimPage_);
+    angleRow->addWidget(angleLabel_);
+    angleCombo_ = new QComboBox(trimPage_);
+    angleRow->addWidget(angleCombo_, 1);
+    layout->addLayout(angleRow);
+    angleLabel_->hide();
+    angleCombo_->hide();
     layout->addSpacing(4);
 
     // Progress
@@ -367,20 +437,61 @@ void ExportDialog::populateEventTypes() {
     eventTypeCombo_->clear();
     if (!tagSession_) return;
 
-    const auto& counts = tagSession_->mainEventCounts();
-    QStringList eventTypes = counts.keys();
-    eventTypes.sort(Qt::CaseInsensitive);
+    const QHash<TagSymbol, int> counts = tagSession_->aggregates().mainEventCounts();
+    QList<TagSymbol> eventTypes = counts.keys();
+    std::sort(eventTypes.begin(), eventTypes.end(), [](const TagSymbol& a, const TagSymbol& b) {
+        return a.text().compare(b.text(), Qt::CaseInsensitive) < 0;
+    });
 
-    for (const QString& eventType : eventTypes) {
+    for (const TagSymbol& eventType : std::as_const(eventTypes)) {
         const int count = counts.value(eventType, 0);
         if (count <= 0) continue;
         const QString displayText = QStringLiteral("%1  (%2)")
             .arg(AppLocale::trEvent(eventType))
             .arg(count);
-        eventTypeCombo_->addItem(displayText, eventType);
+        eventTypeCombo_->addItem(displayText, eventType.text());
+    }
+}
+
+void ExportDialog::onExportModeChanged(int /*index*/) {
+    updateModeControls();
+    updateClipCount();
+}
+
+bool ExportDialog::isCondensedMode() const {
+    return exportModeCombo_
+        && exportModeCombo_->currentData().toString() == QStringLiteral("condensed");
+}
+
+void ExportDialog::updateModeControls() {
+    // The condensed game is one continuous video: no event filter, per-clip overlay or tag padding.
+    const bool condensed = isCondensedMode();
+    for (QWidget* clipOnly : {static_cast<QWidget*>(eventTypeCombo_), static_cast<QWidget*>(teamFilterCombo_),
+                              static_cast<QWidget*>(sortOrderCombo_),
+                              static_cast<QWidget*>(includeBottomOverlayCheckBox_),
+                              static_cast<QWidget*>(beforePaddingSpin_), static_cast<QWidget*>(afterPaddingSpin_)}) {
+        if (clipOnly) clipOnly->setEnabled(!condensed);
+    }
+    if (useWhistleCuesCheckBox_) {
+        const bool hasWhistles = std::any_of(audioEvents_.cbegin(), audioEvents_.cend(), [](const AudioEvent& e) {
+            return e.kind == AudioEvent::Kind::Whistle;
+        });
+        useWhistleCuesCheckBox_->setVisible(condensed);
+        useWhistleCuesCheckBox_->setEnabled(hasWhistles);
     }
 }
 
+QVector<PlaySegment> ExportDialog::computePlaySegments() const {
+    QVector<qint64> anchorsMs;
+    if (tagSession_) {
+        anchorsMs.reserve(tagSession_->tags().size());
+        for (const auto& tag : tagSession_->tags()) anchorsMs.append(tag.positionMs);
+    }
+    const bool useWhistles = useWhistleCuesCheckBox_
+        && useWhistleCuesCheckBox_->isEnabled() && useWhistleCuesCheckBox_->isChecked();
+    return PlaySegment::detect(sceneAnalysis_, useWhistles ? audioEvents_ : QVector<AudioEvent>(), anchorsMs);
+}
+
 void ExportDialog::onEventTypeChanged(int /*index*/) {
     updateClipCount();
 }
@@ -400,6 +511,22 @@ void ExportDialog::updateSortOrderVisibility() {
 void ExportDialog::updateClipCount() {
     if (!clipCountLabel_ || !tagSession_ || !eventTypeCombo_) return;
 
+    if (isCondensedMode()) {
+        const QVector<PlaySegment> segments = computePlaySegments();
+        if (sceneAnalysis_.isEmpty()) {
+            clipCountLabel_->setText(AppLocale::trUi("export.condensed_unavailable"));
+        } else {
+            clipCountLabel_->setText(QStringLiteral("%1 %2  \u00b7  %3 / %4")
+                .arg(segments.size())
+                .arg(AppLocale::trUi("export.segments_label"))
+                .arg(formatDurationMs(PlaySegment::totalDurationMs(segments)))
+                .arg(formatDurationMs(sceneAnalysis_.durationMs())));
+        }
+        if (reviewButton_) reviewButton_->setEnabled(!segments.isEmpty());
+        refreshOutputPathIfFollowingForm();
+        return;
+    }
+
     const QString canonicalEvent = eventTypeCombo_->currentData().toString();
     if (canonicalEvent.isEmpty()) {
         clipCountLabel_->setText(QString());
@@ -412,10 +539,12 @@ void ExportDialog::updateClipCount() {
         ? teamFilterCombo_->currentData().toString()
         : QString();
 
+    const TagSymbol eventSymbol(canonicalEvent);
+    const TagSymbol teamSymbol(teamFilter);
     int count = 0;
     for (const auto& tag : tagSession_->tags()) {
-        if (tag.mainEvent != canonicalEvent) continue;
-        if (!teamFilter.isEmpty() && tag.team != teamFilter) continue;
+        if (tag.mainEvent != eventSymbol) continue;
+        if (!teamSymbol.isEmpty() && tag.team != teamSymbol) continue;
         ++count;
     }
 
@@ -448,7 +577,7 @@ void ExportDialog::onBrowseOutputPath() {
 
 void ExportDialog::onReviewClipsClicked() {
     const QString canonicalEvent = eventTypeCombo_->currentData().toString();
-    if (canonicalEvent.isEmpty()) return;
+    if (canonicalEvent.isEmpty() && !isCondensedMode()) return;
 
     buildTrimDataFromSettings();
     if (trimData_.isEmpty()) return;
@@ -479,32 +608,29 @@ void ExportDialog::buildTrimDataFromSettings() {
         ? static_cast<AppLocale::Language>(exportLanguageCombo_->currentData().toInt())
         : AppLocale::currentLanguage();
 
-    struct TagWithIndex {
-        TagSession::GameTag tag;
-        int originalIndex;
-    };
-    QVector<TagWithIndex> matchingTags;
-    const auto& allTags = tagSession_->tags();
-    for (int i = 0; i < allTags.size(); ++i) {
-        if (allTags[i].mainEvent != canonicalEvent) continue;
-        if (!teamFilter.isEmpty() && allTags[i].team != teamFilter) continue;
-        matchingTags.append({allTags[i], i});
+    if (isCondensedMode()) {
+        buildCondensedTrimData();
+        return;
+    }
+
+    // Collected in the session's time order, so grouping by team is a stable sort on the team alone.
+    QVector<TagSession::GameTag> matchingTags;
+    const TagSymbol eventSymbol(canonicalEvent);
+    const TagSymbol teamSymbol(teamFilter);
+    for (const TagSession::TagId id : tagSession_->tagIdsByTime()) {
+        const auto& tag = *tagSession_->tag(id);
+        if (tag.mainEvent != eventSymbol) continue;
+        if (!teamSymbol.isEmpty() && tag.team != teamSymbol) continue;
+        matchingTags.append(tag);
     }
 
     if (sortByTeamFirst) {
-        std::sort(matchingTags.begin(), matchingTags.end(),
-                  [](const TagWithIndex& a, const TagWithIndex& b) {
-            if (a.tag.team != b.tag.team) {
-                if (a.tag.team == QStringLiteral("Home")) return true;
-                if (b.tag.team == QStringLiteral("Home")) return false;
-                return a.tag.team < b.tag.team;
-            }
-            return a.tag.positionMs < b.tag.positionMs;
-        });
-    } else {
-        std::sort(matchingTags.begin(), matchingTags.end(),
-                  [](const TagWithIndex& a, const TagWithIndex& b) {
-            return a.tag.positionMs < b.tag.positionMs;
+        std::stable_sort(matchingTags.begin(), matchingTags.end(),
+                         [](const TagSession::GameTag& a, const TagSession::GameTag& b) {
+            if (a.team == b.team) return false;
+            if (a.team == TagVocabulary::home()) return true;
+            if (b.team == TagVocabulary::home()) return false;
+            return a.team.text() < b.team.text();
         });
     }
 
@@ -516,23 +642,34 @@ void ExportDialog::buildTrimDataFromSettings() {
 
     trimData_.reserve(totalClips);
     for (int i = 0; i < totalClips; ++i) {
-        const auto& entry = matchingTags[i];
-        qint64 clipStart = static_cast<qint64>(entry.tag.positionMs - beforePaddingMs);
-        qint64 clipEnd = static_cast<qint64>(entry.tag.positionMs + afterPaddingMs);
+        const auto& tag = matchingTags[i];
+        qint64 clipStart = static_cast<qint64>(tag.positionMs - beforePaddingMs);
+        qint64 clipEnd = static_cast<qint64>(tag.positionMs + afterPaddingMs);
 
         if (clipStart < 0) clipStart = 0;
         if (videoDurationMs_ > 0 && clipEnd > videoDurationMs_) clipEnd = videoDurationMs_;
         if (clipEnd <= clipStart) clipEnd = clipStart + 1000;
 
-        const QString teamName = teamDisplayName(entry.tag.team);
+        const QString teamName = teamDisplayName(tag.team);
         const QString overlayText = QStringLiteral("%1 - %2  %3 / %4")
             .arg(teamName, translatedEvent_)
             .arg(i + 1)
             .arg(totalClips);
 
-        const bool hasNote = !entry.tag.note.trimmed().isEmpty();
-        trimData_.append({entry.tag, clipStart, clipEnd, overlayText,
-                          hasNote, entry.tag.note.trimmed()});
+        const bool hasNote = !tag.note.trimmed().isEmpty();
+        trimData_.append({tag, clipStart, clipEnd, overlayText,
+                          hasNote, tag.note.trimmed()});
+    }
+}
+
+void ExportDialog::buildCondensedTrimData() {
+    // Every play segment is one reviewable clip; ClipExporter joins them into the condensed game.
+    const QVector<PlaySegment> segments = computePlaySegments();
+    trimData_.reserve(segments.size());
+    for (const PlaySegment& segment : segments) {
+        TagSession::GameTag segmentStart;
+        segmentStart.positionMs = segment.startMs;
+        trimData_.append({segmentStart, segment.startMs, segment.endMs, QString(), false, QString()});
     }
 }
 
@@ -677,6 +814,9 @@ void ExportDialog::showClipAtIndex(int index) {
 
     qint64 windowStart = clip.tag.positionMs - halfWindow;
     qint64 windowEnd = clip.tag.positionMs + halfWindow;
+    // Condensed-game segments can outlast the tag-centered window.
+    windowStart = std::min(windowStart, clip.startMs - 5000);
+    windowEnd = std::max(windowEnd, clip.endMs + 5000);
     if (windowStart < 0) windowStart = 0;
     if (videoDurationMs_ > 0 && windowEnd > videoDurationMs_)
         windowEnd = videoDurationMs_;
@@ -699,6 +839,9 @@ void ExportDialog::showClipAtIndex(int index) {
         noteLineEdit_->setText(clip.secondaryOverlayText);
         noteLineEdit_->setEnabled(clip.includeSecondaryOverlay);
     }
+    if (angleCombo_ && !cameraAngles_.isEmpty()) {
+        angleCombo_->setCurrentIndex(clip.angleIndex + 1);
+    }
 
     updateClipNavigation();
 }
@@ -717,6 +860,9 @@ void ExportDialog::saveTrimForCurrentClip() {
         trimData_[currentTrimIndex_].secondaryOverlayText =
             noteLineEdit_->text().trimmed();
     }
+    if (angleCombo_ && !cameraAngles_.isEmpty()) {
+        trimData_[currentTrimIndex_].angleIndex = angleCombo_->currentIndex() - 1;
+    }
 }
 
 void ExportDialog::onPrevClipClicked() {
@@ -815,6 +961,10 @@ QString ExportDialog::suggestedExportBaseName() const {
         sanitizedExportFileNamePart(teamDisplayName(QStringLiteral("Home")));
     const QString awaySegment =
         sanitizedExportFileNamePart(teamDisplayName(QStringLiteral("Away")));
+    if (isCondensedMode()) {
+        return QStringLiteral("%1 vs %2 - %3").arg(homeSegment, awaySegment,
+            sanitizedExportFileNamePart(AppLocale::trUi("export.condensed_file_name")));
+    }
     const QString canonicalEvent =
         eventTypeCombo_ ? eventTypeCombo_->currentData().toString() : QString();
     const QString eventSegment = canonicalEvent.isEmpty()
@@ -851,7 +1001,7 @@ void ExportDialog::refreshOutputPathIfFollowingForm() {
         eventTypeCombo_ ? eventTypeCombo_->currentData().toString() : QString();
     const QString currentPath = outputPathEdit_->text();
 
-    if (canonicalEvent.isEmpty()) {
+    if (canonicalEvent.isEmpty() && !isCondensedMode()) {
         if (currentPath.trimmed().isEmpty() || currentPath == lastAutoOutputPathSuggestion_) {
             QSignalBlocker blocker(outputPathEdit_);
             outputPathEdit_->clear();
@@ -895,8 +1045,8 @@ void ExportDialog::onExportClicked() {
     const QString homeColorHex = tagSession_ ? tagSession_->homeTeamColor() : QString();
     const QString awayColorHex = tagSession_ ? tagSession_->awayTeamColor() : QString();
 
-    const QVector<TagSession::GameTag> emptyTags;
-    const auto& allTags = tagSession_ ? tagSession_->tags() : emptyTags;
+    const GameStateTimeline emptyGameState;
+    const GameStateTimeline& gameState = tagSession_ ? tagSession_->gameState() : emptyGameState;
 
     QVector<ClipSegment> clips;
     clips.reserve(trimData_.size());
@@ -913,40 +1063,19 @@ void ExportDialog::onExportClicked() {
 
         QVector<TimedScoreboard> scoreboardPhases;
         if (includeScoreboardOverlay) {
-            int initialHomeGoals = 0;
-            int initialAwayGoals = 0;
-            struct InClipGoal {
-                qint64 positionMs;
-                QString team;
-            };
-            QVector<InClipGoal> inClipGoals;
-
-            for (const auto& tag : allTags) {
-                if (tag.mainEvent != QStringLiteral("Goal")) continue;
-                if (tag.positionMs <= td.startMs) {
-                    if (tag.team == QStringLiteral("Home")) ++initialHomeGoals;
-                    else if (tag.team == QStringLiteral("Away")) ++initialAwayGoals;
-                } else if (tag.positionMs <= td.endMs) {
-                    inClipGoals.append({tag.positionMs, tag.team});
-                }
-            }
-
-            std::sort(inClipGoals.begin(), inClipGoals.end(),
-                      [](const InClipGoal& a, const InClipGoal& b) {
-                return a.positionMs < b.positionMs;
-            });
-
+            // Score at the clip start plus every change inside it, each an O(log n) lookup.
+            const GameState initial = gameState.stateAt(td.startMs);
             scoreboardPhases.append({0.0, {homeName, awayName,
-                                           initialHomeGoals, initialAwayGoals,
+                                           initial.home.goals, initial.away.goals,
                                            homeColorHex, awayColorHex}});
 
-            int runningHome = initialHomeGoals;
-            int runningAway = initialAwayGoals;
-            for (const auto& goal : inClipGoals) {
-                if (goal.team == QStringLiteral("Home")) ++runningHome;
-                else if (goal.team == QStringLiteral("Away")) ++runningAway;
+            for (const GameStateChange& change : gameState.changesInRange(td.startMs, td.endMs)) {
+                const int runningHome = change.state.home.goals;
+                const int runningAway = change.state.away.goals;
+                const auto& shown = scoreboardPhases.constLast().scoreboard;
+                if (runningHome == shown.homeGoals && runningAway == shown.awayGoals) continue;  // cards, PCs
 
-                const double offsetSeconds = (goal.positionMs - td.startMs) / 1000.0;
+                const double offsetSeconds = (change.positionMs - td.startMs) / 1000.0;
                 if (scoreboardPhases.last().activationOffsetSeconds == offsetSeconds) {
                     scoreboardPhases.last().scoreboard.homeGoals = runningHome;
                     scoreboardPhases.last().scoreboard.awayGoals = runningAway;
@@ -958,8 +1087,13 @@ void ExportDialog::onExportClicked() {
             }
         }
 
-        clips.append({td.startMs, td.endMs - td.startMs, primary,
-                      secondaryText, scoreboardPhases});
+        ClipSegment segment{td.startMs, td.endMs - td.startMs, primary,
+                            secondaryText, scoreboardPhases};
+        if (td.angleIndex >= 0 && td.angleIndex < cameraAngles_.size()) {
+            segment.sourcePath = cameraAngles_.at(td.angleIndex).sourcePath;
+            segment.sourceOffsetMs = cameraAngles_.at(td.angleIndex).offsetMs;
+        }
+        clips.append(segment);
     }
 
     if (exporter_) {
@@ -6,6 +6,10 @@
 #include <QtGlobal>
 
 #include "AppLocale.h"
+#include "AudioEvents.h"
+#include "ClipExporter.h"
+#include "PlaySegments.h"
+#include "SceneAnalysis.h"
 #include "TagSession.h"
 
 class QAudioOutput;
@@ -35,7 +39,16 @@ public:
                           QWidget* parent = nullptr);
     ~ExportDialog() override;
 
+    /// Extra camera angles offered per clip on the trim page (the main source is always the first choice).
+    void setCameraAngles(const QVector<ExportAngle>& angles);
+
+    /// Scene analysis of the main source: cuts for the trim bar and the motion curve for the condensed game.
+    void setSceneAnalysis(const SceneAnalysis& analysis);
+    /// Detected audio events of the main source; whistles place condensed-game segment edges.
+    void setAudioEvents(const QVector<AudioEvent>& events);
+
 private slots:
+    void onExportModeChanged(int index);
     void onEventTypeChanged(int index);
     void onTeamFilterChanged(int index);
     void onBrowseOutputPath();
@@ -67,6 +80,7 @@ private:
         QString overlayText;
         bool includeSecondaryOverlay = false;
         QString secondaryOverlayText;
+        int angleIndex = -1;   // -1 = main source, else index into cameraAngles_
     };
 
     void buildSettingsPage();
@@ -74,9 +88,13 @@ private:
     void populateEventTypes();
     void updateClipCount();
     void updateSortOrderVisibility();
+    void updateModeControls();
+    bool isCondensedMode() const;
+    QVector<PlaySegment> computePlaySegments() const;
     void setExporting(bool exporting);
 
     void buildTrimDataFromSettings();
+    void buildCondensedTrimData();
     void saveTrimForCurrentClip();
     void showClipAtIndex(int index);
     void updateClipNavigation();
@@ -97,6 +115,9 @@ private:
     TagSession* tagSession_;
     QString sourceVideoPath_;
     qint64 videoDurationMs_;
+    QVector<ExportAngle> cameraAngles_;
+    SceneAnalysis sceneAnalysis_;
+    QVector<AudioEvent> audioEvents_;
 
     // Pages
     QStackedWidget* pagesStack_ = nullptr;
@@ -104,6 +125,7 @@ private:
     QWidget* trimPage_ = nullptr;
 
     // Settings page widgets
+    QComboBox* exportModeCombo_ = nullptr;
     QComboBox* eventTypeCombo_ = nullptr;
     QComboBox* teamFilterCombo_ = nullptr;
     QLabel* sortOrderLabel_ = nullptr;
@@ -111,6 +133,7 @@ private:
     QComboBox* exportLanguageCombo_ = nullptr;
     QCheckBox* includeBottomOverlayCheckBox_ = nullptr;
     QCheckBox* includeScoreboardOverlayCheckBox_ = nullptr;
+    QCheckBox* useWhistleCuesCheckBox_ = nullptr;
     QLabel* clipCountLabel_ = nullptr;
     QDoubleSpinBox* beforePaddingSpin_ = nullptr;
     QDoubleSpinBox* afterPaddingSpin_ = nullptr;
@@ -131,6 +154,8 @@ private:
     ClipTrimBar* clipTrimBar_ = nullptr;
     QCheckBox* includeNoteCheckBox_ = nullptr;
     QLineEdit* noteLineEdit_ = nullptr;
+    QLabel* angleLabel_ = nullptr;
+    QComboBox* angleCombo_ = nullptr;
     QProgressBar* progressBar_ = nullptr;
     QLabel* progressLabel_ = nullptr;
     QPushButton* backButton_ = nullptr;
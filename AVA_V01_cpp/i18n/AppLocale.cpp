@@ -26,6 +26,10 @@ const QHash<QString, QString>& spanishEventMap() {
       {QStringLiteral("Card"), QStringLiteral("Tarjeta")},
       {QStringLiteral("PC Foul"), QStringLiteral("Falta PC")},
 
+      // Accepted audio suggestions
+      {QStringLiteral("Whistle"), QStringLiteral("Silbato")},
+      {QStringLiteral("Crowd"), QStringLiteral("Tribuna")},
+
       // First-level follow-ups
       {QStringLiteral("On target"), QStringLiteral("Al arco")},
       {QStringLiteral("Off target"), QStringLiteral("Afuera")},
@@ -209,7 +213,9 @@ QString trUi(const char* key) {
         {QStringLiteral("tags.filter"), QStringLiteral("Filter")},
         {QStringLiteral("tags.remove_filters"), QStringLiteral("Remove filters")},
         {QStringLiteral("tags.undo"), QStringLiteral("Undo")},
-        {QStringLiteral("tags.undo_tooltip"), QStringLiteral("Ctrl+Z  Remove most recent tag")},
+        {QStringLiteral("tags.undo_tooltip"), QStringLiteral("Ctrl+Z  Undo the last tag edit")},
+        {QStringLiteral("tags.redo"), QStringLiteral("Redo")},
+        {QStringLiteral("tags.redo_tooltip"), QStringLiteral("Ctrl+Shift+Z  Redo the last undone edit")},
         {QStringLiteral("tags.note_placeholder"), QStringLiteral("Note for selected tag…")},
         {QStringLiteral("tags.col_time"), QStringLiteral("Time")},
         {QStringLiteral("tags.col_team"), QStringLiteral("Team")},
@@ -244,6 +250,20 @@ QString trUi(const char* key) {
         {QStringLiteral("vc.tt.faster"), QStringLiteral("+  Faster")},
         {QStringLiteral("vc.tt.reset"), QStringLiteral("}  Reset speed")},
         {QStringLiteral("menu.export_clips"), QStringLiteral("Export clips…")},
+        {QStringLiteral("menu.proxy_idle"), QStringLiteral("Playback proxy: not needed")},
+        {QStringLiteral("menu.proxy_building"), QStringLiteral("Building playback proxy… %1%")},
+        {QStringLiteral("menu.proxy_ready"), QStringLiteral("Playback proxy ready")},
+        {QStringLiteral("menu.proxy_active"), QStringLiteral("Playing from low-res proxy")},
+        {QStringLiteral("menu.proxy_failed"), QStringLiteral("Playback proxy unavailable")},
+        {QStringLiteral("menu.proxy_cache"), QStringLiteral("%1  ·  cache %2 MB")},
+        {QStringLiteral("menu.add_angle"), QStringLiteral("Add camera angle…")},
+        {QStringLiteral("menu.angles"), QStringLiteral("Camera angles")},
+        {QStringLiteral("menu.angle_name"), QStringLiteral("Angle %1")},
+        {QStringLiteral("menu.angle_show"), QStringLiteral("Show %1")},
+        {QStringLiteral("menu.angle_offset"), QStringLiteral("Offset for %1…")},
+        {QStringLiteral("menu.angle_offset_prompt"),
+         QStringLiteral("Seconds to add to the main video time to get the time in %1:")},
+        {QStringLiteral("menu.remove_angles"), QStringLiteral("Remove all camera angles")},
         {QStringLiteral("export.title"), QStringLiteral("Export Clips")},
         {QStringLiteral("export.subtitle"), QStringLiteral("Create a video compilation of all clips for a selected event type.")},
         {QStringLiteral("export.event_type"), QStringLiteral("Event type:")},
@@ -258,6 +278,13 @@ QString trUi(const char* key) {
         {QStringLiteral("export.overlay_language"), QStringLiteral("Overlay language:")},
         {QStringLiteral("export.include_bottom_overlay"), QStringLiteral("Include bottom tag overlay")},
         {QStringLiteral("export.include_scoreboard_overlay"), QStringLiteral("Include scoreboard overlay")},
+        {QStringLiteral("export.mode"), QStringLiteral("Export:")},
+        {QStringLiteral("export.mode_clips"), QStringLiteral("Tagged clips")},
+        {QStringLiteral("export.mode_condensed"), QStringLiteral("Condensed game (ball in play)")},
+        {QStringLiteral("export.use_whistle_cues"), QStringLiteral("Use detected whistles to place segment edges")},
+        {QStringLiteral("export.segments_label"), QStringLiteral("play segments")},
+        {QStringLiteral("export.condensed_unavailable"), QStringLiteral("Scene analysis for this video is still running…")},
+        {QStringLiteral("export.condensed_file_name"), QStringLiteral("condensed game")},
         {QStringLiteral("export.before_tag"), QStringLiteral("Before tag:")},
         {QStringLiteral("export.after_tag"), QStringLiteral("After tag:")},
         {QStringLiteral("export.save_to"), QStringLiteral("Save to:")},
@@ -274,6 +301,8 @@ QString trUi(const char* key) {
         {QStringLiteral("export.all_clips_discarded"), QStringLiteral("All clips have been discarded.")},
         {QStringLiteral("export.include_note"), QStringLiteral("Include note in overlay")},
         {QStringLiteral("export.note_placeholder"), QStringLiteral("Note text\u2026")},
+        {QStringLiteral("export.angle"), QStringLiteral("Camera:")},
+        {QStringLiteral("export.angle_main"), QStringLiteral("Main camera")},
         {QStringLiteral("export.starting"), QStringLiteral("Starting export…")},
         {QStringLiteral("export.progress_prefix"), QStringLiteral("Exporting clip")},
         {QStringLiteral("export.done"), QStringLiteral("Export complete.")},
@@ -324,7 +353,9 @@ QString trUi(const char* key) {
       {QStringLiteral("tags.filter"), QStringLiteral("Filtrar")},
       {QStringLiteral("tags.remove_filters"), QStringLiteral("Quitar filtros")},
       {QStringLiteral("tags.undo"), QStringLiteral("Deshacer")},
-      {QStringLiteral("tags.undo_tooltip"), QStringLiteral("Ctrl+Z  Quitar la última marca")},
+      {QStringLiteral("tags.undo_tooltip"), QStringLiteral("Ctrl+Z  Deshacer la última edición de marcas")},
+      {QStringLiteral("tags.redo"), QStringLiteral("Rehacer")},
+      {QStringLiteral("tags.redo_tooltip"), QStringLiteral("Ctrl+Shift+Z  Rehacer la última edición deshecha")},
       {QStringLiteral("tags.note_placeholder"), QStringLiteral("Nota de la marca seleccionada…")},
       {QStringLiteral("tags.col_time"), QStringLiteral("Tiempo")},
       {QStringLiteral("tags.col_team"), QStringLiteral("Equipo")},
@@ -359,6 +390,20 @@ QString trUi(const char* key) {
         {QStringLiteral("vc.tt.faster"), QStringLiteral("+  Más rápido")},
         {QStringLiteral("vc.tt.reset"), QStringLiteral("}  Restablecer velocidad")},
       {QStringLiteral("menu.export_clips"), QStringLiteral("Exportar clips…")},
+      {QStringLiteral("menu.proxy_idle"), QStringLiteral("Proxy de reproducción: no necesario")},
+      {QStringLiteral("menu.proxy_building"), QStringLiteral("Generando proxy de reproducción… %1%")},
+      {QStringLiteral("menu.proxy_ready"), QStringLiteral("Proxy de reproducción listo")},
+      {QStringLiteral("menu.proxy_active"), QStringLiteral("Reproduciendo desde proxy de baja resolución")},
+      {QStringLiteral("menu.proxy_failed"), QStringLiteral("Proxy de reproducción no disponible")},
+      {QStringLiteral("menu.proxy_cache"), QStringLiteral("%1  ·  caché %2 MB")},
+      {QStringLiteral("menu.add_angle"), QStringLiteral("Añadir ángulo de cámara…")},
+      {QStringLiteral("menu.angles"), QStringLiteral("Ángulos de cámara")},
+      {QStringLiteral("menu.angle_name"), QStringLiteral("Ángulo %1")},
+      {QStringLiteral("menu.angle_show"), QStringLiteral("Mostrar %1")},
+      {QStringLiteral("menu.angle_offset"), QStringLiteral("Desfase de %1…")},
+      {QStringLiteral("menu.angle_offset_prompt"),
+       QStringLiteral("Segundos a sumar al tiempo del video principal para obtener el tiempo en %1:")},
+      {QStringLiteral("menu.remove_angles"), QStringLiteral("Quitar todos los ángulos de cámara")},
       {QStringLiteral("export.title"), QStringLiteral("Exportar clips")},
       {QStringLiteral("export.subtitle"), QStringLiteral("Crear un video con todos los clips de un tipo de evento seleccionado.")},
       {QStringLiteral("export.event_type"), QStringLiteral("Tipo de evento:")},
@@ -373,6 +418,13 @@ QString trUi(const char* key) {
       {QStringLiteral("export.overlay_language"), QStringLiteral("Idioma del overlay:")},
         {QStringLiteral("export.include_bottom_overlay"), QStringLiteral("Incluir overlay de etiqueta inferior")},
         {QStringLiteral("export.include_scoreboard_overlay"), QStringLiteral("Incluir overlay de marcador")},
+        {QStringLiteral("export.mode"), QStringLiteral("Exportar:")},
+        {QStringLiteral("export.mode_clips"), QStringLiteral("Clips etiquetados")},
+        {QStringLiteral("export.mode_condensed"), QStringLiteral("Partido condensado (bocha en juego)")},
+        {QStringLiteral("export.use_whistle_cues"), QStringLiteral("Usar silbatos detectados para ubicar los cortes")},
+        {QStringLiteral("export.segments_label"), QStringLiteral("segmentos de juego")},
+        {QStringLiteral("export.condensed_unavailable"), QStringLiteral("El análisis de escenas de este video todavía está en curso…")},
+        {QStringLiteral("export.condensed_file_name"), QStringLiteral("partido condensado")},
         {QStringLiteral("export.before_tag"), QStringLiteral("Antes de la marca:")},
       {QStringLiteral("export.after_tag"), QStringLiteral("Después de la marca:")},
       {QStringLiteral("export.save_to"), QStringLiteral("Guardar en:")},
@@ -389,6 +441,8 @@ QString trUi(const char* key) {
       {QStringLiteral("export.all_clips_discarded"), QStringLiteral("Todos los clips han sido descartados.")},
       {QStringLiteral("export.include_note"), QStringLiteral("Incluir nota en overlay")},
       {QStringLiteral("export.note_placeholder"), QStringLiteral("Texto de la nota\u2026")},
+      {QStringLiteral("export.angle"), QStringLiteral("Cámara:")},
+      {QStringLiteral("export.angle_main"), QStringLiteral("Cámara principal")},
       {QStringLiteral("export.starting"), QStringLiteral("Iniciando exportación…")},
       {QStringLiteral("export.progress_prefix"), QStringLiteral("Exportando clip")},
       {QStringLiteral("export.done"), QStringLiteral("Exportación completa.")},
@@ -0,0 +1,262 @@
+#include "AudioEvents.h"
+
+#include <QDataStream>
+#include <QFile>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+constexpr quint32 kEventsMagic = 0x41564145; // "AVAE"
+constexpr quint32 kEventsVersion = 1;
+constexpr qint64 kEventRecordBytes = 1 + 8 + 8 + 8;  // kind, start, end, confidence (double precision)
+
+constexpr double kWhistleLoHz = 2000.0;       // pea whistles sit around 2.5-4 kHz
+constexpr double kWhistleHiHz = 4500.0;
+constexpr double kMinConcentration = 0.5;     // share of band energy in the peak bin and its neighbours
+constexpr double kMinBandShare = 0.3;         // share of total energy inside the whistle band
+constexpr double kSilenceFloorDb = -55.0;
+constexpr int kMinWhistleFrames = 6;          // ~100 ms at 16 kHz / 256 hop
+constexpr int kMaxWhistleGapFrames = 2;
+constexpr qint64 kWhistleMergeGapMs = 300;
+
+constexpr double kShortAlpha = 1.0 / 31.0;    // ~0.5 s loudness smoothing
+constexpr double kBaselineAlpha = 1.0 / 1875.0; // ~30 s crowd baseline
+constexpr double kSurgeDeltaDb = 6.0;
+constexpr qint64 kMinSurgeMs = 1500;
+constexpr qint64 kWarmupMs = 10000;           // let the baseline settle before reporting surges
+constexpr qint64 kSurgeOnsetLagMs = 500;      // compensates the short-term smoothing
+
+constexpr double kPi = 3.14159265358979323846;
+} // namespace
+
+AudioEventDetector::AudioEventDetector(int sampleRate)
+    : sampleRate_(std::max(1, sampleRate)),
+      window_(kFftSize), bitReverse_(kFftSize), twiddleRe_(kFftSize - 1), twiddleIm_(kFftSize - 1),
+      re_(kFftSize), im_(kFftSize), ring_(kFftSize) {
+    for (int i = 0; i < kFftSize; ++i) {
+        window_[i] = float(0.5 - 0.5 * std::cos(2.0 * kPi * i / (kFftSize - 1)));
+    }
+
+    int bits = 0;
+    while ((1 << bits) < kFftSize) ++bits;
+    for (int i = 0; i < kFftSize; ++i) {
+        int reversed = 0;
+        for (int b = 0; b < bits; ++b) reversed |= ((i >> b) & 1) << (bits - 1 - b);
+        bitReverse_[i] = reversed;
+    }
+
+    for (int half = 1; half < kFftSize; half <<= 1) {
+        for (int j = 0; j < half; ++j) {
+            const double angle = -kPi * j / half;
+            twiddleRe_[half - 1 + j] = float(std::cos(angle));
+            twiddleIm_[half - 1 + j] = float(std::sin(angle));
+        }
+    }
+
+    const double binHz = double(sampleRate_) / kFftSize;
+    whistleLoBin_ = std::max(2, int(std::ceil(kWhistleLoHz / binHz)));
+    whistleHiBin_ = std::min(kFftSize / 2 - 2, int(std::floor(kWhistleHiHz / binHz)));
+}
+
+qint64 AudioEventDetector::frameTimeMs(qint64 frame) const {
+    return frame * kHopSamples * 1000 / sampleRate_;
+}
+
+void AudioEventDetector::appendSamples(const qint16* samples, int count) {
+    constexpr float kScale = 1.0f / 32768.0f;
+    while (count > 0) {
+        const int take = std::min(count, kFftSize - ringFill_);
+        for (int i = 0; i < take; ++i) ring_[ringFill_ + i] = samples[i] * kScale;
+        ringFill_ += take;
+        samples += take;
+        count -= take;
+        if (ringFill_ == kFftSize) {
+            analyzeFrame();
+            std::memmove(ring_.data(), ring_.data() + kHopSamples, (kFftSize - kHopSamples) * sizeof(float));
+            ringFill_ = kFftSize - kHopSamples;
+            ++frameIndex_;
+        }
+    }
+}
+
+void AudioEventDetector::fft() {
+    for (int i = 0; i < kFftSize; ++i) {
+        const int j = bitReverse_[i];
+        if (j > i) {
+            std::swap(re_[i], re_[j]);
+            std::swap(im_[i], im_[j]);
+        }
+    }
+
+    // Butterflies walk contiguous halves with contiguous per-stage twiddles, so the inner loop vectorizes.
+    for (int half = 1; half < kFftSize; half <<= 1) {
+        const float* wr = twiddleRe_.data() + half - 1;
+        const float* wi = twiddleIm_.data() + half - 1;
+        for (int base = 0; base < kFftSize; base += 2 * half) {
+            float* ar = re_.data() + base;
+            float* ai = im_.data() + base;
+            float* br = ar + half;
+            float* bi = ai + half;
+            for (int j = 0; j < half; ++j) {
+                const float tr = br[j] * wr[j] - bi[j] * wi[j];
+                const float ti = br[j] * wi[j] + bi[j] * wr[j];
+                br[j] = ar[j] - tr;
+                bi[j] = ai[j] - ti;
+                ar[j] += tr;
+                ai[j] += ti;
+            }
+        }
+    }
+}
+
+void AudioEventDetector::analyzeFrame() {
+    for (int i = 0; i < kFftSize; ++i) {
+        re_[i] = ring_[i] * window_[i];
+        im_[i] = 0.0f;
+    }
+    fft();
+
+    // Power spectrum into re_ (positive frequencies only)
+    constexpr int kBins = kFftSize / 2;
+    for (int b = 0; b < kBins; ++b) re_[b] = re_[b] * re_[b] + im_[b] * im_[b];
+
+    double total = 0.0;
+    for (int b = 2; b < kBins; ++b) total += re_[b];
+    double band = 0.0;
+    int peakBin = whistleLoBin_;
+    for (int b = whistleLoBin_; b <= whistleHiBin_; ++b) {
+        band += re_[b];
+        if (re_[b] > re_[peakBin]) peakBin = b;
+    }
+    const double peak = re_[peakBin - 1] + re_[peakBin] + re_[peakBin + 1];
+
+    // Full-scale sine through a Hann window peaks at (N/4)^2, so this reads roughly as dBFS.
+    constexpr double kFullScale = double(kFftSize / 4) * double(kFftSize / 4);
+    const double db = 10.0 * std::log10(total / kFullScale + 1e-12);
+
+    const double concentration = band > 0.0 ? peak / band : 0.0;
+    const double bandShare = total > 0.0 ? band / total : 0.0;
+    const bool whistleFrame = db > kSilenceFloorDb && concentration > kMinConcentration && bandShare > kMinBandShare;
+
+    if (whistleFrame) {
+        if (whistleStartFrame_ < 0) whistleStartFrame_ = frameIndex_;
+        whistleLastFrame_ = frameIndex_;
+        whistleScoreSum_ += concentration * std::min(1.0, bandShare / 0.6);
+        ++whistleFrames_;
+    } else if (whistleStartFrame_ >= 0 && frameIndex_ - whistleLastFrame_ > kMaxWhistleGapFrames) {
+        closeWhistle();
+    }
+
+    if (!levelsPrimed_) {
+        shortDb_ = baselineDb_ = db;
+        levelsPrimed_ = true;
+    }
+    shortDb_ += (db - shortDb_) * kShortAlpha;
+    baselineDb_ += (db - baselineDb_) * kBaselineAlpha;
+    if (frameTimeMs(frameIndex_) < kWarmupMs) return;
+
+    const double delta = shortDb_ - baselineDb_;
+    if (delta > kSurgeDeltaDb) {
+        if (surgeStartFrame_ < 0) {
+            surgeStartFrame_ = frameIndex_;
+            surgePeakDeltaDb_ = delta;
+            surgeWhistleFrames_ = 0;
+        }
+        surgePeakDeltaDb_ = std::max(surgePeakDeltaDb_, delta);
+        if (whistleFrame) ++surgeWhistleFrames_;
+    } else if (surgeStartFrame_ >= 0) {
+        closeSurge();
+    }
+}
+
+void AudioEventDetector::closeWhistle() {
+    if (whistleStartFrame_ >= 0 && whistleFrames_ >= kMinWhistleFrames) {
+        AudioEvent event;
+        event.kind = AudioEvent::Kind::Whistle;
+        event.startMs = frameTimeMs(whistleStartFrame_);
+        event.endMs = frameTimeMs(whistleLastFrame_) + qint64(kFftSize) * 1000 / sampleRate_;
+        event.confidence = float(std::clamp(whistleScoreSum_ / whistleFrames_, 0.0, 1.0));
+
+        // Trills and stuttered blasts come out as several runs; keep them as one whistle.
+        auto previous = std::find_if(events_.rbegin(), events_.rend(),
+                                     [](const AudioEvent& e) { return e.kind == AudioEvent::Kind::Whistle; });
+        if (previous != events_.rend() && event.startMs - previous->endMs <= kWhistleMergeGapMs) {
+            previous->endMs = event.endMs;
+            previous->confidence = std::max(previous->confidence, event.confidence);
+        } else {
+            events_.append(event);
+        }
+    }
+    whistleStartFrame_ = -1;
+    whistleLastFrame_ = -1;
+    whistleScoreSum_ = 0.0;
+    whistleFrames_ = 0;
+}
+
+void AudioEventDetector::closeSurge() {
+    const qint64 frames = frameIndex_ - surgeStartFrame_;
+    const qint64 startMs = std::max<qint64>(0, frameTimeMs(surgeStartFrame_) - kSurgeOnsetLagMs);
+    const qint64 endMs = frameTimeMs(frameIndex_);
+    // A long whistle also raises the level; only broadband reactions count as crowd surges.
+    if (surgeStartFrame_ >= 0 && endMs - startMs >= kMinSurgeMs && surgeWhistleFrames_ * 2 < frames) {
+        AudioEvent event;
+        event.kind = AudioEvent::Kind::CrowdSurge;
+        event.startMs = startMs;
+        event.endMs = endMs;
+        event.confidence = float(std::clamp(0.5 + (surgePeakDeltaDb_ - kSurgeDeltaDb) / 12.0, 0.0, 1.0));
+        events_.append(event);
+    }
+    surgeStartFrame_ = -1;
+    surgePeakDeltaDb_ = 0.0;
+    surgeWhistleFrames_ = 0;
+}
+
+void AudioEventDetector::finish() {
+    if (whistleStartFrame_ >= 0) closeWhistle();
+    if (surgeStartFrame_ >= 0) closeSurge();
+    std::stable_sort(events_.begin(), events_.end(), [](const AudioEvent& a, const AudioEvent& b) {
+        return a.startMs < b.startMs;
+    });
+}
+
+bool AudioEvent::saveToFile(const QString& path, const QString& fingerprint, const QVector<AudioEvent>& events) {
+    if (path.isEmpty()) return false;
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << kEventsMagic << kEventsVersion << fingerprint << qint32(events.size());
+    for (const AudioEvent& e : events) out << quint8(e.kind) << e.startMs << e.endMs << e.confidence;
+    return out.status() == QDataStream::Ok && file.commit();
+}
+
+bool AudioEvent::loadFromFile(const QString& path, const QString& fingerprint, QVector<AudioEvent>* out) {
+    QFile file(path);
+    if (!out || fingerprint.isEmpty() || !file.open(QIODevice::ReadOnly)) return false;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+    quint32 magic = 0, version = 0;
+    QString storedFingerprint;
+    qint32 count = 0;
+    in >> magic >> version >> storedFingerprint >> count;
+    if (magic != kEventsMagic || version != kEventsVersion || storedFingerprint != fingerprint || count < 0) {
+        return false;
+    }
+    // The count is untrusted: a corrupt or truncated file must not drive the allocation.
+    if (qint64(count) * kEventRecordBytes > file.size() - file.pos()) return false;
+
+    QVector<AudioEvent> loaded(count);
+    for (AudioEvent& e : loaded) {
+        quint8 kind = 0;
+        in >> kind >> e.startMs >> e.endMs >> e.confidence;
+        e.kind = kind == quint8(AudioEvent::Kind::CrowdSurge) ? AudioEvent::Kind::CrowdSurge : AudioEvent::Kind::Whistle;
+    }
+    if (in.status() != QDataStream::Ok) return false;
+    *out = std::move(loaded);
+    return true;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+#include <vector>
+
+/// A stretch of audio that looks like a referee whistle or a crowd reaction; shown as a suggested tag.
+struct AudioEvent {
+    enum class Kind : quint8 { Whistle = 0, CrowdSurge = 1 };
+
+    Kind kind = Kind::Whistle;
+    qint64 startMs = 0;
+    qint64 endMs = 0;
+    float confidence = 0.0f;     // 0..1
+
+    static bool saveToFile(const QString& path, const QString& fingerprint, const QVector<AudioEvent>& events);
+    static bool loadFromFile(const QString& path, const QString& fingerprint, QVector<AudioEvent>* out);
+};
+
+/// Streaming whistle / crowd-surge detector over mono int16 PCM.
+/// Every kHopSamples it windows kFftSize samples and runs a radix-2 FFT on split real/imaginary arrays
+/// (unit-stride butterflies the compiler vectorizes). A whistle frame concentrates most of the
+/// 2-4.5 kHz band energy in a couple of bins; a crowd surge is short-term loudness well above a slow
+/// baseline for more than a second. Pure computation with no I/O, so synthetic audio can be fed directly.
+class AudioEventDetector {
+public:
+    static constexpr int kFftSize = 512;
+    static constexpr int kHopSamples = 256;
+
+    explicit AudioEventDetector(int sampleRate = 16000);
+
+    void appendSamples(const qint16* samples, int count);
+    void finish();                              // closes events still open at the end of the audio
+    const QVector<AudioEvent>& events() const { return events_; }
+
+private:
+    void analyzeFrame();
+    void fft();
+    void closeWhistle();
+    void closeSurge();
+    qint64 frameTimeMs(qint64 frame) const;
+
+    int sampleRate_ = 16000;
+    std::vector<float> window_;                  // Hann
+    std::vector<int> bitReverse_;
+    std::vector<float> twiddleRe_;               // per stage, contiguous: stage s starts at (1 << s) - 1
+    std::vector<float> twiddleIm_;
+    std::vector<float> re_;
+    std::vector<float> im_;
+    std::vector<float> ring_;                    // last kFftSize samples
+    int ringFill_ = 0;
+    qint64 frameIndex_ = 0;
+
+    int whistleLoBin_ = 0;
+    int whistleHiBin_ = 0;
+
+    // Whistle run state
+    qint64 whistleStartFrame_ = -1;
+    qint64 whistleLastFrame_ = -1;
+    double whistleScoreSum_ = 0.0;
+    int whistleFrames_ = 0;
+
+    // Crowd surge state (loudness in dB)
+    double shortDb_ = 0.0;
+    double baselineDb_ = 0.0;
+    bool levelsPrimed_ = false;
+    qint64 surgeStartFrame_ = -1;
+    double surgePeakDeltaDb_ = 0.0;
+    int surgeWhistleFrames_ = 0;
+
+    QVector<AudioEvent> events_;
+};
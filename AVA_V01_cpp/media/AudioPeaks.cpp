@@ -0,0 +1,464 @@
+#include "AudioPeaks.h"
+
+#include "ClipExporter.h"
+#include "MediaCache.h"
+
+#include <QDataStream>
+#include <QFile>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QSysInfo>
+#include <QThread>
+#include <QWaitCondition>
+
+#include <algorithm>
+#include <cstdlib>
+#include <deque>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define AVA_PEAKS_SSE2 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define AVA_PEAKS_NEON 1
+#endif
+
+namespace {
+constexpr quint32 kPeaksMagic = 0x4156504B; // "AVPK"
+constexpr quint32 kPeaksVersion = 1;
+const QString kPeaksCategory = QStringLiteral("waveform");
+constexpr qint64 kPublishEverySamples = AudioPeakPyramid::kSampleRate * 60;  // one minute of audio
+
+// Envelope of `count` samples. The vector paths cover 8 samples per instruction; the tail is scalar.
+void minMaxInt16(const qint16* samples, int count, qint16* outMin, qint16* outMax) {
+    qint16 lo = *outMin;
+    qint16 hi = *outMax;
+    int i = 0;
+#if defined(AVA_PEAKS_SSE2)
+    if (count >= 8) {
+        __m128i vmin = _mm_set1_epi16(lo);
+        __m128i vmax = _mm_set1_epi16(hi);
+        for (; i + 8 <= count; i += 8) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(samples + i));
+            vmin = _mm_min_epi16(vmin, v);
+            vmax = _mm_max_epi16(vmax, v);
+        }
+        alignas(16) qint16 mins[8];
+        alignas(16) qint16 maxs[8];
+        _mm_store_si128(reinterpret_cast<__m128i*>(mins), vmin);
+        _mm_store_si128(reinterpret_cast<__m128i*>(maxs), vmax);
+        lo = *std::min_element(mins, mins + 8);
+        hi = *std::max_element(maxs, maxs + 8);
+    }
+#elif defined(AVA_PEAKS_NEON)
+    if (count >= 8) {
+        int16x8_t vmin = vdupq_n_s16(lo);
+        int16x8_t vmax = vdupq_n_s16(hi);
+        for (; i + 8 <= count; i += 8) {
+            const int16x8_t v = vld1q_s16(samples + i);
+            vmin = vminq_s16(vmin, v);
+            vmax = vmaxq_s16(vmax, v);
+        }
+        lo = vminvq_s16(vmin);
+        hi = vmaxvq_s16(vmax);
+    }
+#endif
+    for (; i < count; ++i) {
+        lo = std::min(lo, samples[i]);
+        hi = std::max(hi, samples[i]);
+    }
+    *outMin = lo;
+    *outMax = hi;
+}
+
+AudioPeakPyramid::Peak mergePeaks(AudioPeakPyramid::Peak a, AudioPeakPyramid::Peak b) {
+    return {std::min(a.min, b.min), std::max(a.max, b.max)};
+}
+} // namespace
+
+int AudioPeakPyramid::levelForMsPerPixel(double msPerPixel) const {
+    int level = 0;
+    while (level + 1 < levels.size() && bucketMs(level + 1) <= msPerPixel) ++level;
+    return level;
+}
+
+bool AudioPeakPyramid::peakInRange(int level, qint64 fromMs, qint64 toMs, Peak* out) const {
+    if (!out || level < 0 || level >= levels.size()) return false;
+    const QVector<Peak>& peaks = levels.at(level);
+    const qint64 bucketSamples = qint64(kBaseBlockSamples) << level;
+    const qint64 first = std::max<qint64>(0, fromMs * kSampleRate / 1000 / bucketSamples);
+    const qint64 last = std::min<qint64>(peaks.size(), (toMs * kSampleRate / 1000 + bucketSamples - 1) / bucketSamples);
+    if (first >= last) return false;
+
+    Peak envelope = peaks.at(first);
+    for (qint64 i = first + 1; i < last; ++i) envelope = mergePeaks(envelope, peaks.at(i));
+    *out = envelope;
+    return true;
+}
+
+int AudioPeakPyramid::maxAmplitude() const {
+    if (isEmpty()) return 0;
+    // The top level covers everything except the odd trailing bucket of each level below it.
+    int amplitude = 0;
+    auto include = [&amplitude](const Peak& p) {
+        amplitude = std::max({amplitude, std::abs(int(p.min)), std::abs(int(p.max))});
+    };
+    for (const Peak& p : levels.constLast()) include(p);
+    for (int k = 0; k + 1 < levels.size(); ++k) {
+        if (levels.at(k).size() % 2 != 0) include(levels.at(k).constLast());
+    }
+    return amplitude;
+}
+
+void AudioPeakPyramid::pushPeak(int level, Peak peak) {
+    while (true) {
+        if (levels.size() <= level) levels.resize(level + 1);
+        QVector<Peak>& peaks = levels[level];
+        peaks.append(peak);
+        // A completed pair becomes one bucket of the next level (binary carry), so every level stays
+        // complete for the audio decoded so far.
+        if (peaks.size() % 2 != 0) return;
+        peak = mergePeaks(peaks.at(peaks.size() - 2), peaks.constLast());
+        ++level;
+    }
+}
+
+void AudioPeakPyramid::appendSamples(const qint16* samples, int count) {
+    sampleCount += count;
+    while (count > 0) {
+        if (pendingSamples_ == 0) {
+            pendingMin_ = samples[0];
+            pendingMax_ = samples[0];
+        }
+        const int take = std::min(count, kBaseBlockSamples - pendingSamples_);
+        minMaxInt16(samples, take, &pendingMin_, &pendingMax_);
+        pendingSamples_ += take;
+        samples += take;
+        count -= take;
+        if (pendingSamples_ == kBaseBlockSamples) {
+            pushPeak(0, {qint8(pendingMin_ >> 8), qint8(pendingMax_ >> 8)});
+            pendingSamples_ = 0;
+        }
+    }
+}
+
+void AudioPeakPyramid::appendPeaks(const QVector<Peak>& peaks, qint64 totalSamples) {
+    for (const Peak& peak : peaks) pushPeak(0, peak);
+    sampleCount = totalSamples;
+}
+
+void AudioPeakPyramid::finish() {
+    if (pendingSamples_ > 0) {
+        if (levels.isEmpty()) levels.resize(1);
+        levels[0].append({qint8(pendingMin_ >> 8), qint8(pendingMax_ >> 8)});
+        pendingSamples_ = 0;
+    }
+    if (levels.isEmpty()) return;
+
+    // Rebuild above level 0 so odd trailing buckets are represented at every level.
+    levels.resize(1);
+    while (levels.constLast().size() > 1) {
+        const QVector<Peak>& finer = levels.constLast();
+        QVector<Peak> coarser((finer.size() + 1) / 2);
+        for (int i = 0; i < coarser.size(); ++i) {
+            const int a = 2 * i;
+            coarser[i] = (a + 1 < finer.size()) ? mergePeaks(finer.at(a), finer.at(a + 1)) : finer.at(a);
+        }
+        levels.append(std::move(coarser));
+    }
+}
+
+bool AudioPeakPyramid::saveToFile(const QString& path, const QString& fingerprint) const {
+    if (path.isEmpty() || isEmpty()) return false;
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+
+    // Only level 0 is stored; the upper levels are rebuilt on load in a few milliseconds.
+    const QVector<Peak>& base = levels.first();
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << kPeaksMagic << kPeaksVersion << fingerprint << sampleCount << qint32(base.size());
+    out.writeRawData(reinterpret_cast<const char*>(base.constData()), int(base.size() * sizeof(Peak)));
+    return out.status() == QDataStream::Ok && file.commit();
+}
+
+bool AudioPeakPyramid::loadFromFile(const QString& path, const QString& fingerprint, AudioPeakPyramid* out) {
+    QFile file(path);
+    if (!out || fingerprint.isEmpty() || !file.open(QIODevice::ReadOnly)) return false;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+    quint32 magic = 0, version = 0;
+    QString storedFingerprint;
+    AudioPeakPyramid loaded;
+    qint32 count = 0;
+    in >> magic >> version >> storedFingerprint >> loaded.sampleCount >> count;
+    if (magic != kPeaksMagic || version != kPeaksVersion || storedFingerprint != fingerprint || count <= 0) {
+        return false;
+    }
+
+    // The count is untrusted: a corrupt or truncated file must not drive the allocation.
+    if (qint64(count) * qint64(sizeof(Peak)) > file.size() - file.pos()) return false;
+    QVector<Peak> base(count);
+    const int bytes = int(count * sizeof(Peak));
+    if (in.readRawData(reinterpret_cast<char*>(base.data()), bytes) != bytes) return false;
+    loaded.levels.append(std::move(base));
+    loaded.finish();
+    *out = std::move(loaded);
+    return true;
+}
+
+// Owns the in-progress pyramid and detector; everything it produces goes back to the builder's thread as
+// queued calls tagged with the decode generation, so results of a cancelled decode are simply ignored.
+struct AudioPeaksBuilder::Worker {
+    struct Job {
+        enum class Kind { Samples, Finish };
+        Kind kind = Kind::Samples;
+        quint64 generation = 0;
+        QByteArray bytes;            // Samples: raw PCM as read from the pipe
+        bool complete = false;       // Finish: ffmpeg exited cleanly, so the results may be cached
+        QString cachePath;
+        QString eventsCachePath;
+        QString fingerprint;
+    };
+
+    explicit Worker(AudioPeaksBuilder* owner) : owner(owner) {
+        thread = QThread::create([this]() { run(); });
+        thread->setObjectName(QStringLiteral("AudioPeaks"));
+        thread->start(QThread::LowPriority);
+    }
+
+    ~Worker() {
+        {
+            QMutexLocker locker(&mutex);
+            stopping = true;
+            jobs.clear();
+            wake.wakeOne();
+        }
+        thread->wait();
+        delete thread;
+    }
+
+    void submit(Job job) {
+        QMutexLocker locker(&mutex);
+        jobs.push_back(std::move(job));
+        wake.wakeOne();
+    }
+
+    /// Drops queued jobs of a cancelled decode; the one in progress finishes and is ignored.
+    void discardQueued() {
+        QMutexLocker locker(&mutex);
+        jobs.clear();
+    }
+
+    void run() {
+        for (;;) {
+            Job job;
+            {
+                QMutexLocker locker(&mutex);
+                while (jobs.empty() && !stopping) wake.wait(&mutex);
+                if (stopping) return;
+                job = std::move(jobs.front());
+                jobs.pop_front();
+            }
+            if (job.generation != generation) reset(job.generation);
+            if (job.kind == Job::Kind::Samples) {
+                appendSamples(std::move(job.bytes));
+            } else {
+                finish(job);
+            }
+        }
+    }
+
+    void reset(quint64 next) {
+        generation = next;
+        pyramid = AudioPeakPyramid();
+        detector = AudioEventDetector(AudioPeakPyramid::kSampleRate);
+        carry.clear();
+        publishedPeaks = 0;
+        lastPublishedSamples = 0;
+    }
+
+    void appendSamples(QByteArray bytes) {
+        if (!carry.isEmpty()) {
+            bytes.prepend(carry);
+            carry.clear();
+        }
+        const int sampleCount = int(bytes.size() / qsizetype(sizeof(qint16)));
+        if (bytes.size() % qsizetype(sizeof(qint16)) != 0) carry = bytes.right(1);
+        pyramid.appendSamples(reinterpret_cast<const qint16*>(bytes.constData()), sampleCount);
+        detector.appendSamples(reinterpret_cast<const qint16*>(bytes.constData()), sampleCount);
+
+        if (pyramid.sampleCount - lastPublishedSamples < kPublishEverySamples || pyramid.levels.isEmpty()) return;
+        lastPublishedSamples = pyramid.sampleCount;
+        const QVector<AudioPeakPyramid::Peak> peaks = pyramid.levels.first().mid(publishedPeaks);
+        publishedPeaks = pyramid.levels.first().size();
+        AudioPeaksBuilder* target = owner;
+        const quint64 decode = generation;
+        const qint64 samples = pyramid.sampleCount;
+        QMetaObject::invokeMethod(owner, [target, decode, peaks, samples]() {
+            target->onPeaksDecoded(decode, peaks, samples);
+        }, Qt::QueuedConnection);
+    }
+
+    void finish(const Job& job) {
+        pyramid.finish();
+        QVector<AudioEvent> events;
+        if (job.complete) {
+            detector.finish();
+            events = detector.events();
+            pyramid.saveToFile(job.cachePath, job.fingerprint);
+            AudioEvent::saveToFile(job.eventsCachePath, job.fingerprint, events);
+        }
+        AudioPeaksBuilder* target = owner;
+        const quint64 decode = generation;
+        const AudioPeakPyramid finished = std::exchange(pyramid, AudioPeakPyramid());
+        const bool complete = job.complete;
+        QMetaObject::invokeMethod(owner, [target, decode, finished, events, complete]() {
+            target->onDecodeFinished(decode, finished, events, complete);
+        }, Qt::QueuedConnection);
+        reset(generation);
+    }
+
+    AudioPeaksBuilder* owner = nullptr;
+    QThread* thread = nullptr;
+    QMutex mutex;
+    QWaitCondition wake;
+    std::deque<Job> jobs;
+    bool stopping = false;
+
+    // Worker thread only
+    quint64 generation = 0;
+    AudioPeakPyramid pyramid;
+    AudioEventDetector detector{AudioPeakPyramid::kSampleRate};
+    QByteArray carry;                // odd trailing byte between pipe reads
+    qsizetype publishedPeaks = 0;    // level-0 peaks already posted to the builder
+    qint64 lastPublishedSamples = 0;
+};
+
+AudioPeaksBuilder::AudioPeaksBuilder(QObject* parent)
+    : QObject(parent), worker_(std::make_unique<Worker>(this)) {}
+
+AudioPeaksBuilder::~AudioPeaksBuilder() { cancel(); }
+
+void AudioPeaksBuilder::start(const QString& sourcePath) {
+    cancel();
+    fingerprint_ = MediaCache::sourceFingerprint(sourcePath);
+    if (fingerprint_.isEmpty()) return;
+    cachePath_ = MediaCache::cacheFilePath(sourcePath, kPeaksCategory, QStringLiteral("avapk"));
+    eventsCachePath_ = MediaCache::cacheFilePath(sourcePath, kPeaksCategory, QStringLiteral("avaev"));
+
+    // Both results come from one decode, so a cache hit needs both files.
+    if (AudioPeakPyramid::loadFromFile(cachePath_, fingerprint_, &pyramid_) &&
+        AudioEvent::loadFromFile(eventsCachePath_, fingerprint_, &events_)) {
+        emit peaksUpdated();
+        emit eventsChanged();
+        return;
+    }
+    pyramid_ = AudioPeakPyramid();
+
+    const QString ffmpegPath = ClipExporter::findFfmpeg();
+    if (ffmpegPath.isEmpty()) return;
+
+    const QStringList ffmpegArgs = {
+        QStringLiteral("-hide_banner"), QStringLiteral("-nostdin"), QStringLiteral("-nostats"),
+        QStringLiteral("-loglevel"), QStringLiteral("error"),
+        QStringLiteral("-i"), sourcePath,
+        QStringLiteral("-vn"), QStringLiteral("-sn"), QStringLiteral("-dn"),
+        QStringLiteral("-map"), QStringLiteral("0:a:0"),
+        QStringLiteral("-ac"), QStringLiteral("1"),
+        QStringLiteral("-ar"), QString::number(AudioPeakPyramid::kSampleRate),
+        QStringLiteral("-f"), QSysInfo::ByteOrder == QSysInfo::LittleEndian ? QStringLiteral("s16le")
+                                                                            : QStringLiteral("s16be"),
+        QStringLiteral("pipe:1"),
+    };
+
+    process_ = new QProcess(this);
+    process_->setProcessChannelMode(QProcess::SeparateChannels);
+    process_->setStandardErrorFile(QProcess::nullDevice());
+    connect(process_, &QProcess::readyReadStandardOutput, this, &AudioPeaksBuilder::onReadyReadStandardOutput);
+    connect(process_, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+            this, &AudioPeaksBuilder::onProcessFinished);
+
+    const QString nicePath = QStandardPaths::findExecutable(QStringLiteral("nice"));
+    if (!nicePath.isEmpty()) {
+        process_->start(nicePath, QStringList{QStringLiteral("-n"), QStringLiteral("19"), ffmpegPath} + ffmpegArgs);
+    } else {
+        process_->start(ffmpegPath, ffmpegArgs);
+    }
+}
+
+void AudioPeaksBuilder::cancel() {
+    if (QProcess* process = std::exchange(process_, nullptr)) {
+        process->disconnect(this);
+        if (process->state() == QProcess::NotRunning) {
+            process->deleteLater();
+        } else {
+            // Reaped when it exits instead of waited for; anything it still writes goes nowhere.
+            connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+                    process, &QObject::deleteLater);
+            process->kill();
+        }
+    }
+    ++generation_;
+    worker_->discardQueued();
+    finishing_ = false;
+    const bool hadPeaks = !pyramid_.isEmpty();
+    const bool hadEvents = !events_.isEmpty();
+    pyramid_ = AudioPeakPyramid();
+    events_.clear();
+    cachePath_.clear();
+    eventsCachePath_.clear();
+    fingerprint_.clear();
+    if (hadPeaks) emit peaksUpdated();
+    if (hadEvents) emit eventsChanged();
+}
+
+void AudioPeaksBuilder::onReadyReadStandardOutput() {
+    if (!process_) return;
+    Worker::Job job;
+    job.generation = generation_;
+    job.bytes = process_->readAllStandardOutput();
+    if (!job.bytes.isEmpty()) worker_->submit(std::move(job));
+}
+
+void AudioPeaksBuilder::onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus) {
+    onReadyReadStandardOutput();
+    process_->deleteLater();
+    process_ = nullptr;
+
+    // Sources without an audio stream fail here too; the worker keeps whatever was decoded, caches nothing.
+    const bool complete = exitStatus == QProcess::NormalExit && exitCode == 0;
+    if (!complete) qWarning("AudioPeaksBuilder: ffmpeg exited with code %d", exitCode);
+
+    Worker::Job job;
+    job.kind = Worker::Job::Kind::Finish;
+    job.generation = generation_;
+    job.complete = complete;
+    job.cachePath = cachePath_;
+    job.eventsCachePath = eventsCachePath_;
+    job.fingerprint = fingerprint_;
+    finishing_ = true;
+    worker_->submit(std::move(job));
+}
+
+void AudioPeaksBuilder::onPeaksDecoded(quint64 generation, const QVector<AudioPeakPyramid::Peak>& peaks,
+                                       qint64 sampleCount) {
+    if (generation != generation_) return;
+    pyramid_.appendPeaks(peaks, sampleCount);
+    emit peaksUpdated();
+}
+
+void AudioPeaksBuilder::onDecodeFinished(quint64 generation, const AudioPeakPyramid& pyramid,
+                                         const QVector<AudioEvent>& events, bool complete) {
+    if (generation != generation_) return;
+    finishing_ = false;
+    pyramid_ = pyramid;
+    emit peaksUpdated();
+    if (!complete) return;
+    events_ = events;
+    emit eventsChanged();
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "AudioEvents.h"
+
+#include <QByteArray>
+#include <QObject>
+#include <QProcess>
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+#include <memory>
+
+/// Min/max peak pyramid of the mono-mixed audio track. Level 0 holds one peak per kBaseBlockSamples
+/// samples (4 ms at kSampleRate); each level above halves the resolution, so any zoom reads at most
+/// two peaks per pixel. Peaks are quantized to 8 bits, ~5 MB for a 90-minute game.
+struct AudioPeakPyramid {
+    static constexpr int kSampleRate = 16000;
+    static constexpr int kBaseBlockSamples = 64;
+
+    struct Peak {
+        qint8 min = 0;
+        qint8 max = 0;
+    };
+
+    QVector<QVector<Peak>> levels;   // levels[k] peaks cover kBaseBlockSamples << k samples each
+    qint64 sampleCount = 0;
+
+    bool isEmpty() const { return levels.isEmpty() || levels.first().isEmpty(); }
+    qint64 durationMs() const { return sampleCount * 1000 / kSampleRate; }
+    double bucketMs(int level) const { return double(kBaseBlockSamples << level) * 1000.0 / kSampleRate; }
+
+    /// Coarsest level whose buckets are not wider than `msPerPixel` (level 0 when zoomed past it).
+    int levelForMsPerPixel(double msPerPixel) const;
+
+    /// Envelope of [fromMs, toMs) read from `level`; false when the range holds no peaks yet.
+    bool peakInRange(int level, qint64 fromMs, qint64 toMs, Peak* out) const;
+
+    /// Largest absolute peak, used to normalize the drawing of quiet recordings.
+    int maxAmplitude() const;
+
+    /// Adds PCM samples (mono, native-endian int16) and propagates full buckets up the pyramid.
+    void appendSamples(const qint16* samples, int count);
+
+    /// Adds finished level-0 peaks decoded elsewhere; `totalSamples` is the sample count they now cover.
+    void appendPeaks(const QVector<Peak>& peaks, qint64 totalSamples);
+
+    /// Flushes the partial trailing bucket and rebuilds the upper levels so they include it.
+    void finish();
+
+    bool saveToFile(const QString& path, const QString& fingerprint) const;
+    static bool loadFromFile(const QString& path, const QString& fingerprint, AudioPeakPyramid* out);
+
+private:
+    void pushPeak(int level, Peak peak);
+
+    qint16 pendingMin_ = 0;          // envelope of the samples of the unfinished level-0 bucket
+    qint16 pendingMax_ = 0;
+    int pendingSamples_ = 0;
+};
+
+/// Decodes the audio of a source once (ffmpeg, low priority, 16 kHz mono PCM on a pipe) into an
+/// AudioPeakPyramid cached under the source fingerprint. Peaks are published while decoding runs.
+/// The same PCM feeds an AudioEventDetector; whistle / crowd-surge suggestions are cached next to the peaks.
+/// The GUI thread only drains the pipe: peak building, detection and caching run on a worker thread,
+/// which posts new level-0 peaks back as they complete and the finished pyramid and events at the end.
+class AudioPeaksBuilder final : public QObject {
+    Q_OBJECT
+
+public:
+    explicit AudioPeaksBuilder(QObject* parent = nullptr);
+    ~AudioPeaksBuilder() override;
+
+    /// Loads the cached pyramid for `sourcePath` or starts decoding it in the background.
+    void start(const QString& sourcePath);
+    void cancel();
+    bool isRunning() const { return process_ != nullptr || finishing_; }
+
+    const AudioPeakPyramid& peaks() const { return pyramid_; }
+    const QVector<AudioEvent>& events() const { return events_; }
+
+signals:
+    void peaksUpdated();             // more of the pyramid is available (throttled while decoding)
+    void eventsChanged();            // detection finished (or was reset for a new source)
+
+private slots:
+    void onReadyReadStandardOutput();
+    void onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
+
+private:
+    struct Worker;
+
+    void onPeaksDecoded(quint64 generation, const QVector<AudioPeakPyramid::Peak>& peaks, qint64 sampleCount);
+    void onDecodeFinished(quint64 generation, const AudioPeakPyramid& pyramid, const QVector<AudioEvent>& events,
+                          bool complete);
+
+    QProcess* process_ = nullptr;
+    AudioPeakPyramid pyramid_;
+    QVector<AudioEvent> events_;
+    QString cachePath_;
+    QString eventsCachePath_;
+    QString fingerprint_;
+    quint64 generation_ = 0;         // bumped by cancel(); worker results from older decodes are dropped
+    bool finishing_ = false;         // ffmpeg exited, the worker is still finishing the pyramid
+    std::unique_ptr<Worker> worker_;
+};
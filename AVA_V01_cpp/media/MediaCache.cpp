@@ -0,0 +1,82 @@
+#include "MediaCache.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QStandardPaths>
+
+namespace {
+constexpr qint64 kFingerprintChunkBytes = 64 * 1024;
+
+QString memoKey(const QFileInfo& info) {
+    return QStringLiteral("%1|%2|%3")
+        .arg(info.absoluteFilePath())
+        .arg(info.size())
+        .arg(info.lastModified().toMSecsSinceEpoch());
+}
+} // namespace
+
+namespace MediaCache {
+
+QString sourceFingerprint(const QString& sourcePath) {
+    const QFileInfo info(sourcePath);
+    if (!info.exists()) return {};
+
+    // Proxy, thumbnail, waveform and index lookups all ask for the same file; hash it once.
+    static QMutex memoMutex;
+    static QHash<QString, QString> memo;
+    const QString key = memoKey(info);
+    {
+        QMutexLocker locker(&memoMutex);
+        const auto it = memo.constFind(key);
+        if (it != memo.constEnd()) return it.value();
+    }
+
+    QFile file(sourcePath);
+    if (!file.open(QIODevice::ReadOnly)) return {};
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(QByteArray::number(info.size()));
+    hash.addData(QByteArray::number(info.lastModified().toMSecsSinceEpoch()));
+    hash.addData(file.read(kFingerprintChunkBytes));
+    if (info.size() > 2 * kFingerprintChunkBytes) {
+        file.seek(info.size() - kFingerprintChunkBytes);
+        hash.addData(file.read(kFingerprintChunkBytes));
+    }
+    const QString fingerprint = QString::fromLatin1(hash.result().toHex().left(24));
+
+    QMutexLocker locker(&memoMutex);
+    memo.insert(key, fingerprint);
+    return fingerprint;
+}
+
+QString cacheDirectory(const QString& category) {
+    QString base = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (base.isEmpty()) base = QDir::tempPath() + QStringLiteral("/ava-cache");
+    const QString path = QDir(base).filePath(category);
+    QDir().mkpath(path);
+    return path;
+}
+
+QString cacheFilePath(const QString& sourcePath, const QString& category, const QString& extension) {
+    const QString fingerprint = sourceFingerprint(sourcePath);
+    if (fingerprint.isEmpty()) return {};
+    return QDir(cacheDirectory(category)).filePath(fingerprint + QLatin1Char('.') + extension);
+}
+
+QString sidecarPath(const QString& sourcePath, const QString& extension) {
+    const QFileInfo info(sourcePath);
+    const QFileInfo dirInfo(info.absolutePath());
+    if (dirInfo.isDir() && dirInfo.isWritable()) {
+        return QDir(info.absolutePath())
+            .filePath(QLatin1Char('.') + info.fileName() + QLatin1Char('.') + extension);
+    }
+    return cacheFilePath(sourcePath, QStringLiteral("sidecars"), extension);
+}
+
+} // namespace MediaCache
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <QString>
+
+namespace MediaCache {
+
+/// Cheap identity for a source file: size, mtime and a hash of its first and last 64 KiB.
+/// Stable across app restarts and renames-in-place; changes when the file content is replaced.
+QString sourceFingerprint(const QString& sourcePath);
+
+/// Per-category directory under the app cache location (created on demand).
+QString cacheDirectory(const QString& category);
+
+/// Cache file keyed by the source fingerprint, e.g. cacheFilePath(src, "thumbs", "png").
+QString cacheFilePath(const QString& sourcePath, const QString& category, const QString& extension);
+
+/// Sidecar file stored next to the source video (".<name>.<extension>"), falling back to the
+/// app cache directory when the video folder is not writable.
+QString sidecarPath(const QString& sourcePath, const QString& extension);
+
+} // namespace MediaCache
@@ -0,0 +1,478 @@
+#include "MediaIndex.h"
+
+#include "ClipExporter.h"
+#include "MediaCache.h"
+
+#include <QDataStream>
+#include <QFile>
+#include <QFileInfo>
+#include <QProcess>
+#include <QSaveFile>
+#include <QThread>
+#include <QtEndian>
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+namespace {
+constexpr quint32 kIndexMagic = 0x41564958; // "AVIX"
+constexpr quint32 kIndexVersion = 1;
+constexpr qint64 kMaxMoovBytes = 256LL * 1024 * 1024;
+constexpr qint64 kDefaultFrameMs = 40;
+
+quint32 fourcc(const char (&tag)[5]) {
+    return (quint32(quint8(tag[0])) << 24) | (quint32(quint8(tag[1])) << 16) |
+           (quint32(quint8(tag[2])) << 8) | quint32(quint8(tag[3]));
+}
+
+// Non-owning view over a box payload held in memory.
+struct BoxView {
+    const uchar* data = nullptr;
+    qint64 size = 0;
+
+    bool isNull() const { return data == nullptr; }
+    bool has(qint64 offset, qint64 bytes) const { return offset >= 0 && bytes >= 0 && offset + bytes <= size; }
+    quint32 u32(qint64 offset) const { return qFromBigEndian<quint32>(data + offset); }
+    quint64 u64(qint64 offset) const { return qFromBigEndian<quint64>(data + offset); }
+    quint8 u8(qint64 offset) const { return data[offset]; }
+};
+
+// Reads a box header at `offset` inside `parent`; returns the payload view and advances `offset` past the box.
+bool nextChildBox(const BoxView& parent, qint64& offset, quint32* type, BoxView* payload) {
+    if (!parent.has(offset, 8)) return false;
+    quint64 boxSize = parent.u32(offset);
+    *type = parent.u32(offset + 4);
+    qint64 headerSize = 8;
+    if (boxSize == 1) {
+        if (!parent.has(offset, 16)) return false;
+        boxSize = parent.u64(offset + 8);
+        headerSize = 16;
+    } else if (boxSize == 0) {
+        boxSize = quint64(parent.size - offset);
+    }
+    if (boxSize < quint64(headerSize) || !parent.has(offset, qint64(boxSize))) return false;
+
+    payload->data = parent.data + offset + headerSize;
+    payload->size = qint64(boxSize) - headerSize;
+    offset += qint64(boxSize);
+    return true;
+}
+
+BoxView findChild(const BoxView& parent, quint32 wanted) {
+    qint64 offset = 0;
+    quint32 type = 0;
+    BoxView payload;
+    while (nextChildBox(parent, offset, &type, &payload)) {
+        if (type == wanted) return payload;
+    }
+    return {};
+}
+
+// Locates the moov box by walking top-level headers on disk and loads only its payload.
+QByteArray readMoov(QFile& file) {
+    const qint64 fileSize = file.size();
+    qint64 offset = 0;
+    while (offset + 8 <= fileSize) {
+        if (!file.seek(offset)) return {};
+        const QByteArray header = file.read(16);
+        if (header.size() < 8) return {};
+        const auto* h = reinterpret_cast<const uchar*>(header.constData());
+        quint64 boxSize = qFromBigEndian<quint32>(h);
+        const quint32 type = qFromBigEndian<quint32>(h + 4);
+        qint64 headerSize = 8;
+        if (boxSize == 1) {
+            if (header.size() < 16) return {};
+            boxSize = qFromBigEndian<quint64>(h + 8);
+            headerSize = 16;
+        } else if (boxSize == 0) {
+            boxSize = quint64(fileSize - offset);
+        }
+        if (boxSize < quint64(headerSize)) return {};
+
+        if (type == fourcc("moov")) {
+            const qint64 payloadSize = qint64(boxSize) - headerSize;
+            if (payloadSize > kMaxMoovBytes) return {};
+            file.seek(offset + headerSize);
+            const QByteArray payload = file.read(payloadSize);
+            return payload.size() == payloadSize ? payload : QByteArray();
+        }
+        offset += qint64(boxSize);
+    }
+    return {};
+}
+
+struct StblTables {
+    BoxView stts, ctts, stss, stsz, stsc, stco;
+    bool co64 = false;
+};
+
+bool buildFromVideoTrak(const BoxView& trak, MediaIndex* out) {
+    const BoxView mdia = findChild(trak, fourcc("mdia"));
+    if (mdia.isNull()) return false;
+
+    const BoxView hdlr = findChild(mdia, fourcc("hdlr"));
+    if (hdlr.isNull() || !hdlr.has(8, 4) || hdlr.u32(8) != fourcc("vide")) return false;
+
+    const BoxView mdhd = findChild(mdia, fourcc("mdhd"));
+    if (mdhd.isNull() || !mdhd.has(0, 4)) return false;
+    quint32 timescale = 0;
+    quint64 mediaDuration = 0;
+    if (mdhd.u8(0) == 1) {
+        if (!mdhd.has(20, 12)) return false;
+        timescale = mdhd.u32(20);
+        mediaDuration = mdhd.u64(24);
+    } else {
+        if (!mdhd.has(12, 8)) return false;
+        timescale = mdhd.u32(12);
+        mediaDuration = mdhd.u32(16);
+    }
+    if (timescale == 0) return false;
+
+    // The first non-empty edit shifts media time so that presentation starts at 0.
+    qint64 mediaTimeShift = 0;
+    const BoxView edts = findChild(trak, fourcc("edts"));
+    const BoxView elst = edts.isNull() ? BoxView() : findChild(edts, fourcc("elst"));
+    if (!elst.isNull() && elst.has(0, 8)) {
+        const bool v1 = elst.u8(0) == 1;
+        const quint32 entries = elst.u32(4);
+        const qint64 entrySize = v1 ? 20 : 12;
+        for (quint32 i = 0; i < entries; ++i) {
+            const qint64 at = 8 + qint64(i) * entrySize;
+            if (!elst.has(at, entrySize)) break;
+            const qint64 mediaTime = v1 ? qint64(elst.u64(at + 8)) : qint64(qint32(elst.u32(at + 4)));
+            if (mediaTime >= 0) {
+                mediaTimeShift = mediaTime;
+                break;
+            }
+        }
+    }
+
+    const BoxView minf = findChild(mdia, fourcc("minf"));
+    const BoxView stbl = minf.isNull() ? BoxView() : findChild(minf, fourcc("stbl"));
+    if (stbl.isNull()) return false;
+
+    StblTables t;
+    t.stts = findChild(stbl, fourcc("stts"));
+    t.ctts = findChild(stbl, fourcc("ctts"));
+    t.stss = findChild(stbl, fourcc("stss"));
+    t.stsz = findChild(stbl, fourcc("stsz"));
+    t.stsc = findChild(stbl, fourcc("stsc"));
+    t.stco = findChild(stbl, fourcc("stco"));
+    if (t.stco.isNull()) {
+        t.stco = findChild(stbl, fourcc("co64"));
+        t.co64 = true;
+    }
+    if (t.stts.isNull() || t.stsz.isNull() || t.stsc.isNull() || t.stco.isNull()) return false;
+    if (!t.stts.has(0, 8) || !t.stsz.has(0, 12) || !t.stsc.has(0, 8) || !t.stco.has(0, 8)) return false;
+
+    const quint32 uniformSize = t.stsz.u32(4);
+    const quint32 sampleCount = t.stsz.u32(8);
+    if (sampleCount == 0) return false;
+    if (uniformSize == 0 && !t.stsz.has(12, qint64(sampleCount) * 4)) return false;
+
+    const quint32 sttsEntries = t.stts.u32(4);
+    const quint32 cttsEntries = (!t.ctts.isNull() && t.ctts.has(0, 8)) ? t.ctts.u32(4) : 0;
+    const quint32 stssEntries = (!t.stss.isNull() && t.stss.has(0, 8)) ? t.stss.u32(4) : 0;
+    const quint32 stscEntries = t.stsc.u32(4);
+    const quint32 chunkCount = t.stco.u32(4);
+    const qint64 chunkEntrySize = t.co64 ? 8 : 4;
+    if (!t.stts.has(8, qint64(sttsEntries) * 8) || !t.stsc.has(8, qint64(stscEntries) * 12) ||
+        !t.stco.has(8, qint64(chunkCount) * chunkEntrySize) || stscEntries == 0 || chunkCount == 0) {
+        return false;
+    }
+    if (cttsEntries > 0 && !t.ctts.has(8, qint64(cttsEntries) * 8)) return false;
+    if (stssEntries > 0 && !t.stss.has(8, qint64(stssEntries) * 4)) return false;
+
+    auto chunkOffset = [&](quint32 chunkIndex) -> qint64 {
+        const qint64 at = 8 + qint64(chunkIndex) * chunkEntrySize;
+        return t.co64 ? qint64(t.stco.u64(at)) : qint64(t.stco.u32(at));
+    };
+
+    MediaIndex result;
+    result.durationMs = qint64(mediaDuration * 1000 / timescale);
+    result.frameRate = mediaDuration > 0 ? double(sampleCount) * timescale / double(mediaDuration) : 0.0;
+
+    // Single pass over all samples, advancing the stts/ctts/stss/stsc cursors in lockstep.
+    quint32 sttsIdx = 0, sttsLeft = sttsEntries > 0 ? t.stts.u32(8) : 0;
+    quint32 cttsIdx = 0, cttsLeft = cttsEntries > 0 ? t.ctts.u32(8) : 0;
+    quint32 stssIdx = 0;
+    quint32 stscIdx = 0;
+    quint32 chunk = 0; // 0-based
+    quint32 samplesPerChunk = t.stsc.u32(8 + 4);
+    quint32 sampleInChunk = 0;
+    qint64 byteOffset = chunkOffset(0);
+    qint64 dts = 0;
+
+    for (quint32 sample = 0; sample < sampleCount; ++sample) {
+        if (sampleInChunk >= samplesPerChunk) {
+            ++chunk;
+            sampleInChunk = 0;
+            if (chunk >= chunkCount) break;
+            while (stscIdx + 1 < stscEntries && t.stsc.u32(8 + qint64(stscIdx + 1) * 12) <= chunk + 1) ++stscIdx;
+            samplesPerChunk = t.stsc.u32(8 + qint64(stscIdx) * 12 + 4);
+            if (samplesPerChunk == 0) break;
+            byteOffset = chunkOffset(chunk);
+        }
+
+        qint64 compositionOffset = 0;
+        if (cttsIdx < cttsEntries) {
+            compositionOffset = qint64(qint32(t.ctts.u32(8 + qint64(cttsIdx) * 8 + 4)));
+        }
+
+        const bool isSync = stssEntries == 0 || (stssIdx < stssEntries && t.stss.u32(8 + qint64(stssIdx) * 4) == sample + 1);
+        if (isSync) {
+            const qint64 pts = dts + compositionOffset - mediaTimeShift;
+            result.keyframes.push_back({std::max<qint64>(0, pts * 1000 / qint64(timescale)), byteOffset});
+            if (stssEntries > 0) ++stssIdx;
+        }
+
+        byteOffset += uniformSize != 0 ? uniformSize : t.stsz.u32(12 + qint64(sample) * 4);
+        ++sampleInChunk;
+
+        if (sttsIdx < sttsEntries) {
+            dts += t.stts.u32(8 + qint64(sttsIdx) * 8 + 4);
+            if (--sttsLeft == 0 && ++sttsIdx < sttsEntries) sttsLeft = t.stts.u32(8 + qint64(sttsIdx) * 8);
+        }
+        if (cttsIdx < cttsEntries && --cttsLeft == 0 && ++cttsIdx < cttsEntries) {
+            cttsLeft = t.ctts.u32(8 + qint64(cttsIdx) * 8);
+        }
+    }
+
+    if (result.keyframes.isEmpty()) return false;
+    std::sort(result.keyframes.begin(), result.keyframes.end(),
+              [](const MediaIndex::Keyframe& a, const MediaIndex::Keyframe& b) { return a.timeMs < b.timeMs; });
+    *out = std::move(result);
+    return true;
+}
+
+bool isIsoBmffExtension(const QString& path) {
+    const QString suffix = QFileInfo(path).suffix().toLower();
+    return suffix == QStringLiteral("mp4") || suffix == QStringLiteral("mov") ||
+           suffix == QStringLiteral("m4v") || suffix == QStringLiteral("3gp");
+}
+} // namespace
+
+qint64 MediaIndex::frameDurationMs() const {
+    if (frameRate <= 0.0) return kDefaultFrameMs;
+    return std::max<qint64>(1, qRound64(1000.0 / frameRate));
+}
+
+int MediaIndex::keyframeIndexAtOrBefore(qint64 posMs) const {
+    if (keyframes.isEmpty()) return -1;
+    const auto it = std::upper_bound(keyframes.cbegin(), keyframes.cend(), posMs,
+                                     [](qint64 ms, const Keyframe& k) { return ms < k.timeMs; });
+    if (it == keyframes.cbegin()) return 0;
+    return int(std::distance(keyframes.cbegin(), it)) - 1;
+}
+
+qint64 MediaIndex::keyframeAtOrBeforeMs(qint64 posMs) const {
+    const int i = keyframeIndexAtOrBefore(posMs);
+    return i < 0 ? posMs : keyframes.at(i).timeMs;
+}
+
+qint64 MediaIndex::nearestKeyframeMs(qint64 posMs) const {
+    const int i = keyframeIndexAtOrBefore(posMs);
+    if (i < 0) return posMs;
+    const qint64 before = keyframes.at(i).timeMs;
+    if (i + 1 >= keyframes.size()) return before;
+    const qint64 after = keyframes.at(i + 1).timeMs;
+    return (posMs - before) <= (after - posMs) ? before : after;
+}
+
+bool MediaIndex::saveToFile(const QString& path, const QString& fingerprint) const {
+    if (path.isEmpty() || keyframes.isEmpty()) return false;
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << kIndexMagic << kIndexVersion << fingerprint << durationMs << frameRate << qint32(keyframes.size());
+    for (const Keyframe& k : keyframes) out << k.timeMs << k.byteOffset;
+    return out.status() == QDataStream::Ok && file.commit();
+}
+
+bool MediaIndex::loadFromFile(const QString& path, const QString& fingerprint, MediaIndex* out) {
+    QFile file(path);
+    if (!out || fingerprint.isEmpty() || !file.open(QIODevice::ReadOnly)) return false;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+    quint32 magic = 0, version = 0;
+    QString storedFingerprint;
+    MediaIndex loaded;
+    qint32 count = 0;
+    in >> magic >> version >> storedFingerprint >> loaded.durationMs >> loaded.frameRate >> count;
+    if (magic != kIndexMagic || version != kIndexVersion || storedFingerprint != fingerprint || count <= 0) {
+        return false;
+    }
+
+    loaded.keyframes.resize(count);
+    for (Keyframe& k : loaded.keyframes) in >> k.timeMs >> k.byteOffset;
+    if (in.status() != QDataStream::Ok) return false;
+    *out = std::move(loaded);
+    return true;
+}
+
+bool MediaIndex::parseMp4(const QString& path, MediaIndex* out) {
+    QFile file(path);
+    if (!out || !file.open(QIODevice::ReadOnly)) return false;
+
+    const QByteArray moovBytes = readMoov(file);
+    if (moovBytes.isEmpty()) return false;
+
+    const BoxView moov{reinterpret_cast<const uchar*>(moovBytes.constData()), moovBytes.size()};
+    qint64 offset = 0;
+    quint32 type = 0;
+    BoxView child;
+    while (nextChildBox(moov, offset, &type, &child)) {
+        if (type == fourcc("trak") && buildFromVideoTrak(child, out)) return true;
+    }
+    return false;
+}
+
+bool MediaIndex::parseProbeCsv(const QByteArray& csv, MediaIndex* out) {
+    if (!out) return false;
+
+    MediaIndex result;
+    qint64 packetCount = 0;
+    double firstPts = -1.0;
+    double lastPts = 0.0;
+    for (const QByteArray& rawLine : csv.split('\n')) {
+        const QList<QByteArray> fields = rawLine.trimmed().split(',');
+        if (fields.size() < 3) continue;
+        bool ok = false;
+        const double pts = fields.at(0).toDouble(&ok);
+        if (!ok) continue;
+
+        ++packetCount;
+        if (firstPts < 0.0 || pts < firstPts) firstPts = pts;
+        lastPts = std::max(lastPts, pts);
+        if (!fields.at(2).startsWith('K')) continue;
+
+        bool posOk = false;
+        const qint64 pos = fields.at(1).toLongLong(&posOk);
+        result.keyframes.push_back({qRound64(pts * 1000.0), posOk ? pos : -1});
+    }
+    if (result.keyframes.isEmpty()) return false;
+
+    // MPEG-TS timestamps rarely start at zero; the player reports positions from the first packet.
+    const qint64 startMs = qRound64(std::max(0.0, firstPts) * 1000.0);
+    for (Keyframe& k : result.keyframes) k.timeMs = std::max<qint64>(0, k.timeMs - startMs);
+    std::sort(result.keyframes.begin(), result.keyframes.end(),
+              [](const Keyframe& a, const Keyframe& b) { return a.timeMs < b.timeMs; });
+
+    result.durationMs = qRound64((lastPts - std::max(0.0, firstPts)) * 1000.0);
+    if (result.durationMs > 0 && packetCount > 1) {
+        result.frameRate = double(packetCount - 1) * 1000.0 / double(result.durationMs);
+    }
+    *out = std::move(result);
+    return true;
+}
+
+MediaIndexer::MediaIndexer(QObject* parent) : QObject(parent) {}
+
+MediaIndexer::~MediaIndexer() { stopWorkers(); }
+
+void MediaIndexer::start(const QString& sourcePath) {
+    cancel();
+    sourcePath_ = sourcePath;
+    if (sourcePath.isEmpty()) return;
+
+    const quint64 generation = generation_;
+    struct Outcome {
+        MediaIndex index;
+        QString fingerprint;
+        QString cachePath;
+        bool ok = false;
+    };
+    auto outcome = std::make_shared<Outcome>();
+
+    // Fingerprinting, cache lookup and the native MP4 parse all touch disk; keep them off the UI thread.
+    QThread* thread = QThread::create([sourcePath, outcome]() {
+        outcome->fingerprint = MediaCache::sourceFingerprint(sourcePath);
+        outcome->cachePath = MediaCache::sidecarPath(sourcePath, QStringLiteral("avaidx"));
+        if (MediaIndex::loadFromFile(outcome->cachePath, outcome->fingerprint, &outcome->index)) {
+            outcome->ok = true;
+            return;
+        }
+        if (isIsoBmffExtension(sourcePath) && MediaIndex::parseMp4(sourcePath, &outcome->index)) {
+            outcome->index.saveToFile(outcome->cachePath, outcome->fingerprint);
+            outcome->ok = true;
+        }
+    });
+    parseThreads_.append(thread);
+    connect(thread, &QThread::finished, this, [this, thread, outcome, generation]() {
+        parseThreads_.removeOne(thread);
+        thread->deleteLater();
+        if (generation != generation_) return;
+
+        if (outcome->ok) {
+            publish(outcome->index);
+        } else {
+            startProbe(outcome->fingerprint, outcome->cachePath);
+        }
+    });
+    thread->setObjectName(QStringLiteral("MediaIndexer"));
+    thread->start(QThread::LowPriority);
+}
+
+void MediaIndexer::cancel() {
+    ++generation_;
+    ready_ = false;
+    index_ = MediaIndex();
+    if (probeProcess_) {
+        probeProcess_->disconnect(this);
+        probeProcess_->kill();
+        probeProcess_->waitForFinished(1000);
+        probeProcess_->deleteLater();
+        probeProcess_ = nullptr;
+    }
+}
+
+void MediaIndexer::startProbe(const QString& fingerprint, const QString& cachePath) {
+    const QString ffprobePath = ClipExporter::findFfprobe();
+    if (ffprobePath.isEmpty()) {
+        qWarning("MediaIndexer: ffprobe not found; seeking will use the backend's own index.");
+        return;
+    }
+
+    probeProcess_ = new QProcess(this);
+    QProcess* process = probeProcess_;
+    const quint64 generation = generation_;
+    connect(process, &QProcess::finished, this,
+            [this, process, generation, fingerprint, cachePath](int exitCode, QProcess::ExitStatus status) {
+                process->deleteLater();
+                if (probeProcess_ == process) probeProcess_ = nullptr;
+                if (generation != generation_ || status != QProcess::NormalExit || exitCode != 0) return;
+
+                MediaIndex index;
+                if (!MediaIndex::parseProbeCsv(process->readAllStandardOutput(), &index)) return;
+                index.saveToFile(cachePath, fingerprint);
+                publish(index);
+            });
+
+    process->start(ffprobePath, {
+        QStringLiteral("-v"), QStringLiteral("error"),
+        QStringLiteral("-select_streams"), QStringLiteral("v:0"),
+        QStringLiteral("-show_entries"), QStringLiteral("packet=pts_time,pos,flags"),
+        QStringLiteral("-of"), QStringLiteral("csv=p=0"),
+        sourcePath_,
+    });
+}
+
+void MediaIndexer::publish(const MediaIndex& index) {
+    index_ = index;
+    ready_ = index_.isValid();
+    if (ready_) emit indexReady();
+}
+
+void MediaIndexer::stopWorkers() {
+    cancel();
+    // The native parse only reads the moov box; waiting keeps the threads from outliving us.
+    for (QThread* thread : std::as_const(parseThreads_)) {
+        thread->wait();
+        delete thread;
+    }
+    parseThreads_.clear();
+}
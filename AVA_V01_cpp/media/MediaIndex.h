@@ -0,0 +1,75 @@
+#pragma once
+
+#include <QByteArray>
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QVector>
+#include <QtGlobal>
+
+class QProcess;
+class QThread;
+
+/// Keyframe map of the primary video stream: presentation time and byte offset of every sync sample.
+/// Built natively from the MP4/MOV sample tables, or from an ffprobe packet dump for MTS/MKV/AVI.
+struct MediaIndex {
+    struct Keyframe {
+        qint64 timeMs = 0;
+        qint64 byteOffset = -1;
+    };
+
+    QVector<Keyframe> keyframes; // ascending by timeMs
+    qint64 durationMs = 0;
+    double frameRate = 0.0;
+
+    bool isValid() const { return !keyframes.isEmpty(); }
+
+    /// Nominal frame duration (falls back to 40 ms / 25 fps when the stream rate is unknown).
+    qint64 frameDurationMs() const;
+
+    /// Index into keyframes of the last keyframe at or before posMs (0 when posMs precedes all).
+    int keyframeIndexAtOrBefore(qint64 posMs) const;
+    qint64 keyframeAtOrBeforeMs(qint64 posMs) const;
+    qint64 nearestKeyframeMs(qint64 posMs) const;
+
+    bool saveToFile(const QString& path, const QString& fingerprint) const;
+    static bool loadFromFile(const QString& path, const QString& fingerprint, MediaIndex* out);
+
+    /// Parses moov/trak/stbl of an ISO-BMFF file (mp4, mov, m4v). Reads only box headers and the moov payload.
+    static bool parseMp4(const QString& path, MediaIndex* out);
+
+    /// Parses `ffprobe -show_entries packet=pts_time,pos,flags -of csv=p=0` output.
+    static bool parseProbeCsv(const QByteArray& csv, MediaIndex* out);
+};
+
+/// Builds (or loads from the sidecar cache) the MediaIndex of a source file off the UI thread.
+class MediaIndexer final : public QObject {
+    Q_OBJECT
+
+public:
+    explicit MediaIndexer(QObject* parent = nullptr);
+    ~MediaIndexer() override;
+
+    void start(const QString& sourcePath);
+    void cancel();
+
+    bool isReady() const { return ready_; }
+    const MediaIndex& index() const { return index_; }
+    QString sourcePath() const { return sourcePath_; }
+
+signals:
+    void indexReady();
+
+private:
+    void startProbe(const QString& fingerprint, const QString& cachePath);
+    void publish(const MediaIndex& index);
+    void stopWorkers();
+
+    QString sourcePath_;
+    MediaIndex index_;
+    bool ready_ = false;
+    quint64 generation_ = 0;
+
+    QList<QThread*> parseThreads_;   // a quick reopen can leave an earlier parse still running
+    QProcess* probeProcess_ = nullptr;
+};
@@ -0,0 +1,196 @@
+#include "PlaySegments.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+namespace {
+constexpr qint64 kSmoothingMs = 3000;
+constexpr double kCameraWeight = 0.005;       // 1 px of pan per sample weighs like 0.5% luma change
+constexpr qint64 kMaxCutawayMs = 15000;       // shots shorter than this between two cuts are not live play
+constexpr qint64 kMaxLullMs = 5000;           // shorter quiet stretches stay inside the play
+constexpr qint64 kMinPlayMs = 6000;           // shorter bursts are restarts or celebrations
+constexpr qint64 kLeadInMs = 1500;
+constexpr qint64 kTailMs = 1500;
+constexpr qint64 kWhistleSnapMs = 3000;
+constexpr qint64 kWhistleRestartLeadMs = 500;
+constexpr qint64 kWhistleStopTailMs = 1000;
+constexpr qint64 kAnchorBeforeMs = 5000;
+constexpr qint64 kAnchorAfterMs = 3000;
+constexpr qint64 kMinJumpMs = 1000;           // segments closer than this are joined; tiny jumps look like glitches
+constexpr int kOtsuBins = 128;
+
+// Two-class split of the activity histogram that maximizes the between-class variance.
+double otsuThreshold(const std::vector<double>& values, const std::vector<char>& excluded) {
+    std::vector<double> sorted;
+    sorted.reserve(values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (!excluded[i]) sorted.push_back(values[i]);
+    }
+    if (sorted.empty()) return 0.0;
+    // Clip the top percent so a few bright flashes do not squash the histogram.
+    const size_t top = std::min(sorted.size() - 1, sorted.size() * 99 / 100);
+    std::nth_element(sorted.begin(), sorted.begin() + top, sorted.end());
+    const double hi = sorted[top];
+    const double lo = *std::min_element(sorted.begin(), sorted.end());
+    if (hi <= lo) return hi;
+
+    std::vector<double> histogram(kOtsuBins, 0.0);
+    const double binWidth = (hi - lo) / kOtsuBins;
+    for (const double v : sorted) {
+        const int bin = std::clamp(int((v - lo) / binWidth), 0, kOtsuBins - 1);
+        histogram[bin] += 1.0;
+    }
+
+    double total = 0.0;
+    double weightedTotal = 0.0;
+    for (int b = 0; b < kOtsuBins; ++b) {
+        total += histogram[b];
+        weightedTotal += b * histogram[b];
+    }
+    double below = 0.0;
+    double weightedBelow = 0.0;
+    double bestVariance = -1.0;
+    int bestBin = kOtsuBins / 2;
+    for (int b = 0; b < kOtsuBins - 1; ++b) {
+        below += histogram[b];
+        weightedBelow += b * histogram[b];
+        const double above = total - below;
+        if (below <= 0.0 || above <= 0.0) continue;
+        const double meanBelow = weightedBelow / below;
+        const double meanAbove = (weightedTotal - weightedBelow) / above;
+        const double variance = below * above * (meanBelow - meanAbove) * (meanBelow - meanAbove);
+        if (variance > bestVariance) {
+            bestVariance = variance;
+            bestBin = b;
+        }
+    }
+    return lo + (bestBin + 1) * binWidth;
+}
+
+// Sets runs of `value` shorter than `maxSamples` to the opposite value.
+void fillShortRuns(std::vector<char>& flags, char value, qint64 maxSamples) {
+    size_t i = 0;
+    while (i < flags.size()) {
+        if (flags[i] != value) {
+            ++i;
+            continue;
+        }
+        size_t end = i;
+        while (end < flags.size() && flags[end] == value) ++end;
+        const bool interior = i > 0 && end < flags.size();
+        // Lulls are only bridged between two plays; a short burst is dropped anywhere.
+        if (qint64(end - i) < maxSamples && (value == 1 || interior)) {
+            std::fill(flags.begin() + i, flags.begin() + end, char(!value));
+        }
+        i = end;
+    }
+}
+} // namespace
+
+QVector<PlaySegment> PlaySegment::detect(const SceneAnalysis& scenes,
+                                         const QVector<AudioEvent>& audioEvents,
+                                         const QVector<qint64>& anchorsMs) {
+    const int sampleCount = scenes.motionEnergy.size();
+    if (sampleCount == 0) return {};
+    constexpr qint64 kSampleMs = SceneAnalysis::kSampleMs;
+
+    // Moving average through prefix sums, O(samples) regardless of the window.
+    std::vector<double> prefix(sampleCount + 1, 0.0);
+    for (int i = 0; i < sampleCount; ++i) {
+        prefix[i + 1] = prefix[i] + scenes.motionEnergy.at(i) + kCameraWeight * scenes.cameraMotion.at(i);
+    }
+    const int halfWindow = int(kSmoothingMs / kSampleMs / 2);
+    std::vector<double> activity(sampleCount);
+    for (int i = 0; i < sampleCount; ++i) {
+        const int from = std::max(0, i - halfWindow);
+        const int to = std::min(sampleCount, i + halfWindow + 1);
+        activity[i] = (prefix[to] - prefix[from]) / (to - from);
+    }
+
+    std::vector<char> cutaway(sampleCount, 0);
+    for (int k = 0; k + 1 < scenes.cutsMs.size(); ++k) {
+        const qint64 shotMs = scenes.cutsMs.at(k + 1) - scenes.cutsMs.at(k);
+        if (shotMs >= kMaxCutawayMs) continue;
+        const int from = int(std::min<qint64>(sampleCount, scenes.cutsMs.at(k) / kSampleMs));
+        const int to = int(std::min<qint64>(sampleCount, scenes.cutsMs.at(k + 1) / kSampleMs));
+        std::fill(cutaway.begin() + from, cutaway.begin() + to, char(1));
+    }
+
+    const double threshold = otsuThreshold(activity, cutaway);
+    std::vector<char> live(sampleCount, 0);
+    for (int i = 0; i < sampleCount; ++i) live[i] = !cutaway[i] && activity[i] > threshold;
+    fillShortRuns(live, 0, kMaxLullMs / kSampleMs);
+    fillShortRuns(live, 1, kMinPlayMs / kSampleMs);
+
+    QVector<PlaySegment> segments;
+    for (int i = 0; i < sampleCount;) {
+        if (!live[i]) {
+            ++i;
+            continue;
+        }
+        int end = i;
+        while (end < sampleCount && live[end]) ++end;
+        segments.append({i * kSampleMs, end * kSampleMs});
+        i = end;
+    }
+
+    QVector<AudioEvent> whistles;
+    for (const AudioEvent& event : audioEvents) {
+        if (event.kind == AudioEvent::Kind::Whistle) whistles.append(event);
+    }
+    const auto whistleNear = [&whistles](qint64 ms, bool byEnd) -> const AudioEvent* {
+        const AudioEvent* best = nullptr;
+        qint64 bestDistance = kWhistleSnapMs + 1;
+        for (const AudioEvent& whistle : whistles) {
+            const qint64 distance = std::abs((byEnd ? whistle.endMs : whistle.startMs) - ms);
+            if (distance < bestDistance) {
+                bestDistance = distance;
+                best = &whistle;
+            }
+        }
+        return best;
+    };
+    for (PlaySegment& segment : segments) {
+        if (const AudioEvent* restart = whistleNear(segment.startMs, true)) {
+            segment.startMs = restart->startMs - kWhistleRestartLeadMs;
+        } else {
+            segment.startMs -= kLeadInMs;
+        }
+        if (const AudioEvent* stop = whistleNear(segment.endMs, false)) {
+            segment.endMs = stop->endMs + kWhistleStopTailMs;
+        } else {
+            segment.endMs += kTailMs;
+        }
+    }
+
+    for (const qint64 anchorMs : anchorsMs) {
+        const bool covered = std::any_of(segments.cbegin(), segments.cend(), [anchorMs](const PlaySegment& s) {
+            return anchorMs >= s.startMs && anchorMs <= s.endMs;
+        });
+        if (!covered) segments.append({anchorMs - kAnchorBeforeMs, anchorMs + kAnchorAfterMs});
+    }
+
+    const qint64 durationMs = scenes.durationMs();
+    std::sort(segments.begin(), segments.end(),
+              [](const PlaySegment& a, const PlaySegment& b) { return a.startMs < b.startMs; });
+    QVector<PlaySegment> merged;
+    for (PlaySegment segment : std::as_const(segments)) {
+        segment.startMs = std::clamp<qint64>(segment.startMs, 0, durationMs);
+        segment.endMs = std::clamp<qint64>(segment.endMs, 0, durationMs);
+        if (segment.endMs <= segment.startMs) continue;
+        if (!merged.isEmpty() && segment.startMs - merged.last().endMs < kMinJumpMs) {
+            merged.last().endMs = std::max(merged.last().endMs, segment.endMs);
+        } else {
+            merged.append(segment);
+        }
+    }
+    return merged;
+}
+
+qint64 PlaySegment::totalDurationMs(const QVector<PlaySegment>& segments) {
+    qint64 total = 0;
+    for (const PlaySegment& segment : segments) total += segment.durationMs();
+    return total;
+}
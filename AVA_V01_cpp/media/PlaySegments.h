@@ -0,0 +1,27 @@
+#pragma once
+
+#include "AudioEvents.h"
+#include "SceneAnalysis.h"
+
+#include <QVector>
+#include <QtGlobal>
+
+/// A stretch of live play kept by the condensed-game export.
+struct PlaySegment {
+    qint64 startMs = 0;
+    qint64 endMs = 0;
+
+    qint64 durationMs() const { return endMs - startMs; }
+
+    /// Splits a game into live play and dead time from the cached scene analysis.
+    /// Smoothed motion energy (plus camera pans, which follow the ball) is thresholded per game with
+    /// Otsu's method, short shots between two cuts (replays, close-ups) count as dead time, lulls
+    /// shorter than a restart are bridged and isolated bursts dropped. Whistles, when given, pull
+    /// segment edges onto the stoppage and restart; `anchorsMs` (tag positions) are always kept.
+    /// Linear in the number of samples, so it is recomputed rather than cached.
+    static QVector<PlaySegment> detect(const SceneAnalysis& scenes,
+                                       const QVector<AudioEvent>& audioEvents,
+                                       const QVector<qint64>& anchorsMs);
+
+    static qint64 totalDurationMs(const QVector<PlaySegment>& segments);
+};
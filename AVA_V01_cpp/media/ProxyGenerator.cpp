@@ -0,0 +1,164 @@
+#include "ProxyGenerator.h"
+
+#include "ClipExporter.h"
+#include "MediaCache.h"
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <QTimer>
+
+#include <algorithm>
+
+namespace {
+const QString kProxyCategory = QStringLiteral("proxies");
+constexpr int kProxyHeight = 540;
+} // namespace
+
+ProxyGenerator::ProxyGenerator(QObject* parent) : QObject(parent) {}
+
+ProxyGenerator::~ProxyGenerator() { cancel(); }
+
+QString ProxyGenerator::cachedProxyPath(const QString& sourcePath) {
+    return MediaCache::cacheFilePath(sourcePath, kProxyCategory, QStringLiteral("mp4"));
+}
+
+qint64 ProxyGenerator::cacheDiskUsageBytes() {
+    qint64 total = 0;
+    QDirIterator it(MediaCache::cacheDirectory(kProxyCategory), QDir::Files);
+    while (it.hasNext()) {
+        it.next();
+        total += it.fileInfo().size();
+    }
+    return total;
+}
+
+bool ProxyGenerator::useCachedProxy(const QString& sourcePath) {
+    cancel();
+    const QString path = cachedProxyPath(sourcePath);
+    if (path.isEmpty() || QFileInfo(path).size() <= 0) return false;
+
+    proxyPath_ = path;
+    state_ = State::Ready;
+    progressPercent_ = 100;
+    QTimer::singleShot(0, this, [this, path]() {
+        if (state_ == State::Ready && proxyPath_ == path) emit proxyReady(path);
+    });
+    return true;
+}
+
+void ProxyGenerator::start(const QString& sourcePath, qint64 sourceDurationMs) {
+    if (useCachedProxy(sourcePath)) return;
+
+    const QString ffmpegPath = ClipExporter::findFfmpeg();
+    proxyPath_ = cachedProxyPath(sourcePath);
+    if (ffmpegPath.isEmpty() || proxyPath_.isEmpty()) {
+        state_ = State::Failed;
+        emit failed(QStringLiteral("ffmpeg not found"));
+        return;
+    }
+
+    // Written under a temporary name and renamed on success, so an existing proxy is always complete.
+    partialPath_ = proxyPath_ + QStringLiteral(".partial.mp4");
+    QFile::remove(partialPath_);
+    sourceDurationMs_ = sourceDurationMs;
+    progressPercent_ = 0;
+    state_ = State::Running;
+
+    const QStringList ffmpegArgs = {
+        QStringLiteral("-hide_banner"), QStringLiteral("-nostdin"), QStringLiteral("-nostats"),
+        QStringLiteral("-y"),
+        QStringLiteral("-i"), sourcePath,
+        QStringLiteral("-map"), QStringLiteral("0:v:0"),
+        QStringLiteral("-map"), QStringLiteral("0:a:0?"),
+        // Deinterlace only frames flagged interlaced (AVCHD), then downscale keeping aspect.
+        QStringLiteral("-vf"), QStringLiteral("yadif=deint=interlaced,scale=-2:%1").arg(kProxyHeight),
+        QStringLiteral("-c:v"), QStringLiteral("libx264"),
+        QStringLiteral("-preset"), QStringLiteral("veryfast"),
+        QStringLiteral("-crf"), QStringLiteral("26"),
+        QStringLiteral("-g"), QStringLiteral("1"), // all-intra: every frame is a seek point
+        QStringLiteral("-pix_fmt"), QStringLiteral("yuv420p"),
+        QStringLiteral("-threads"), QStringLiteral("2"),
+        QStringLiteral("-c:a"), QStringLiteral("aac"),
+        QStringLiteral("-b:a"), QStringLiteral("128k"),
+        QStringLiteral("-movflags"), QStringLiteral("+faststart"),
+        QStringLiteral("-progress"), QStringLiteral("pipe:1"),
+        partialPath_,
+    };
+
+    process_ = new QProcess(this);
+    process_->setProcessChannelMode(QProcess::SeparateChannels);
+    process_->setStandardErrorFile(QProcess::nullDevice());
+    connect(process_, &QProcess::readyReadStandardOutput, this, &ProxyGenerator::onReadyReadStandardOutput);
+    connect(process_, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+            this, &ProxyGenerator::onProcessFinished);
+
+    // Run at the lowest CPU priority where `nice` is available so tagging and playback stay responsive.
+    const QString nicePath = QStandardPaths::findExecutable(QStringLiteral("nice"));
+    if (!nicePath.isEmpty()) {
+        process_->start(nicePath, QStringList{QStringLiteral("-n"), QStringLiteral("19"), ffmpegPath} + ffmpegArgs);
+    } else {
+        process_->start(ffmpegPath, ffmpegArgs);
+    }
+    emit progressChanged(progressPercent_);
+}
+
+void ProxyGenerator::cancel() {
+    if (process_) {
+        process_->disconnect(this);
+        if (process_->state() != QProcess::NotRunning) {
+            process_->kill();
+            process_->waitForFinished(2000);
+        }
+        process_->deleteLater();
+        process_ = nullptr;
+        QFile::remove(partialPath_);
+    }
+    state_ = State::Idle;
+    proxyPath_.clear();
+    partialPath_.clear();
+    progressPercent_ = 0;
+}
+
+void ProxyGenerator::onReadyReadStandardOutput() {
+    if (!process_) return;
+    while (process_->canReadLine()) {
+        const QByteArray line = process_->readLine().trimmed();
+        // -progress reports out_time_us (and the misnamed out_time_ms, also in microseconds).
+        if (!line.startsWith("out_time_us=") || sourceDurationMs_ <= 0) continue;
+        const qint64 outUs = line.mid(int(qstrlen("out_time_us="))).toLongLong();
+        const int percent = std::clamp(int(outUs / 10 / sourceDurationMs_), 0, 99);
+        if (percent != progressPercent_) {
+            progressPercent_ = percent;
+            emit progressChanged(percent);
+        }
+    }
+}
+
+void ProxyGenerator::onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus) {
+    process_->deleteLater();
+    process_ = nullptr;
+
+    const bool ok = exitStatus == QProcess::NormalExit && exitCode == 0 && QFileInfo(partialPath_).size() > 0;
+    if (!ok) {
+        QFile::remove(partialPath_);
+        state_ = State::Failed;
+        emit failed(QStringLiteral("ffmpeg exited with code %1").arg(exitCode));
+        return;
+    }
+
+    QFile::remove(proxyPath_);
+    if (!QFile::rename(partialPath_, proxyPath_)) {
+        QFile::remove(partialPath_);
+        state_ = State::Failed;
+        emit failed(QStringLiteral("could not move proxy into the cache"));
+        return;
+    }
+
+    state_ = State::Ready;
+    progressPercent_ = 100;
+    emit progressChanged(progressPercent_);
+    emit proxyReady(proxyPath_);
+}
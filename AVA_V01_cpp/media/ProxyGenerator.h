@@ -0,0 +1,48 @@
+#pragma once
+
+#include <QObject>
+#include <QProcess>
+#include <QString>
+#include <QtGlobal>
+
+/// Builds an all-intra, 540p playback proxy of a source video with a low-priority ffmpeg process.
+/// Proxies live in the app cache keyed by the source fingerprint and are reused on reopen.
+/// Playback only: export always reads the original.
+class ProxyGenerator final : public QObject {
+    Q_OBJECT
+
+public:
+    enum class State { Idle, Running, Ready, Failed };
+
+    explicit ProxyGenerator(QObject* parent = nullptr);
+    ~ProxyGenerator() override;
+
+    /// Returns true (and emits proxyReady asynchronously) when a cached proxy already exists.
+    bool useCachedProxy(const QString& sourcePath);
+    void start(const QString& sourcePath, qint64 sourceDurationMs);
+    void cancel();
+
+    State state() const { return state_; }
+    int progressPercent() const { return progressPercent_; }
+    QString proxyPath() const { return state_ == State::Ready ? proxyPath_ : QString(); }
+
+    static QString cachedProxyPath(const QString& sourcePath);
+    static qint64 cacheDiskUsageBytes();
+
+signals:
+    void progressChanged(int percent);
+    void proxyReady(const QString& proxyPath);
+    void failed(const QString& message);
+
+private slots:
+    void onReadyReadStandardOutput();
+    void onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
+
+private:
+    QProcess* process_ = nullptr;
+    State state_ = State::Idle;
+    QString proxyPath_;
+    QString partialPath_;
+    qint64 sourceDurationMs_ = 0;
+    int progressPercent_ = 0;
+};
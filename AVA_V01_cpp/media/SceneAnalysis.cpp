@@ -0,0 +1,390 @@
+#include "SceneAnalysis.h"
+
+#include "ClipExporter.h"
+#include "MediaCache.h"
+#include "MediaIndex.h"
+
+#include <QDataStream>
+#include <QFile>
+#include <QProcess>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QThread>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace {
+constexpr quint32 kSceneMagic = 0x41565343; // "AVSC"
+constexpr quint32 kSceneVersion = 1;
+const QString kSceneCategory = QStringLiteral("scenes");
+
+constexpr int kHistogramBins = 32;
+constexpr int kMaxShiftX = 4;                 // ~6% of the frame width per 100 ms covers fast broadcast pans
+constexpr int kMaxShiftY = 2;
+
+constexpr float kCutMinDiff = 0.3f;           // half the luma histogram has to move
+constexpr float kCutContrast = 3.0f;          // ... and stand this far above the neighbourhood
+constexpr int kCutNeighbourhood = 10;         // samples either side (1 s)
+constexpr int kMinShotSamples = 5;            // cuts closer than 500 ms are one transition
+
+constexpr qint64 kMinSegmentMs = 60 * 1000;   // shorter ranges are not worth another ffmpeg
+constexpr int kStartTimeoutMs = 5000;
+constexpr int kPollMs = 200;                  // how quickly a worker notices cancel()
+
+int sadRows(const uchar* a, const uchar* b, int width) {
+    int sum = 0;
+    for (int x = 0; x < width; ++x) sum += std::abs(int(a[x]) - int(b[x]));
+    return sum;
+}
+} // namespace
+
+struct SceneSegment {
+    qint64 startMs = 0;
+    qint64 durationMs = -1;                   // -1 decodes to the end of the file
+    int firstSample = 0;
+    int sampleCount = 0;
+    QVector<float> histogramDiffs;
+    QVector<float> motionEnergy;
+    QVector<float> cameraMotion;
+    QByteArray firstFrame;                    // stitched against the previous range's last frame
+    QByteArray lastFrame;
+    bool ok = false;
+};
+
+struct SceneAnalysisJob {
+    QString ffmpegPath;
+    QString nicePath;
+    QString sourcePath;
+    QVector<SceneSegment> segments;           // sized before the workers start; each owns one entry
+    std::atomic<bool> cancelled{false};
+};
+
+namespace {
+void analyzeSegment(SceneAnalysisJob& job, SceneSegment& segment) {
+    constexpr int kFrameBytes = SceneFrameAnalyzer::kFrameBytes;
+
+    QStringList ffmpegArgs = {
+        QStringLiteral("-hide_banner"), QStringLiteral("-nostdin"), QStringLiteral("-nostats"),
+        QStringLiteral("-loglevel"), QStringLiteral("error"),
+        QStringLiteral("-threads"), QStringLiteral("1"),               // ranges already run in parallel
+        QStringLiteral("-skip_loop_filter"), QStringLiteral("all"),    // deblocking is invisible at 64x36
+        QStringLiteral("-ss"), QString::number(segment.startMs / 1000.0, 'f', 3),
+        QStringLiteral("-i"), job.sourcePath,
+    };
+    if (segment.durationMs > 0) {
+        ffmpegArgs << QStringLiteral("-t") << QString::number(segment.durationMs / 1000.0, 'f', 3);
+    }
+    ffmpegArgs << QStringLiteral("-an") << QStringLiteral("-sn") << QStringLiteral("-dn")
+               << QStringLiteral("-map") << QStringLiteral("0:v:0")
+               << QStringLiteral("-vf")
+               << QStringLiteral("fps=%1,scale=%2:%3:flags=area,format=gray")
+                      .arg(1000 / SceneAnalysis::kSampleMs)
+                      .arg(SceneFrameAnalyzer::kFrameWidth)
+                      .arg(SceneFrameAnalyzer::kFrameHeight)
+               << QStringLiteral("-f") << QStringLiteral("rawvideo")
+               << QStringLiteral("pipe:1");
+
+    QProcess process;
+    process.setProcessChannelMode(QProcess::SeparateChannels);
+    process.setStandardErrorFile(QProcess::nullDevice());
+    if (!job.nicePath.isEmpty()) {
+        process.start(job.nicePath, QStringList{QStringLiteral("-n"), QStringLiteral("19"), job.ffmpegPath} + ffmpegArgs);
+    } else {
+        process.start(job.ffmpegPath, ffmpegArgs);
+    }
+    if (!process.waitForStarted(kStartTimeoutMs)) return;
+
+    segment.histogramDiffs.fill(-1.0f, segment.sampleCount);
+    segment.motionEnergy.fill(0.0f, segment.sampleCount);
+    segment.cameraMotion.fill(0.0f, segment.sampleCount);
+
+    std::vector<uchar> previous(kFrameBytes);
+    int frame = 0;                            // frames measured; stops at sampleCount
+    QByteArray pending;
+    const auto consume = [&]() {
+        pending += process.readAllStandardOutput();
+        int offset = 0;
+        for (; pending.size() - offset >= kFrameBytes; offset += kFrameBytes) {
+            // fps rounding may add a frame past the range; it is dropped without touching `previous`,
+            // so lastFrame stays the range's own last sample and the seam with the next range lines up.
+            if (frame >= segment.sampleCount) continue;
+            const auto* luma = reinterpret_cast<const uchar*>(pending.constData() + offset);
+            if (frame == 0) {
+                segment.firstFrame = QByteArray(pending.constData() + offset, kFrameBytes);
+            } else {
+                const SceneFrameAnalyzer::Measure m = SceneFrameAnalyzer::compare(previous.data(), luma);
+                segment.histogramDiffs[frame] = m.histogramDiff;
+                segment.motionEnergy[frame] = m.motionEnergy;
+                segment.cameraMotion[frame] = m.cameraMotion;
+            }
+            std::memcpy(previous.data(), luma, kFrameBytes);
+            ++frame;
+        }
+        pending.remove(0, offset);
+    };
+
+    while (process.state() != QProcess::NotRunning) {
+        if (job.cancelled.load(std::memory_order_relaxed)) {
+            process.kill();
+            process.waitForFinished(1000);
+            return;
+        }
+        if (process.waitForReadyRead(kPollMs)) consume();
+    }
+    consume();
+
+    if (frame > 0) {
+        segment.lastFrame = QByteArray(reinterpret_cast<const char*>(previous.data()), kFrameBytes);
+    }
+    segment.ok = process.exitStatus() == QProcess::NormalExit && process.exitCode() == 0
+                 && (frame > 0 || segment.sampleCount == 0);
+}
+} // namespace
+
+float SceneAnalysis::motionAt(qint64 positionMs) const {
+    if (motionEnergy.isEmpty()) return 0.0f;
+    const qint64 sample = std::clamp<qint64>(positionMs / kSampleMs, 0, motionEnergy.size() - 1);
+    return motionEnergy.at(int(sample));
+}
+
+qint64 SceneAnalysis::nearestCutMs(qint64 positionMs) const {
+    if (cutsMs.isEmpty()) return -1;
+    const auto it = std::lower_bound(cutsMs.cbegin(), cutsMs.cend(), positionMs);
+    if (it == cutsMs.cbegin()) return *it;
+    if (it == cutsMs.cend()) return cutsMs.last();
+    return (*it - positionMs) < (positionMs - *(it - 1)) ? *it : *(it - 1);
+}
+
+bool SceneAnalysis::saveToFile(const QString& path, const QString& fingerprint) const {
+    if (path.isEmpty()) return false;
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << kSceneMagic << kSceneVersion << fingerprint << cutsMs << motionEnergy << cameraMotion;
+    return out.status() == QDataStream::Ok && file.commit();
+}
+
+bool SceneAnalysis::loadFromFile(const QString& path, const QString& fingerprint, SceneAnalysis* out) {
+    QFile file(path);
+    if (!out || fingerprint.isEmpty() || !file.open(QIODevice::ReadOnly)) return false;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+    quint32 magic = 0, version = 0;
+    QString storedFingerprint;
+    in >> magic >> version >> storedFingerprint;
+    if (magic != kSceneMagic || version != kSceneVersion || storedFingerprint != fingerprint) return false;
+
+    SceneAnalysis loaded;
+    in >> loaded.cutsMs >> loaded.motionEnergy >> loaded.cameraMotion;
+    if (in.status() != QDataStream::Ok || loaded.cameraMotion.size() != loaded.motionEnergy.size()) return false;
+    *out = std::move(loaded);
+    return true;
+}
+
+SceneFrameAnalyzer::Measure SceneFrameAnalyzer::compare(const uchar* previous, const uchar* current) {
+    Measure measure;
+
+    int histPrevious[kHistogramBins] = {};
+    int histCurrent[kHistogramBins] = {};
+    for (int i = 0; i < kFrameBytes; ++i) {
+        ++histPrevious[previous[i] >> 3];
+        ++histCurrent[current[i] >> 3];
+    }
+    int histDistance = 0;
+    for (int b = 0; b < kHistogramBins; ++b) histDistance += std::abs(histPrevious[b] - histCurrent[b]);
+    measure.histogramDiff = float(histDistance) / float(2 * kFrameBytes);
+
+    // Exhaustive search over small shifts; the margin keeps every shifted read inside the frame.
+    constexpr int kInnerWidth = kFrameWidth - 2 * kMaxShiftX;
+    constexpr int kInnerHeight = kFrameHeight - 2 * kMaxShiftY;
+    int bestSad = std::numeric_limits<int>::max();
+    int bestDx = 0;
+    int bestDy = 0;
+    for (int dy = -kMaxShiftY; dy <= kMaxShiftY; ++dy) {
+        for (int dx = -kMaxShiftX; dx <= kMaxShiftX; ++dx) {
+            int sad = 0;
+            for (int y = kMaxShiftY; y < kFrameHeight - kMaxShiftY && sad < bestSad; ++y) {
+                sad += sadRows(current + y * kFrameWidth + kMaxShiftX,
+                               previous + (y + dy) * kFrameWidth + kMaxShiftX + dx, kInnerWidth);
+            }
+            // Prefer the smaller shift on ties so a static shot does not drift.
+            if (sad < bestSad || (sad == bestSad && dx * dx + dy * dy < bestDx * bestDx + bestDy * bestDy)) {
+                bestSad = sad;
+                bestDx = dx;
+                bestDy = dy;
+            }
+        }
+    }
+    measure.motionEnergy = float(bestSad) / float(255 * kInnerWidth * kInnerHeight);
+    measure.cameraMotion = float(std::sqrt(double(bestDx * bestDx + bestDy * bestDy)));
+    return measure;
+}
+
+QVector<qint64> SceneFrameAnalyzer::detectCuts(const QVector<float>& histogramDiffs) {
+    QVector<qint64> cuts;
+    int lastCut = -1;
+    float lastCutDiff = 0.0f;
+    for (int i = 0; i < histogramDiffs.size(); ++i) {
+        const float diff = histogramDiffs.at(i);
+        if (diff < kCutMinDiff) continue;
+
+        double neighbourhood = 0.0;
+        int neighbours = 0;
+        const int from = std::max(0, i - kCutNeighbourhood);
+        const int to = std::min(int(histogramDiffs.size()) - 1, i + kCutNeighbourhood);
+        for (int j = from; j <= to; ++j) {
+            if (std::abs(j - i) <= 1 || histogramDiffs.at(j) < 0.0f) continue;
+            neighbourhood += histogramDiffs.at(j);
+            ++neighbours;
+        }
+        const double local = neighbours > 0 ? neighbourhood / neighbours : 0.0;
+        if (diff < kCutContrast * local + 0.05) continue;
+
+        if (lastCut >= 0 && i - lastCut < kMinShotSamples) {
+            if (diff <= lastCutDiff) continue;
+            cuts.removeLast();  // keep the sharper change of one transition
+        }
+        cuts.append(qint64(i) * SceneAnalysis::kSampleMs);
+        lastCut = i;
+        lastCutDiff = diff;
+    }
+    return cuts;
+}
+
+SceneAnalyzer::SceneAnalyzer(QObject* parent) : QObject(parent) {}
+
+SceneAnalyzer::~SceneAnalyzer() {
+    cancel();
+    // Teardown is the one place that joins: the threads must not outlive the analyzer.
+    for (QThread* thread : std::as_const(retired_)) {
+        thread->wait();
+        delete thread;
+    }
+}
+
+void SceneAnalyzer::start(const QString& sourcePath, const MediaIndex& index) {
+    cancel();
+    fingerprint_ = MediaCache::sourceFingerprint(sourcePath);
+    if (fingerprint_.isEmpty() || !index.isValid() || index.durationMs <= 0) return;
+    cachePath_ = MediaCache::cacheFilePath(sourcePath, kSceneCategory, QStringLiteral("avasc"));
+
+    if (SceneAnalysis::loadFromFile(cachePath_, fingerprint_, &analysis_)) {
+        emit analysisChanged();
+        return;
+    }
+
+    const QString ffmpegPath = ClipExporter::findFfmpeg();
+    if (ffmpegPath.isEmpty()) return;
+
+    auto job = std::make_shared<SceneAnalysisJob>();
+    job->ffmpegPath = ffmpegPath;
+    job->nicePath = QStandardPaths::findExecutable(QStringLiteral("nice"));
+    job->sourcePath = sourcePath;
+
+    // Split at keyframes so every worker starts decoding on a sync sample and no frame is decoded twice.
+    const int workerCount = int(std::clamp<qint64>(
+        std::min<qint64>(QThread::idealThreadCount() / 2, index.durationMs / kMinSegmentMs), 1, kMaxWorkers));
+    QVector<qint64> boundaries = {0};
+    for (int k = 1; k < workerCount; ++k) {
+        const qint64 split = index.keyframeAtOrBeforeMs(index.durationMs * k / workerCount);
+        if (split > boundaries.last()) boundaries.append(split);
+    }
+    const int totalSamples = int((index.durationMs + SceneAnalysis::kSampleMs - 1) / SceneAnalysis::kSampleMs);
+    job->segments.resize(boundaries.size());
+    for (int k = 0; k < boundaries.size(); ++k) {
+        SceneSegment& segment = job->segments[k];
+        segment.startMs = boundaries.at(k);
+        segment.firstSample = int((segment.startMs + SceneAnalysis::kSampleMs / 2) / SceneAnalysis::kSampleMs);
+        const bool isLast = k + 1 == boundaries.size();
+        segment.durationMs = isLast ? -1 : boundaries.at(k + 1) - segment.startMs;
+        const int endSample = isLast ? totalSamples
+                                     : int((boundaries.at(k + 1) + SceneAnalysis::kSampleMs / 2) / SceneAnalysis::kSampleMs);
+        segment.sampleCount = std::max(0, endSample - segment.firstSample);
+    }
+
+    job_ = job;
+    for (int k = 0; k < job->segments.size(); ++k) {
+        QThread* thread = QThread::create([job, k]() { analyzeSegment(*job, job->segments[k]); });
+        connect(thread, &QThread::finished, this, [this, job, thread]() {
+            thread->deleteLater();
+            if (retired_.removeOne(thread)) return;  // a cancelled run winding down
+            workers_.removeOne(thread);
+            if (workers_.isEmpty() && job == job_) finishJob();
+        });
+        thread->setObjectName(QStringLiteral("SceneAnalyzer-%1").arg(k));
+        workers_.append(thread);
+        thread->start(QThread::LowPriority);
+    }
+}
+
+void SceneAnalyzer::cancel() {
+    // Workers notice the flag within kPollMs and kill their ffmpeg; they are reaped when they finish
+    // rather than joined here, so closing or switching videos never waits on a decoder.
+    if (job_) job_->cancelled.store(true, std::memory_order_relaxed);
+    retired_ += workers_;
+    workers_.clear();
+    job_.reset();
+
+    const bool hadAnalysis = !analysis_.isEmpty();
+    analysis_ = SceneAnalysis();
+    cachePath_.clear();
+    fingerprint_.clear();
+    if (hadAnalysis) emit analysisChanged();
+}
+
+void SceneAnalyzer::finishJob() {
+    const std::shared_ptr<SceneAnalysisJob> job = std::move(job_);
+    for (const SceneSegment& segment : job->segments) {
+        if (!segment.ok) {
+            qWarning("SceneAnalyzer: ffmpeg failed on the range at %lld ms; nothing is cached", segment.startMs);
+            return;
+        }
+    }
+
+    const SceneSegment& tail = job->segments.last();
+    const int totalSamples = tail.firstSample + tail.sampleCount;
+    QVector<float> histogramDiffs(totalSamples, -1.0f);
+    SceneAnalysis result;
+    result.motionEnergy.fill(0.0f, totalSamples);
+    result.cameraMotion.fill(0.0f, totalSamples);
+    for (int k = 0; k < job->segments.size(); ++k) {
+        const SceneSegment& segment = job->segments.at(k);
+        const int count = std::min<int>(segment.sampleCount, segment.histogramDiffs.size());
+        std::copy_n(segment.histogramDiffs.cbegin(), count, histogramDiffs.begin() + segment.firstSample);
+        std::copy_n(segment.motionEnergy.cbegin(), count, result.motionEnergy.begin() + segment.firstSample);
+        std::copy_n(segment.cameraMotion.cbegin(), count, result.cameraMotion.begin() + segment.firstSample);
+
+        // Each range starts without a previous frame; measure the seam against the range before it.
+        const QByteArray& before = k > 0 ? job->segments.at(k - 1).lastFrame : QByteArray();
+        if (!before.isEmpty() && !segment.firstFrame.isEmpty() && segment.firstSample < totalSamples) {
+            const SceneFrameAnalyzer::Measure m = SceneFrameAnalyzer::compare(
+                reinterpret_cast<const uchar*>(before.constData()),
+                reinterpret_cast<const uchar*>(segment.firstFrame.constData()));
+            histogramDiffs[segment.firstSample] = m.histogramDiff;
+            result.motionEnergy[segment.firstSample] = m.motionEnergy;
+            result.cameraMotion[segment.firstSample] = m.cameraMotion;
+        }
+    }
+
+    result.cutsMs = SceneFrameAnalyzer::detectCuts(histogramDiffs);
+    // The frame pair across a cut is two unrelated pictures; its motion reading is meaningless.
+    for (const qint64 cutMs : std::as_const(result.cutsMs)) {
+        const int sample = int(cutMs / SceneAnalysis::kSampleMs);
+        result.motionEnergy[sample] = sample > 0 ? result.motionEnergy.at(sample - 1) : 0.0f;
+        result.cameraMotion[sample] = 0.0f;
+    }
+
+    analysis_ = std::move(result);
+    analysis_.saveToFile(cachePath_, fingerprint_);
+    emit analysisChanged();
+}
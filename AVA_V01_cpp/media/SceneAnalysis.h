@@ -0,0 +1,89 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+#include <memory>
+
+class QThread;
+struct MediaIndex;
+struct SceneAnalysisJob;
+
+/// Shot structure and activity of the primary video stream, sampled every kSampleMs.
+/// Cuts mark replays and cutaways in broadcast footage; motion energy is what moves on screen once
+/// camera pans are compensated, so a static wide shot of a stoppage reads low even while the camera drifts.
+struct SceneAnalysis {
+    static constexpr int kSampleMs = 100;
+
+    QVector<qint64> cutsMs;          // ascending; first sample of each new shot
+    QVector<float> motionEnergy;     // per sample, mean luma change after camera compensation (0..1)
+    QVector<float> cameraMotion;     // per sample, global shift in analysis pixels (64 px wide frame)
+
+    bool isEmpty() const { return motionEnergy.isEmpty(); }
+    qint64 durationMs() const { return qint64(motionEnergy.size()) * kSampleMs; }
+
+    float motionAt(qint64 positionMs) const;
+    /// Cut closest to `positionMs`, or -1 when the video has none.
+    qint64 nearestCutMs(qint64 positionMs) const;
+
+    bool saveToFile(const QString& path, const QString& fingerprint) const;
+    static bool loadFromFile(const QString& path, const QString& fingerprint, SceneAnalysis* out);
+};
+
+/// Per-frame measurements on kFrameWidth x kFrameHeight 8-bit luma. Pure computation, no I/O.
+class SceneFrameAnalyzer {
+public:
+    static constexpr int kFrameWidth = 64;
+    static constexpr int kFrameHeight = 36;
+    static constexpr int kFrameBytes = kFrameWidth * kFrameHeight;
+
+    struct Measure {
+        float histogramDiff = -1.0f;  // 0..1, -1 when there is no previous frame
+        float motionEnergy = 0.0f;
+        float cameraMotion = 0.0f;
+    };
+
+    /// Luma histogram distance plus the best global shift (block search on the whole frame) and the
+    /// residual difference left after applying it.
+    static Measure compare(const uchar* previous, const uchar* current);
+
+    /// Cuts are histogram jumps that stand well above their neighbourhood; a pan or a flash of
+    /// sunlight raises the whole neighbourhood and is not reported.
+    static QVector<qint64> detectCuts(const QVector<float>& histogramDiffs);
+};
+
+/// Builds (or loads from the cache) the SceneAnalysis of a source. The file is split at keyframes into
+/// up to kMaxWorkers ranges; each worker thread decodes its range at reduced resolution and frame rate
+/// (ffmpeg, low priority, gray rawvideo on a pipe) and measures it. Ranges are stitched and cuts detected
+/// once every worker is done.
+class SceneAnalyzer final : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr int kMaxWorkers = 4;
+
+    explicit SceneAnalyzer(QObject* parent = nullptr);
+    ~SceneAnalyzer() override;
+
+    /// Loads the cached analysis for `sourcePath` or starts analyzing it; `index` supplies the split points.
+    void start(const QString& sourcePath, const MediaIndex& index);
+    void cancel();
+    bool isRunning() const { return !workers_.isEmpty(); }
+
+    const SceneAnalysis& analysis() const { return analysis_; }
+
+signals:
+    void analysisChanged();          // a new analysis is available (or the previous one was cleared)
+
+private:
+    void finishJob();
+
+    SceneAnalysis analysis_;
+    std::shared_ptr<SceneAnalysisJob> job_;
+    QVector<QThread*> workers_;
+    QVector<QThread*> retired_;      // workers of a cancelled run, still shutting down their ffmpeg
+    QString cachePath_;
+    QString fingerprint_;
+};
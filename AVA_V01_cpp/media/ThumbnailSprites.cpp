@@ -0,0 +1,196 @@
+#include "ThumbnailSprites.h"
+
+#include "ClipExporter.h"
+#include "MediaCache.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <QThread>
+
+#include <utility>
+
+namespace {
+const QString kThumbsCategory = QStringLiteral("thumbs");
+constexpr int kThumbWidth = 160;
+constexpr int kColumns = 10;
+constexpr int kRows = 10;
+constexpr int kThumbsPerSheet = kColumns * kRows;   // 200 s of video per sheet
+constexpr int kDecodedSheetCacheSize = 8;           // ~46 MB of decoded 1600x900 sheets
+} // namespace
+
+ThumbnailSprites::ThumbnailSprites(QObject* parent) : QObject(parent) {
+    decodedSheets_.setMaxCost(kDecodedSheetCacheSize);
+}
+
+ThumbnailSprites::~ThumbnailSprites() {
+    cancel();
+    if (decodeThread_) {
+        decodeThread_->wait();  // one JPEG at most; its queued result dies with this object
+        delete decodeThread_;
+    }
+}
+
+QString ThumbnailSprites::sheetPath(int sheetIndex) const {
+    return QDir(sheetDir_).filePath(QStringLiteral("sheet_%1.jpg").arg(sheetIndex, 4, 10, QChar('0')));
+}
+
+void ThumbnailSprites::start(const QString& sourcePath) {
+    cancel();
+    finalDir_ = MediaCache::cacheFilePath(sourcePath, kThumbsCategory, QStringLiteral("sprites"));
+    if (finalDir_.isEmpty()) return;
+
+    sheetDir_ = finalDir_;
+    rescanSheets();
+    if (availableSheets_ > 0) return;  // complete set from an earlier session
+
+    const QString ffmpegPath = ClipExporter::findFfmpeg();
+    if (ffmpegPath.isEmpty()) return;
+
+    // Extract into a partial directory and rename it when done, so a cached set is always complete.
+    sheetDir_ = finalDir_ + QStringLiteral(".partial");
+    QDir(sheetDir_).removeRecursively();
+    QDir().mkpath(sheetDir_);
+
+    const QStringList ffmpegArgs = {
+        QStringLiteral("-hide_banner"), QStringLiteral("-nostdin"), QStringLiteral("-nostats"),
+        QStringLiteral("-y"),
+        QStringLiteral("-skip_frame"), QStringLiteral("nokey"),   // keyframes only: no inter-frame decoding
+        QStringLiteral("-i"), sourcePath,
+        QStringLiteral("-an"), QStringLiteral("-sn"),
+        QStringLiteral("-vf"), QStringLiteral("fps=1000/%1,scale=%2:-2,tile=%3x%4")
+                                   .arg(kIntervalMs).arg(kThumbWidth).arg(kColumns).arg(kRows),
+        QStringLiteral("-q:v"), QStringLiteral("5"),
+        QStringLiteral("-threads"), QStringLiteral("1"),
+        QStringLiteral("-start_number"), QStringLiteral("0"),
+        QStringLiteral("-atomic_writing"), QStringLiteral("1"),  // a sheet is visible only once fully written
+        QStringLiteral("-progress"), QStringLiteral("pipe:1"),
+        QDir(sheetDir_).filePath(QStringLiteral("sheet_%04d.jpg")),
+    };
+
+    process_ = new QProcess(this);
+    process_->setProcessChannelMode(QProcess::SeparateChannels);
+    process_->setStandardErrorFile(QProcess::nullDevice());
+    connect(process_, &QProcess::readyReadStandardOutput, this, &ThumbnailSprites::onReadyReadStandardOutput);
+    connect(process_, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+            this, &ThumbnailSprites::onProcessFinished);
+
+    const QString nicePath = QStandardPaths::findExecutable(QStringLiteral("nice"));
+    if (!nicePath.isEmpty()) {
+        process_->start(nicePath, QStringList{QStringLiteral("-n"), QStringLiteral("19"), ffmpegPath} + ffmpegArgs);
+    } else {
+        process_->start(ffmpegPath, ffmpegArgs);
+    }
+}
+
+void ThumbnailSprites::cancel() {
+    if (QProcess* process = std::exchange(process_, nullptr)) {
+        process->disconnect(this);
+        const QString partialDir = sheetDir_;
+        if (process->state() == QProcess::NotRunning) {
+            process->deleteLater();
+            QDir(partialDir).removeRecursively();
+        } else {
+            // Reaped when it exits instead of waited for, so switching videos never blocks on ffmpeg.
+            // A new extraction of the same source reuses the partial directory; leave it alone then.
+            connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this,
+                    [this, process, partialDir]() {
+                        process->deleteLater();
+                        if (partialDir != sheetDir_) QDir(partialDir).removeRecursively();
+                    });
+            process->kill();
+        }
+    }
+    sheetDir_.clear();
+    finalDir_.clear();
+    availableSheets_ = 0;
+    decodedSheets_.clear();
+    wantedSheet_ = -1;
+    ++generation_;
+}
+
+QImage ThumbnailSprites::thumbnailAt(qint64 positionMs) {
+    if (availableSheets_ <= 0 || positionMs < 0) return {};
+    const int slot = int((positionMs + kIntervalMs / 2) / kIntervalMs);
+    const int sheetIndex = slot / kThumbsPerSheet;
+    if (sheetIndex >= availableSheets_) return {};
+
+    const QImage* sheet = decodedSheets_.object(sheetIndex);
+    if (!sheet) {
+        decodeSheet(sheetIndex);  // a 1600x900 JPEG is too slow to decode on every hover miss
+        return {};
+    }
+
+    const int cell = slot % kThumbsPerSheet;
+    const int cellW = sheet->width() / kColumns;
+    const int cellH = sheet->height() / kRows;
+    return sheet->copy((cell % kColumns) * cellW, (cell / kColumns) * cellH, cellW, cellH);
+}
+
+void ThumbnailSprites::decodeSheet(int sheetIndex) {
+    if (decodeThread_) {
+        wantedSheet_ = sheetIndex;
+        return;
+    }
+    wantedSheet_ = -1;
+    const QString path = sheetPath(sheetIndex);
+    const quint64 generation = generation_;
+    decodeThread_ = QThread::create([this, path, sheetIndex, generation]() {
+        const QImage sheet(path);
+        QMetaObject::invokeMethod(
+            this, [this, generation, sheetIndex, sheet]() { onSheetDecoded(generation, sheetIndex, sheet); },
+            Qt::QueuedConnection);
+    });
+    decodeThread_->setObjectName(QStringLiteral("ThumbnailSprites"));
+    decodeThread_->start(QThread::LowPriority);
+}
+
+void ThumbnailSprites::onSheetDecoded(quint64 generation, int sheetIndex, const QImage& sheet) {
+    decodeThread_->wait();  // already past its last statement
+    delete decodeThread_;
+    decodeThread_ = nullptr;
+
+    if (generation == generation_ && !sheet.isNull()) {
+        decodedSheets_.insert(sheetIndex, new QImage(sheet));
+        emit thumbnailReady();
+    }
+    const int wanted = std::exchange(wantedSheet_, -1);
+    if (wanted >= 0 && wanted < availableSheets_ && !decodedSheets_.contains(wanted)) decodeSheet(wanted);
+}
+
+void ThumbnailSprites::rescanSheets() {
+    int count = 0;
+    while (QFileInfo(sheetPath(count)).size() > 0) ++count;
+    if (count != availableSheets_) {
+        availableSheets_ = count;
+        emit sheetsUpdated();
+    }
+}
+
+void ThumbnailSprites::onReadyReadStandardOutput() {
+    if (!process_) return;
+    bool progressed = false;
+    while (process_->canReadLine()) {
+        progressed = process_->readLine().startsWith("progress=") || progressed;
+    }
+    if (progressed) rescanSheets();
+}
+
+void ThumbnailSprites::onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus) {
+    process_->deleteLater();
+    process_ = nullptr;
+
+    const bool ok = exitStatus == QProcess::NormalExit && exitCode == 0;
+    rescanSheets();
+    if (!ok || availableSheets_ == 0) {
+        qWarning("ThumbnailSprites: ffmpeg exited with code %d", exitCode);
+        return;  // keep whatever sheets were written for this session; nothing is cached
+    }
+
+    QDir(finalDir_).removeRecursively();
+    if (QDir().rename(sheetDir_, finalDir_)) {
+        sheetDir_ = finalDir_;
+        decodedSheets_.clear();
+        ++generation_;  // a decode in flight read the old path
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <QCache>
+#include <QImage>
+#include <QObject>
+#include <QProcess>
+#include <QString>
+#include <QtGlobal>
+
+class QThread;
+
+/// Timeline hover thumbnails: a low-priority ffmpeg pass decodes keyframes only, samples one every
+/// kIntervalMs and tiles them into JPEG sprite sheets cached under the source fingerprint.
+/// Sheets become usable as soon as each one is written, so hovering works while extraction continues.
+/// Sheets are decoded on a worker thread, one at a time; a hover over a sheet not decoded yet returns
+/// a null image and thumbnailReady() follows once it is.
+class ThumbnailSprites final : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr qint64 kIntervalMs = 2000;
+
+    explicit ThumbnailSprites(QObject* parent = nullptr);
+    ~ThumbnailSprites() override;
+
+    /// Uses the cached sheets for `sourcePath` or starts extracting them in the background.
+    void start(const QString& sourcePath);
+    void cancel();
+    bool isRunning() const { return process_ != nullptr; }
+
+    /// Thumbnail nearest to `positionMs`, or a null image while its sheet is not extracted or decoded yet.
+    QImage thumbnailAt(qint64 positionMs);
+
+signals:
+    void sheetsUpdated();
+    /// A sheet finished decoding: a thumbnailAt() that just returned a null image may now succeed.
+    void thumbnailReady();
+
+private slots:
+    void onReadyReadStandardOutput();
+    void onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
+
+private:
+    void rescanSheets();
+    QString sheetPath(int sheetIndex) const;
+    void decodeSheet(int sheetIndex);
+    void onSheetDecoded(quint64 generation, int sheetIndex, const QImage& sheet);
+
+    QProcess* process_ = nullptr;
+    QString sheetDir_;          // directory the sheets are read from (partial while extracting)
+    QString finalDir_;
+    int availableSheets_ = 0;
+    QCache<int, QImage> decodedSheets_;
+    QThread* decodeThread_ = nullptr;   // at most one sheet decoding at a time
+    int wantedSheet_ = -1;              // latest sheet asked for while the worker was busy
+    quint64 generation_ = 0;            // bumped whenever the sheet files change; drops stale decodes
+};
@@ -0,0 +1,117 @@
+#include "GameStateTimeline.h"
+
+#include <QStringView>
+
+#include <algorithm>
+
+namespace {
+const TagSymbol& cardEvent() {
+  static const TagSymbol symbol(QStringLiteral("Card"));
+  return symbol;
+}
+
+const TagSymbol& penaltyCornerEvent() {
+  static const TagSymbol symbol(QStringLiteral("PC"));
+  return symbol;
+}
+
+// Card follow-ups start with the color: "Yellow → <team>".
+bool cardCounterFor(const QString& followUpEvent, GameState::Counter* counter) {
+  const QStringView color = QStringView(followUpEvent).left(followUpEvent.indexOf(QStringLiteral(" → ")));
+  if (color == QStringLiteral("Green")) *counter = GameState::Counter::GreenCard;
+  else if (color == QStringLiteral("Yellow")) *counter = GameState::Counter::YellowCard;
+  else if (color == QStringLiteral("Red")) *counter = GameState::Counter::RedCard;
+  else return false;
+  return true;
+}
+} // namespace
+
+int& GameState::Side::counter(Counter which) {
+  switch (which) {
+  case Counter::Goal: return goals;
+  case Counter::GreenCard: return greenCards;
+  case Counter::YellowCard: return yellowCards;
+  case Counter::RedCard: return redCards;
+  case Counter::PenaltyCorner: return penaltyCorners;
+  }
+  return goals;
+}
+
+void GameStateTimeline::clear() {
+  eventMs_.clear();
+  eventIds_.clear();
+  effects_.clear();
+  cumulative_.clear();
+  positionById_.clear();
+}
+
+void GameStateTimeline::addTag(quint64 tagId, qint64 positionMs, TagSymbol team, TagSymbol mainEvent,
+                               TagSymbol followUpEvent) {
+  Effect effect;
+  if (team == TagVocabulary::home()) effect.home = true;
+  else if (team == TagVocabulary::away()) effect.home = false;
+  else return;
+
+  if (mainEvent == TagVocabulary::goal()) effect.counter = GameState::Counter::Goal;
+  else if (mainEvent == penaltyCornerEvent()) effect.counter = GameState::Counter::PenaltyCorner;
+  else if (mainEvent != cardEvent() || !cardCounterFor(followUpEvent.text(), &effect.counter)) return;
+
+  const int slot = slotFor(positionMs, tagId);
+  eventMs_.insert(slot, positionMs);
+  eventIds_.insert(slot, tagId);
+  effects_.insert(slot, effect);
+  cumulative_.insert(slot, GameState());
+  positionById_.insert(tagId, positionMs);
+  accumulateFrom(slot);
+}
+
+void GameStateTimeline::removeTag(quint64 tagId) {
+  const auto it = positionById_.constFind(tagId);
+  if (it == positionById_.cend()) return;
+  const int slot = slotFor(it.value(), tagId);
+  positionById_.erase(it);
+  if (slot >= eventIds_.size() || eventIds_.at(slot) != tagId) return;
+  eventMs_.removeAt(slot);
+  eventIds_.removeAt(slot);
+  effects_.removeAt(slot);
+  cumulative_.removeAt(slot);
+  accumulateFrom(slot);
+}
+
+int GameStateTimeline::slotFor(qint64 positionMs, quint64 tagId) const {
+  const auto first = std::lower_bound(eventMs_.cbegin(), eventMs_.cend(), positionMs);
+  const auto last = std::upper_bound(first, eventMs_.cend(), positionMs);
+  const auto idsBegin = eventIds_.cbegin() + (first - eventMs_.cbegin());
+  const auto idsEnd = eventIds_.cbegin() + (last - eventMs_.cbegin());
+  return static_cast<int>(std::lower_bound(idsBegin, idsEnd, tagId) - eventIds_.cbegin());
+}
+
+void GameStateTimeline::accumulateFrom(int slot) {
+  GameState running = slot > 0 ? cumulative_.at(slot - 1) : GameState();
+  for (int i = slot; i < cumulative_.size(); ++i) {
+    const Effect& effect = effects_.at(i);
+    ++(effect.home ? running.home : running.away).counter(effect.counter);
+    cumulative_[i] = running;
+  }
+}
+
+GameState GameStateTimeline::stateAt(qint64 positionMs) const {
+  const int after = static_cast<int>(
+      std::upper_bound(eventMs_.cbegin(), eventMs_.cend(), positionMs) - eventMs_.cbegin());
+  return after > 0 ? cumulative_.at(after - 1) : GameState();
+}
+
+QVector<GameStateChange> GameStateTimeline::changesInRange(qint64 fromMs, qint64 toMs) const {
+  QVector<GameStateChange> changes;
+  if (toMs <= fromMs) return changes;
+  const int first = static_cast<int>(
+      std::upper_bound(eventMs_.cbegin(), eventMs_.cend(), fromMs) - eventMs_.cbegin());
+  const int last = static_cast<int>(
+      std::upper_bound(eventMs_.cbegin(), eventMs_.cend(), toMs) - eventMs_.cbegin());
+  for (int i = first; i < last; ++i) {
+    // Only the last event at a position carries the state from there on.
+    if (i + 1 < last && eventMs_.at(i + 1) == eventMs_.at(i)) continue;
+    changes.append({eventMs_.at(i), cumulative_.at(i)});
+  }
+  return changes;
+}
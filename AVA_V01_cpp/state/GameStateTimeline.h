@@ -0,0 +1,73 @@
+#pragma once
+
+#include "TagSymbol.h"
+
+#include <QHash>
+#include <QVector>
+#include <QtGlobal>
+
+/// Score, cards and penalty corners of one game at a point in time.
+struct GameState {
+  enum class Counter : quint8 { Goal, GreenCard, YellowCard, RedCard, PenaltyCorner };
+
+  struct Side {
+    int goals = 0;
+    int greenCards = 0;
+    int yellowCards = 0;
+    int redCards = 0;
+    int penaltyCorners = 0;
+
+    int& counter(Counter which);
+    bool operator==(const Side& other) const {
+      return goals == other.goals && greenCards == other.greenCards && yellowCards == other.yellowCards
+             && redCards == other.redCards && penaltyCorners == other.penaltyCorners;
+    }
+    bool operator!=(const Side& other) const { return !(*this == other); }
+  };
+
+  Side home;
+  Side away;
+
+  bool operator==(const GameState& other) const { return home == other.home && away == other.away; }
+  bool operator!=(const GameState& other) const { return !(*this == other); }
+};
+
+/// A position where the game state changed, with the state from there on.
+struct GameStateChange {
+  qint64 positionMs = 0;
+  GameState state;
+};
+
+/// Game state over time, event-sourced from the tag stream. Only tags that change the state
+/// (goals, cards and penalty corners for the home or away team) are kept, sorted by position
+/// next to a prefix sum of their effects, so "state at t" and "changes in a range" are binary
+/// searches. An add or remove re-accumulates the prefix from the touched event onward; a game
+/// has a few dozen such events.
+class GameStateTimeline {
+public:
+  void clear();
+  /// Tags that do not change the state are ignored.
+  void addTag(quint64 tagId, qint64 positionMs, TagSymbol team, TagSymbol mainEvent, TagSymbol followUpEvent);
+  void removeTag(quint64 tagId);
+
+  /// State after every event at or before positionMs.
+  GameState stateAt(qint64 positionMs) const;
+  /// Changes with fromMs < positionMs <= toMs; events sharing a position are reported once.
+  QVector<GameStateChange> changesInRange(qint64 fromMs, qint64 toMs) const;
+  int eventCount() const { return eventMs_.size(); }
+
+private:
+  struct Effect {
+    bool home = true;
+    GameState::Counter counter = GameState::Counter::Goal;
+  };
+
+  int slotFor(qint64 positionMs, quint64 tagId) const;
+  void accumulateFrom(int slot);
+
+  QVector<qint64> eventMs_;          // sorted
+  QVector<quint64> eventIds_;        // parallel; ascending within one position
+  QVector<Effect> effects_;          // parallel
+  QVector<GameState> cumulative_;    // parallel; state after the event
+  QHash<quint64, qint64> positionById_;
+};
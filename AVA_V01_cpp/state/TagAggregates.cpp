@@ -0,0 +1,47 @@
+#include "TagAggregates.h"
+
+void TagAggregates::add(TagSymbol team, TagSymbol mainEvent, TagSymbol followUpEvent, TagSymbol period) {
+  ++cells_[Key{team, mainEvent, followUpEvent, period}];
+}
+
+void TagAggregates::remove(TagSymbol team, TagSymbol mainEvent, TagSymbol followUpEvent, TagSymbol period) {
+  const auto it = cells_.find(Key{team, mainEvent, followUpEvent, period});
+  if (it == cells_.end()) return;
+  if (--it.value() <= 0) cells_.erase(it);
+}
+
+bool TagAggregates::matches(const Key& key, const Filter& filter) {
+  const auto teamMatches = [&key, &filter]() {
+    if (*filter.team == key.team) return true;
+    return filter.teamIgnoresCase && filter.team->text().compare(key.team.text(), Qt::CaseInsensitive) == 0;
+  };
+  return (!filter.team || teamMatches())
+         && (!filter.mainEvent || *filter.mainEvent == key.mainEvent)
+         && (!filter.followUpEvent || *filter.followUpEvent == key.followUpEvent)
+         && (!filter.period || *filter.period == key.period);
+}
+
+int TagAggregates::count(const Filter& filter) const {
+  int total = 0;
+  for (auto it = cells_.cbegin(); it != cells_.cend(); ++it) {
+    if (matches(it.key(), filter)) total += it.value();
+  }
+  return total;
+}
+
+QHash<TagSymbol, int> TagAggregates::mainEventCounts(const Filter& filter) const {
+  QHash<TagSymbol, int> counts;
+  for (auto it = cells_.cbegin(); it != cells_.cend(); ++it) {
+    if (matches(it.key(), filter)) counts[it.key().mainEvent] += it.value();
+  }
+  return counts;
+}
+
+QHash<TagSymbol, QHash<TagSymbol, int>> TagAggregates::followUpCounts(const Filter& filter) const {
+  QHash<TagSymbol, QHash<TagSymbol, int>> counts;
+  for (auto it = cells_.cbegin(); it != cells_.cend(); ++it) {
+    if (it.key().followUpEvent.isEmpty() || !matches(it.key(), filter)) continue;
+    counts[it.key().mainEvent][it.key().followUpEvent] += it.value();
+  }
+  return counts;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "TagSymbol.h"
+
+#include <QHash>
+#include <QtGlobal>
+
+#include <optional>
+
+/// Tag counts keyed by (team, main event, follow-up path, period), kept in step with TagSession.
+/// add/remove are O(1). Queries walk the populated cells, which grow with the vocabulary in use
+/// (a few hundred per game) rather than with the number of tags.
+class TagAggregates {
+public:
+  /// Unset fields match everything; a set field (the empty symbol included) must match exactly.
+  struct Filter {
+    std::optional<TagSymbol> team;
+    std::optional<TagSymbol> mainEvent;
+    std::optional<TagSymbol> followUpEvent;
+    std::optional<TagSymbol> period;
+    bool teamIgnoresCase = false;  // "home" matches a Home filter; compares text, once per cell
+  };
+
+  void clear() { cells_.clear(); }
+  void add(TagSymbol team, TagSymbol mainEvent, TagSymbol followUpEvent, TagSymbol period);
+  void remove(TagSymbol team, TagSymbol mainEvent, TagSymbol followUpEvent, TagSymbol period);
+
+  int count(const Filter& filter = {}) const;
+  QHash<TagSymbol, int> mainEventCounts(const Filter& filter = {}) const;
+  /// Per main event; tags without a follow-up only count towards their main event.
+  QHash<TagSymbol, QHash<TagSymbol, int>> followUpCounts(const Filter& filter = {}) const;
+  int cellCount() const { return cells_.size(); }
+
+private:
+  struct Key {
+    TagSymbol team;
+    TagSymbol mainEvent;
+    TagSymbol followUpEvent;
+    TagSymbol period;
+
+    friend bool operator==(const Key& a, const Key& b) {
+      return a.team == b.team && a.mainEvent == b.mainEvent && a.followUpEvent == b.followUpEvent
+             && a.period == b.period;
+    }
+    friend size_t qHash(const Key& key, size_t seed = 0) noexcept {
+      return qHashMulti(seed, key.team.id(), key.mainEvent.id(), key.followUpEvent.id(), key.period.id());
+    }
+  };
+
+  static bool matches(const Key& key, const Filter& filter);
+
+  QHash<Key, int> cells_;
+};
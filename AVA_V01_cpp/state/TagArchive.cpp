@@ -0,0 +1,261 @@
+#include "TagArchive.h"
+#include "../media/MediaCache.h"
+
+#include <QByteArrayView>
+#include <QHash>
+#include <QSaveFile>
+#include <QVector>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+namespace {
+constexpr quint32 kArchiveMagic = 0x43415641;  // "AVAC" on disk
+constexpr quint16 kArchiveVersion = 1;
+constexpr int kTeamSymbolCount = 4;
+// magic, version, reserved, tag count, symbol count, team symbols, then (offset, bytes) per section
+constexpr qint64 kSectionTableOffset = 4 + 2 + 2 + 4 + 4 + kTeamSymbolCount * 4;
+
+template <typename T>
+T readLE(const uchar* at) {
+  return qFromLittleEndian<T>(at);
+}
+
+template <typename T>
+void appendLE(QByteArray& bytes, T value) {
+  char buffer[sizeof(T)];
+  qToLittleEndian(value, buffer);
+  bytes.append(buffer, sizeof(T));
+}
+
+qint64 alignTo8(qint64 offset) {
+  return (offset + 7) & ~qint64(7);
+}
+} // namespace
+
+TagArchive::~TagArchive() {
+  close();
+}
+
+QString TagArchive::archivePathFor(const QString& sourcePath) {
+  return MediaCache::sidecarPath(sourcePath, QStringLiteral("avaarchive"));
+}
+
+bool TagArchive::open(const QString& path) {
+  close();
+  file_.setFileName(path);
+  if (!file_.open(QIODevice::ReadOnly)) return false;
+  const qint64 size = file_.size();
+  const qint64 headerBytes = kSectionTableOffset + SectionCount * 16;
+  uchar* mapped = size >= headerBytes ? file_.map(0, size) : nullptr;
+  const auto fail = [this, mapped]() {
+    if (mapped) file_.unmap(mapped);
+    file_.close();
+    tagCount_ = 0;
+    symbolCount_ = 0;
+    return false;
+  };
+  if (!mapped) return fail();
+
+  // Header and bounds only: nothing here scales with the number of tags.
+  if (readLE<quint32>(mapped) != kArchiveMagic || readLE<quint16>(mapped + 4) != kArchiveVersion) return fail();
+  tagCount_ = readLE<quint32>(mapped + 8);
+  symbolCount_ = readLE<quint32>(mapped + 12);
+  if (symbolCount_ == 0 || tagCount_ > quint32(std::numeric_limits<int>::max() / 8)) return fail();
+  for (int k = 0; k < kTeamSymbolCount; ++k) {
+    teamSymbols_[k] = readLE<quint32>(mapped + 16 + k * 4);
+    if (teamSymbols_[k] >= symbolCount_) return fail();
+  }
+
+  const quint64 n = tagCount_;
+  const quint64 expectedBytes[SectionCount] = {
+    n * 8, n * 8, n * 4, n * 4, n * 4, n * 4, n * 4, (n + 1) * 4, 0, (quint64(symbolCount_) + 1) * 4, 0,
+  };
+  for (int s = 0; s < SectionCount; ++s) {
+    sectionOffset_[s] = readLE<quint64>(mapped + kSectionTableOffset + s * 16);
+    sectionBytes_[s] = readLE<quint64>(mapped + kSectionTableOffset + s * 16 + 8);
+    if (sectionOffset_[s] > quint64(size) || sectionBytes_[s] > quint64(size) - sectionOffset_[s]) return fail();
+    if (s != Notes && s != Symbols && sectionBytes_[s] != expectedBytes[s]) return fail();
+  }
+  data_ = mapped;
+  return true;
+}
+
+void TagArchive::close() {
+  if (data_) file_.unmap(const_cast<uchar*>(data_));
+  data_ = nullptr;
+  if (file_.isOpen()) file_.close();
+  tagCount_ = 0;
+  symbolCount_ = 0;
+}
+
+TagSession::TagId TagArchive::tagId(int row) const {
+  return readLE<quint64>(section(TagIds) + qint64(row) * 8);
+}
+
+qint64 TagArchive::positionMs(int row) const {
+  return readLE<qint64>(section(Positions) + qint64(row) * 8);
+}
+
+quint32 TagArchive::symbolAt(Field field, int row) const {
+  const quint32 symbol = readLE<quint32>(section(Section(MainEvents + int(field))) + qint64(row) * 4);
+  return symbol < symbolCount_ ? symbol : 0;
+}
+
+QString TagArchive::blobText(Section offsets, Section blob, quint32 index, quint32 count) const {
+  if (index >= count) return QString();
+  const quint32 begin = readLE<quint32>(section(offsets) + qint64(index) * 4);
+  const quint32 end = readLE<quint32>(section(offsets) + qint64(index + 1) * 4);
+  if (begin >= end || end > sectionBytes_[blob]) return QString();
+  return QString::fromUtf8(reinterpret_cast<const char*>(section(blob)) + begin, end - begin);
+}
+
+QString TagArchive::note(int row) const {
+  return blobText(NoteOffsets, Notes, quint32(row), tagCount_);
+}
+
+QString TagArchive::symbolText(quint32 symbol) const {
+  return blobText(SymbolOffsets, Symbols, symbol, symbolCount_);
+}
+
+quint32 TagArchive::findSymbol(const QString& text) const {
+  if (!isOpen() || text.isEmpty()) return 0;
+  const QByteArray utf8 = text.toUtf8();
+  const uchar* offsets = section(SymbolOffsets);
+  for (quint32 symbol = 1; symbol < symbolCount_; ++symbol) {
+    const quint32 begin = readLE<quint32>(offsets + qint64(symbol) * 4);
+    const quint32 end = readLE<quint32>(offsets + qint64(symbol + 1) * 4);
+    if (begin > end || end > sectionBytes_[Symbols] || end - begin != quint32(utf8.size())) continue;
+    if (std::memcmp(section(Symbols) + begin, utf8.constData(), utf8.size()) == 0) return symbol;
+  }
+  return 0;
+}
+
+int TagArchive::lowerBound(qint64 ms) const {
+  int low = 0;
+  int high = tagCount();
+  while (low < high) {
+    const int mid = low + (high - low) / 2;
+    if (positionMs(mid) < ms) low = mid + 1;
+    else high = mid;
+  }
+  return low;
+}
+
+TagSession::GameTag TagArchive::tagAt(int row) const {
+  TagSession::GameTag tag;
+  tag.id = tagId(row);
+  tag.positionMs = positionMs(row);
+  tag.mainEvent = TagSymbol(symbolText(symbolAt(Field::MainEvent, row)));
+  tag.followUpEvent = TagSymbol(symbolText(symbolAt(Field::FollowUp, row)));
+  tag.period = TagSymbol(symbolText(symbolAt(Field::Period, row)));
+  tag.team = TagSymbol(symbolText(symbolAt(Field::Team, row)));
+  tag.situation = TagSymbol(symbolText(symbolAt(Field::Situation, row)));
+  tag.note = note(row);
+  return tag;
+}
+
+void TagArchive::loadInto(TagSession* session) const {
+  if (!session || !isOpen()) return;
+  {
+    TagSession::Transaction transaction(session);
+    for (int row = 0; row < tagCount(); ++row) session->restoreTag(tagAt(row));
+  }
+  if (session->homeTeamName().isEmpty() && session->awayTeamName().isEmpty()) {
+    session->setGameTeams(homeTeamName(), awayTeamName(), homeTeamColor(), awayTeamColor());
+  }
+}
+
+bool TagArchive::writeContents(const TagJournal::Contents& contents, const QString& path) {
+  QVector<TagSession::GameTag> tags = contents.tags;
+  std::sort(tags.begin(), tags.end(), [](const TagSession::GameTag& a, const TagSession::GameTag& b) {
+    return a.positionMs != b.positionMs ? a.positionMs < b.positionMs : a.id < b.id;
+  });
+
+  QVector<QByteArray> symbolTexts{QByteArray()};
+  QHash<QString, quint32> symbolByText{{QString(), 0}};
+  const auto intern = [&symbolTexts, &symbolByText](const QString& text) {
+    const auto it = symbolByText.constFind(text);
+    if (it != symbolByText.cend()) return it.value();
+    const quint32 symbol = quint32(symbolTexts.size());
+    symbolByText.insert(text, symbol);
+    symbolTexts.append(text.toUtf8());
+    return symbol;
+  };
+
+  QByteArray sections[SectionCount];
+  for (const TagSession::GameTag& tag : std::as_const(tags)) {
+    appendLE<quint64>(sections[TagIds], tag.id);
+    appendLE<qint64>(sections[Positions], tag.positionMs);
+    appendLE<quint32>(sections[MainEvents], intern(tag.mainEvent.text()));
+    appendLE<quint32>(sections[FollowUps], intern(tag.followUpEvent.text()));
+    appendLE<quint32>(sections[Periods], intern(tag.period.text()));
+    appendLE<quint32>(sections[Teams], intern(tag.team.text()));
+    appendLE<quint32>(sections[Situations], intern(tag.situation.text()));
+    appendLE<quint32>(sections[NoteOffsets], quint32(sections[Notes].size()));
+    sections[Notes].append(tag.note.toUtf8());
+  }
+  appendLE<quint32>(sections[NoteOffsets], quint32(sections[Notes].size()));
+
+  const quint32 teamSymbols[kTeamSymbolCount] = {
+    intern(contents.homeTeamName), intern(contents.awayTeamName),
+    intern(contents.homeTeamColor), intern(contents.awayTeamColor),
+  };
+  for (const QByteArray& text : std::as_const(symbolTexts)) {
+    appendLE<quint32>(sections[SymbolOffsets], quint32(sections[Symbols].size()));
+    sections[Symbols].append(text);
+  }
+  appendLE<quint32>(sections[SymbolOffsets], quint32(sections[Symbols].size()));
+  if (sections[Notes].size() > std::numeric_limits<quint32>::max()
+      || sections[Symbols].size() > std::numeric_limits<quint32>::max()) {
+    return false;
+  }
+
+  QByteArray header;
+  appendLE<quint32>(header, kArchiveMagic);
+  appendLE<quint16>(header, kArchiveVersion);
+  appendLE<quint16>(header, 0);
+  appendLE<quint32>(header, quint32(tags.size()));
+  appendLE<quint32>(header, quint32(symbolTexts.size()));
+  for (const quint32 symbol : teamSymbols) appendLE<quint32>(header, symbol);
+
+  // Sections start on 8-byte boundaries so a mapped column is naturally aligned.
+  qint64 offset = alignTo8(kSectionTableOffset + SectionCount * 16);
+  qint64 offsets[SectionCount];
+  for (int s = 0; s < SectionCount; ++s) {
+    offsets[s] = offset;
+    appendLE<quint64>(header, quint64(offset));
+    appendLE<quint64>(header, quint64(sections[s].size()));
+    offset = alignTo8(offset + sections[s].size());
+  }
+
+  QByteArray bytes(offset, '\0');
+  std::memcpy(bytes.data(), header.constData(), header.size());
+  for (int s = 0; s < SectionCount; ++s) {
+    if (!sections[s].isEmpty()) std::memcpy(bytes.data() + offsets[s], sections[s].constData(), sections[s].size());
+  }
+
+  QSaveFile file(path);
+  return file.open(QIODevice::WriteOnly) && file.write(bytes) == bytes.size() && file.commit();
+}
+
+bool TagArchive::writeSession(const TagSession& session, const QString& path) {
+  TagJournal::Contents contents;
+  contents.tags.reserve(session.tags().size());
+  for (const TagSession::TagId id : session.tagIdsByTime()) {
+    if (const TagSession::GameTag* tag = session.tag(id)) contents.tags.append(*tag);
+  }
+  contents.homeTeamName = session.homeTeamName();
+  contents.awayTeamName = session.awayTeamName();
+  contents.homeTeamColor = session.homeTeamColor();
+  contents.awayTeamColor = session.awayTeamColor();
+  return writeContents(contents, path);
+}
+
+bool TagArchive::convertJournal(const QString& sourcePath, const QString& path) {
+  const TagJournal::Contents contents = TagJournal::readContents(sourcePath);
+  return contents.found && writeContents(contents, path);
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <QFile>
+#include <QString>
+#include <QtGlobal>
+
+#include "TagJournal.h"
+#include "TagSession.h"
+
+/// Read-only columnar file for a finished session (".<video>.avaarchive"). Tags are stored in time
+/// order as fixed-width little-endian columns (IDs, positions, one symbol index per field), notes
+/// as UTF-8 in a blob addressed by an offsets column, and names once in a symbol table.
+///
+/// open() maps the file and checks only the header and section bounds, so it costs the same for
+/// 50 tags as for 50,000; every accessor reads straight from the mapping. Symbol indices are
+/// file-local: compare them within one archive, or go through symbolText()/findSymbol().
+class TagArchive {
+public:
+  enum class Field : quint8 { MainEvent, FollowUp, Period, Team, Situation };
+
+  TagArchive() = default;
+  ~TagArchive();
+  Q_DISABLE_COPY(TagArchive)
+
+  bool open(const QString& path);
+  void close();
+  bool isOpen() const { return data_ != nullptr; }
+
+  int tagCount() const { return int(tagCount_); }
+  TagSession::TagId tagId(int row) const;
+  qint64 positionMs(int row) const;
+  /// Index into the symbol table; 0 is the empty string.
+  quint32 symbolAt(Field field, int row) const;
+  QString note(int row) const;
+
+  int symbolCount() const { return int(symbolCount_); }
+  QString symbolText(quint32 symbol) const;
+  /// The symbol with this text, or 0 when the archive never uses it.
+  quint32 findSymbol(const QString& text) const;
+
+  QString homeTeamName() const { return symbolText(teamSymbols_[0]); }
+  QString awayTeamName() const { return symbolText(teamSymbols_[1]); }
+  QString homeTeamColor() const { return symbolText(teamSymbols_[2]); }
+  QString awayTeamColor() const { return symbolText(teamSymbols_[3]); }
+
+  /// First row with positionMs >= ms (tagCount() if none); rows are in time order.
+  int lowerBound(qint64 ms) const;
+  TagSession::GameTag tagAt(int row) const;
+  /// Restores every tag under its original ID in one transaction; team names only fill empty ones.
+  void loadInto(TagSession* session) const;
+
+  static QString archivePathFor(const QString& sourcePath);
+  static bool writeContents(const TagJournal::Contents& contents, const QString& path);
+  static bool writeSession(const TagSession& session, const QString& path);
+  /// Converts the live journal (snapshot + journal) of sourcePath into an archive at path.
+  static bool convertJournal(const QString& sourcePath, const QString& path);
+
+private:
+  enum Section { TagIds, Positions, MainEvents, FollowUps, Periods, Teams, Situations,
+                 NoteOffsets, Notes, SymbolOffsets, Symbols, SectionCount };
+
+  const uchar* section(Section s) const { return data_ + sectionOffset_[s]; }
+  QString blobText(Section offsets, Section blob, quint32 index, quint32 count) const;
+
+  QFile file_;
+  const uchar* data_ = nullptr;
+  quint32 tagCount_ = 0;
+  quint32 symbolCount_ = 0;
+  quint32 teamSymbols_[4] = {};
+  quint64 sectionOffset_[SectionCount] = {};
+  quint64 sectionBytes_[SectionCount] = {};
+};
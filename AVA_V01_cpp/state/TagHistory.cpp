@@ -0,0 +1,96 @@
+#include "TagHistory.h"
+
+#include <utility>
+
+bool TagHistory::sameExceptNote(const TagSession::GameTag& a, const TagSession::GameTag& b) {
+  return a.id == b.id && a.mainEvent == b.mainEvent && a.followUpEvent == b.followUpEvent
+         && a.positionMs == b.positionMs && a.period == b.period && a.team == b.team
+         && a.situation == b.situation;
+}
+
+qint64 TagHistory::entryBytes(const Entry& entry) {
+  qint64 bytes = sizeof(Entry);
+  for (const Command& command : entry) {
+    bytes += sizeof(Command) + (command.before.note.size() + command.after.note.size()) * qint64(sizeof(QChar));
+  }
+  return bytes;
+}
+
+void TagHistory::record(Command command) {
+  if (groupDepth_ > 0) {
+    openGroup_.append(std::move(command));
+    return;
+  }
+
+  // Typing a note saves in bursts; consecutive note edits of one tag undo as one step.
+  if (command.kind == Command::Kind::Update && redoEntries_.isEmpty() && !undoEntries_.isEmpty()
+      && sameExceptNote(command.before, command.after)) {
+    Entry& top = undoEntries_.last();
+    if (top.size() == 1 && top.constFirst().kind == Command::Kind::Update
+        && sameExceptNote(top.constFirst().before, command.after)) {
+      usageBytes_ -= entryBytes(top);
+      top.first().after = std::move(command.after);
+      usageBytes_ += entryBytes(top);
+      enforceBudget();
+      return;
+    }
+  }
+  pushUndo(Entry{std::move(command)});
+}
+
+void TagHistory::beginGroup() {
+  ++groupDepth_;
+}
+
+void TagHistory::endGroup() {
+  if (groupDepth_ == 0 || --groupDepth_ > 0) return;
+  if (openGroup_.isEmpty()) return;
+  pushUndo(std::exchange(openGroup_, Entry()));
+}
+
+void TagHistory::pushUndo(Entry entry) {
+  // A new edit forks history: whatever was undone can no longer be redone.
+  for (const Entry& redo : std::as_const(redoEntries_)) usageBytes_ -= entryBytes(redo);
+  redoEntries_.clear();
+
+  usageBytes_ += entryBytes(entry);
+  undoEntries_.append(std::move(entry));
+  enforceBudget();
+}
+
+TagHistory::Entry TagHistory::takeUndo() {
+  if (undoEntries_.isEmpty()) return {};
+  Entry entry = undoEntries_.takeLast();
+  redoEntries_.append(entry);
+  return entry;
+}
+
+TagHistory::Entry TagHistory::takeRedo() {
+  if (redoEntries_.isEmpty()) return {};
+  Entry entry = redoEntries_.takeLast();
+  undoEntries_.append(entry);
+  return entry;
+}
+
+void TagHistory::clear() {
+  undoEntries_.clear();
+  redoEntries_.clear();
+  openGroup_.clear();
+  groupDepth_ = 0;
+  usageBytes_ = 0;
+}
+
+void TagHistory::setBudgetBytes(qint64 bytes) {
+  budgetBytes_ = qMax<qint64>(0, bytes);
+  enforceBudget();
+}
+
+void TagHistory::enforceBudget() {
+  // Oldest undo steps go first; the newest step is always kept so Ctrl+Z works right after an edit.
+  while (usageBytes_ > budgetBytes_ && undoEntries_.size() > 1) {
+    usageBytes_ -= entryBytes(undoEntries_.takeFirst());
+  }
+  while (usageBytes_ > budgetBytes_ && !redoEntries_.isEmpty()) {
+    usageBytes_ -= entryBytes(redoEntries_.takeFirst());
+  }
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "TagSession.h"
+
+#include <QList>
+#include <QVector>
+#include <QtGlobal>
+
+/// Undo/redo entries for TagSession edits. Each command keeps just enough to invert itself (the
+/// tag before and/or after the edit); a group collects the commands of one transaction, e.g. a
+/// multi-delete, into a single entry. Entries are dropped oldest-first once their estimated size
+/// exceeds the memory budget. TagSession records and replays; this class only stores.
+class TagHistory {
+public:
+  struct Command {
+    enum class Kind : quint8 { Add, Remove, Update };
+    Kind kind = Kind::Add;
+    TagSession::GameTag before;  // Remove, Update
+    TagSession::GameTag after;   // Add, Update
+  };
+  using Entry = QVector<Command>;
+
+  static constexpr qint64 kDefaultBudgetBytes = 4 * 1024 * 1024;
+
+  void record(Command command);
+  void beginGroup();
+  void endGroup();
+
+  bool canUndo() const { return !undoEntries_.isEmpty(); }
+  bool canRedo() const { return !redoEntries_.isEmpty(); }
+  /// Moves the newest entry to the redo side and returns it; apply its inverses in reverse order.
+  Entry takeUndo();
+  /// Moves the newest undone entry back and returns it; apply its commands in order.
+  Entry takeRedo();
+  void clear();
+
+  void setBudgetBytes(qint64 bytes);
+  qint64 budgetBytes() const { return budgetBytes_; }
+  qint64 usageBytes() const { return usageBytes_; }
+
+  /// Whether two tags differ at most in their note (note edits are replayed as note edits).
+  static bool sameExceptNote(const TagSession::GameTag& a, const TagSession::GameTag& b);
+
+private:
+  static qint64 entryBytes(const Entry& entry);
+  void pushUndo(Entry entry);
+  void enforceBudget();
+
+  QList<Entry> undoEntries_;
+  QList<Entry> redoEntries_;
+  Entry openGroup_;
+  int groupDepth_ = 0;
+  qint64 usageBytes_ = 0;
+  qint64 budgetBytes_ = kDefaultBudgetBytes;
+};
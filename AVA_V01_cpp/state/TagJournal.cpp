@@ -0,0 +1,597 @@
+#include "TagJournal.h"
+#include "../media/MediaCache.h"
+
+#include <QDataStream>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QThread>
+#include <QTimer>
+#include <QWaitCondition>
+#include <QtEndian>
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <utility>
+
+#if defined(Q_OS_WIN)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+constexpr quint32 kJournalMagic = 0x4156414A;   // "AVAJ"
+constexpr quint32 kSnapshotMagic = 0x41564153;  // "AVAS"
+constexpr quint16 kFormatVersion = 1;
+constexpr int kFileHeaderBytes = 4 + 2 + 8;     // magic, version, generation
+constexpr int kFrameHeaderBytes = 4 + 2;        // body length, CRC-16 of the body
+constexpr quint32 kMaxRecordBytes = 16 * 1024 * 1024;
+constexpr quint32 kMaxSymbols = 1 << 20;
+constexpr int kFlushIntervalMs = 250;           // worst-case loss window on a crash
+constexpr qsizetype kFlushBytes = 64 * 1024;
+constexpr qint64 kCompactAfterRecords = 4096;
+constexpr qint64 kCompactAfterBytes = 1024 * 1024;
+
+QByteArray fileHeader(quint32 magic, quint64 generation) {
+  QByteArray bytes;
+  QDataStream out(&bytes, QIODevice::WriteOnly);
+  out << magic << kFormatVersion << generation;
+  return bytes;
+}
+
+// Generation in the header of a journal or snapshot file, or -1 when it is missing or not ours.
+qint64 storedGeneration(const QString& path, quint32 magic) {
+  QFile file(path);
+  if (!file.open(QIODevice::ReadOnly)) return -1;
+  QDataStream in(file.read(kFileHeaderBytes));
+  quint32 storedMagic = 0;
+  quint16 version = 0;
+  quint64 generation = 0;
+  in >> storedMagic >> version >> generation;
+  if (in.status() != QDataStream::Ok || storedMagic != magic || version != kFormatVersion) return -1;
+  return qint64(generation);
+}
+
+bool syncToDisk(QFileDevice& file) {
+  if (!file.flush()) return false;
+#if defined(Q_OS_WIN)
+  return _commit(file.handle()) == 0;
+#else
+  return ::fsync(file.handle()) == 0;
+#endif
+}
+} // namespace
+
+// Owns the file handles; the UI thread only ever queues byte buffers.
+struct TagJournal::Writer {
+  struct Job {
+    enum class Kind { Append, Snapshot, Close };
+    Kind kind = Kind::Append;
+    QString journalPath;
+    QString snapshotPath;
+    QByteArray bytes;  // framed records; the writer adds the file header
+    quint64 generation = 0;
+  };
+
+  void submit(Job job) {
+    QMutexLocker locker(&mutex);
+    jobs.push_back(std::move(job));
+    wake.wakeOne();
+  }
+
+  void waitIdle() {
+    QMutexLocker locker(&mutex);
+    while (busy || !jobs.empty()) idle.wait(&mutex);
+  }
+
+  void stop() {
+    {
+      QMutexLocker locker(&mutex);
+      stopping = true;
+      wake.wakeOne();
+    }
+    thread->wait();
+  }
+
+  void run() {
+    for (;;) {
+      Job job;
+      {
+        QMutexLocker locker(&mutex);
+        while (jobs.empty() && !stopping) wake.wait(&mutex);
+        if (jobs.empty()) break;  // stopping, and everything queued is on disk
+        job = std::move(jobs.front());
+        jobs.pop_front();
+        busy = true;
+      }
+      process(job);
+      QMutexLocker locker(&mutex);
+      busy = false;
+      if (jobs.empty()) idle.wakeAll();
+    }
+    journal.close();
+  }
+
+  void process(const Job& job) {
+    switch (job.kind) {
+    case Job::Kind::Append:
+      if (journalStale) return;
+      if (!openJournal(job.journalPath, job.generation, /*truncate=*/false)) return;
+      if (journal.write(job.bytes) != job.bytes.size() || !syncToDisk(journal)) {
+        qWarning("TagJournal: write to %s failed", qPrintable(job.journalPath));
+        return;
+      }
+      ++batches;
+      bytesWritten += job.bytes.size();
+      break;
+    case Job::Kind::Snapshot: {
+      // Snapshot first, then restart the journal under the new generation: a crash in between
+      // leaves an old-generation journal, which recovery skips because the snapshot holds it.
+      const QByteArray bytes = fileHeader(kSnapshotMagic, job.generation) + job.bytes;
+      QSaveFile file(job.snapshotPath);
+      if (file.open(QIODevice::WriteOnly) && file.write(bytes) == bytes.size() && syncToDisk(file) && file.commit()) {
+        if (openJournal(job.journalPath, job.generation, /*truncate=*/true)) syncToDisk(journal);
+        bytesWritten += bytes.size();
+        journalStale = false;
+        break;
+      }
+      // The records queued after this job use the symbol refs the snapshot was meant to define, so
+      // the old journal cannot simply continue. Replace it with the snapshot's records instead.
+      ++failedSnapshots;
+      journalStale = !rewriteJournal(job);
+      if (journalStale) {
+        qWarning("TagJournal: snapshot %s failed; journaling stops until one succeeds", qPrintable(job.snapshotPath));
+      } else {
+        qWarning("TagJournal: snapshot %s failed; the journal holds the full state", qPrintable(job.snapshotPath));
+      }
+      break;
+    }
+    case Job::Kind::Close:
+      if (journal.isOpen()) syncToDisk(journal);
+      journal.close();
+      break;
+    }
+  }
+
+  // Atomically replaces the journal with the job's records (they start with a Clear, so whatever the
+  // snapshot on disk holds is overridden) under that snapshot's generation, then reopens it for appends.
+  bool rewriteJournal(const Job& job) {
+    const qint64 snapshotGeneration = storedGeneration(job.snapshotPath, kSnapshotMagic);
+    const quint64 generation = snapshotGeneration >= 0 ? quint64(snapshotGeneration) : job.generation;
+    const QByteArray bytes = fileHeader(kJournalMagic, generation) + job.bytes;
+    journal.close();
+    QSaveFile file(job.journalPath);
+    if (!file.open(QIODevice::WriteOnly) || file.write(bytes) != bytes.size() || !syncToDisk(file)
+        || !file.commit()) {
+      return false;
+    }
+    bytesWritten += bytes.size();
+    return openJournal(job.journalPath, generation, /*truncate=*/false);
+  }
+
+  bool openJournal(const QString& path, quint64 generation, bool truncate) {
+    if (!truncate && journal.isOpen() && journal.fileName() == path) return true;
+    journal.close();
+    journal.setFileName(path);
+    const QIODevice::OpenMode mode = truncate ? QIODevice::WriteOnly | QIODevice::Truncate
+                                              : QIODevice::WriteOnly | QIODevice::Append;
+    if (!journal.open(mode)) {
+      qWarning("TagJournal: cannot open %s", qPrintable(path));
+      return false;
+    }
+    if (journal.size() == 0) journal.write(fileHeader(kJournalMagic, generation));
+    return true;
+  }
+
+  QMutex mutex;
+  QWaitCondition wake;
+  QWaitCondition idle;
+  std::deque<Job> jobs;
+  bool busy = false;
+  bool stopping = false;
+  QThread* thread = nullptr;
+  QFile journal;  // writer thread only
+  bool journalStale = false;  // writer thread only: the journal predates the UI's symbol refs
+  std::atomic<qint64> batches{0};
+  std::atomic<qint64> bytesWritten{0};
+  std::atomic<qint64> failedSnapshots{0};
+};
+
+// Applies records to in-memory Contents; the same code reads snapshots and journals.
+struct TagJournal::Decoder {
+  Contents* contents = nullptr;
+  QVector<TagSymbol> symbols{TagSymbol()};     // journal symbol ref -> symbol; 0 is the empty one
+  QHash<TagSession::TagId, int> slots;         // tag ID -> index in contents->tags
+
+  TagSymbol symbol(quint32 ref) const { return ref < quint32(symbols.size()) ? symbols.at(ref) : TagSymbol(); }
+
+  bool readTag(QDataStream& in, TagSession::GameTag* tag) const {
+    quint32 mainEvent = 0, followUpEvent = 0, period = 0, team = 0, situation = 0;
+    in >> tag->id >> tag->positionMs >> mainEvent >> followUpEvent >> period >> team >> situation >> tag->note;
+    tag->mainEvent = symbol(mainEvent);
+    tag->followUpEvent = symbol(followUpEvent);
+    tag->period = symbol(period);
+    tag->team = symbol(team);
+    tag->situation = symbol(situation);
+    return in.status() == QDataStream::Ok && tag->id != 0;
+  }
+
+  bool apply(RecordType type, const QByteArray& payload) {
+    QDataStream in(payload);
+    in.setVersion(QDataStream::Qt_6_0);
+    switch (type) {
+    case RecordType::Symbol: {
+      quint32 ref = 0;
+      QString text;
+      in >> ref >> text;
+      if (in.status() != QDataStream::Ok || ref == 0 || ref >= kMaxSymbols) return false;
+      if (ref >= quint32(symbols.size())) symbols.resize(ref + 1);
+      symbols[ref] = TagSymbol(text);
+      return true;
+    }
+    case RecordType::Tag:
+    case RecordType::Update: {
+      TagSession::GameTag tag;
+      if (!readTag(in, &tag)) return false;
+      const auto it = slots.constFind(tag.id);
+      if (it != slots.cend()) {
+        contents->tags[it.value()] = tag;
+      } else if (type == RecordType::Tag) {
+        slots.insert(tag.id, contents->tags.size());
+        contents->tags.append(tag);
+      }
+      return true;
+    }
+    case RecordType::Note: {
+      TagSession::TagId id = 0;
+      QString note;
+      in >> id >> note;
+      if (in.status() != QDataStream::Ok) return false;
+      const auto it = slots.constFind(id);
+      if (it != slots.cend()) contents->tags[it.value()].note = note;
+      return true;
+    }
+    case RecordType::Remove: {
+      TagSession::TagId id = 0;
+      in >> id;
+      if (in.status() != QDataStream::Ok) return false;
+      const auto it = slots.constFind(id);
+      if (it != slots.cend()) contents->tags[it.value()].id = 0;  // dropped in finish()
+      slots.remove(id);
+      return true;
+    }
+    case RecordType::Clear:
+      contents->tags.clear();
+      slots.clear();
+      return true;
+    case RecordType::Teams:
+      in >> contents->homeTeamName >> contents->awayTeamName >> contents->homeTeamColor >> contents->awayTeamColor;
+      return in.status() == QDataStream::Ok;
+    }
+    return true;  // unknown record from a newer build: skip it
+  }
+
+  /// Applies the file's records if its header matches; stops quietly at a torn or corrupt tail.
+  /// requiredGeneration < 0 accepts any generation. Returns the file's generation, or -1.
+  qint64 readFile(const QString& path, quint32 magic, qint64 requiredGeneration) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return -1;
+    const QByteArray bytes = file.readAll();
+    if (bytes.size() < kFileHeaderBytes) return -1;
+
+    QDataStream header(bytes);
+    quint32 storedMagic = 0;
+    quint16 version = 0;
+    quint64 generation = 0;
+    header >> storedMagic >> version >> generation;
+    if (storedMagic != magic || version != kFormatVersion) return -1;
+    if (requiredGeneration >= 0 && generation != quint64(requiredGeneration)) return qint64(generation);
+
+    qsizetype offset = kFileHeaderBytes;
+    while (offset + kFrameHeaderBytes <= bytes.size()) {
+      const quint32 length = qFromBigEndian<quint32>(bytes.constData() + offset);
+      const quint16 checksum = qFromBigEndian<quint16>(bytes.constData() + offset + 4);
+      if (length == 0 || length > kMaxRecordBytes || offset + kFrameHeaderBytes + qsizetype(length) > bytes.size()) break;
+      const QByteArrayView body(bytes.constData() + offset + kFrameHeaderBytes, length);
+      if (qChecksum(body) != checksum) break;
+      if (!apply(RecordType(quint8(body.at(0))), body.sliced(1).toByteArray())) break;
+      offset += kFrameHeaderBytes + length;
+    }
+    return qint64(generation);
+  }
+
+  void finish() {
+    QVector<TagSession::GameTag> live;
+    live.reserve(slots.size());
+    for (TagSession::GameTag& tag : contents->tags) {
+      if (tag.id != 0) live.append(std::move(tag));
+    }
+    contents->tags = std::move(live);
+  }
+};
+
+TagJournal::TagJournal(TagSession* session, QObject* parent)
+  : QObject(parent), session_(session), writer_(std::make_unique<Writer>()) {
+  flushTimer_ = new QTimer(this);
+  flushTimer_->setSingleShot(true);
+  flushTimer_->setInterval(kFlushIntervalMs);
+  connect(flushTimer_, &QTimer::timeout, this, &TagJournal::flush);
+  if (session_) {
+    connect(session_, &QObject::destroyed, this, [this]() {
+      close();
+      session_ = nullptr;
+    });
+  }
+
+  Writer* writer = writer_.get();
+  writer_->thread = QThread::create([writer]() { writer->run(); });
+  writer_->thread->setObjectName(QStringLiteral("TagJournal"));
+  writer_->thread->start();
+}
+
+TagJournal::~TagJournal() {
+  close();
+  writer_->stop();  // drains the queue, so nothing submitted is lost on exit
+  delete writer_->thread;
+}
+
+QString TagJournal::journalPathFor(const QString& sourcePath) {
+  return MediaCache::sidecarPath(sourcePath, QStringLiteral("avajournal"));
+}
+
+QString TagJournal::snapshotPathFor(const QString& sourcePath) {
+  return MediaCache::sidecarPath(sourcePath, QStringLiteral("avasnap"));
+}
+
+TagJournal::Contents TagJournal::readContents(const QString& sourcePath) {
+  Contents contents;
+  if (sourcePath.isEmpty()) return contents;
+  Decoder decoder;
+  decoder.contents = &contents;
+  const qint64 snapshotGeneration = decoder.readFile(snapshotPathFor(sourcePath), kSnapshotMagic, -1);
+  // Without a snapshot, any journal is better than nothing.
+  const qint64 journalGeneration = decoder.readFile(journalPathFor(sourcePath), kJournalMagic, snapshotGeneration);
+  decoder.finish();
+  contents.found = snapshotGeneration >= 0 || journalGeneration >= 0;
+  contents.generation = quint64(std::max<qint64>({0, snapshotGeneration, journalGeneration}));
+  return contents;
+}
+
+int TagJournal::open(const QString& sourcePath) {
+  close();
+  if (!session_ || sourcePath.isEmpty()) return 0;
+
+  const Contents contents = readContents(sourcePath);
+  {
+    TagSession::Transaction transaction(session_);
+    for (const TagSession::GameTag& tag : contents.tags) session_->restoreTag(tag);
+  }
+  session_->clearHistory();  // recovered tags are the starting point, not an undoable edit
+  if (session_->homeTeamName().isEmpty() && session_->awayTeamName().isEmpty()) {
+    session_->setGameTeams(contents.homeTeamName, contents.awayTeamName,
+                           contents.homeTeamColor, contents.awayTeamColor);
+  }
+
+  sourcePath_ = sourcePath;
+  journalPath_ = journalPathFor(sourcePath);
+  snapshotPath_ = snapshotPathFor(sourcePath);
+  generation_ = contents.generation;
+  foundExisting_ = contents.found;
+  symbolRefs_.clear();
+  pending_.clear();
+  recordsSinceSnapshot_ = 0;
+  bytesSinceSnapshot_ = 0;
+
+  connect(session_, &TagSession::tagAdded, this, &TagJournal::onTagAdded);
+  connect(session_, &TagSession::tagRemoved, this, &TagJournal::onTagRemoved);
+  connect(session_, &TagSession::tagUpdated, this, &TagJournal::onTagUpdated);
+  connect(session_, &TagSession::tagNoteChanged, this, &TagJournal::onTagNoteChanged);
+  connect(session_, &TagSession::cleared, this, &TagJournal::onCleared);
+  connect(session_, &TagSession::teamsChanged, this, &TagJournal::onTeamsChanged);
+
+  // Start from a fresh snapshot: folds in the replayed journal and drops any torn tail it had.
+  compact();
+  return int(contents.tags.size());
+}
+
+void TagJournal::close() {
+  if (!isOpen()) return;
+  if (session_) disconnect(session_, nullptr, this, nullptr);
+  flush();
+  Writer::Job job;
+  job.kind = Writer::Job::Kind::Close;
+  writer_->submit(std::move(job));
+
+  const Stats& current = stats();
+  if (current.records > 0) {
+    qInfo("TagJournal: %lld records, %.1f us average / %.1f us max per append, %lld batches, %lld bytes",
+          current.records, current.averageAppendUs(), current.maxAppendNs / 1000.0,
+          current.batches, current.bytesWritten);
+  }
+  sourcePath_.clear();
+  journalPath_.clear();
+  snapshotPath_.clear();
+}
+
+void TagJournal::closeAndDiscardFiles() {
+  if (!isOpen()) return;
+  const QString journalPath = journalPath_;
+  const QString snapshotPath = snapshotPath_;
+  close();
+  writer_->waitIdle();  // the writer closes the journal on the Close job
+  if (!QFile::remove(journalPath) && QFile::exists(journalPath)) {
+    qWarning("TagJournal: cannot remove %s", qPrintable(journalPath));
+  }
+  if (!QFile::remove(snapshotPath) && QFile::exists(snapshotPath)) {
+    qWarning("TagJournal: cannot remove %s", qPrintable(snapshotPath));
+  }
+}
+
+void TagJournal::flush() {
+  flushTimer_->stop();
+  if (pending_.isEmpty() || !isOpen()) return;
+  Writer::Job job;
+  job.kind = Writer::Job::Kind::Append;
+  job.journalPath = journalPath_;
+  job.generation = generation_;
+  job.bytes = std::exchange(pending_, QByteArray());
+  writer_->submit(std::move(job));
+}
+
+void TagJournal::waitForWriter() {
+  flush();
+  writer_->waitIdle();
+}
+
+const TagJournal::Stats& TagJournal::stats() const {
+  stats_.batches = writer_->batches;
+  stats_.bytesWritten = writer_->bytesWritten;
+  stats_.failedSnapshots = writer_->failedSnapshots;
+  return stats_;
+}
+
+void TagJournal::appendRecord(RecordType type, const QByteArray& payload) {
+  const qsizetype start = pending_.size();
+  pending_.resize(start + kFrameHeaderBytes);
+  pending_.append(char(type));
+  pending_.append(payload);
+  const qsizetype length = pending_.size() - start - kFrameHeaderBytes;
+  const QByteArrayView body(pending_.constData() + start + kFrameHeaderBytes, length);
+  qToBigEndian<quint32>(quint32(length), pending_.data() + start);
+  qToBigEndian<quint16>(qChecksum(body), pending_.data() + start + 4);
+  ++recordsSinceSnapshot_;
+  bytesSinceSnapshot_ += kFrameHeaderBytes + length;
+}
+
+quint32 TagJournal::symbolRef(const TagSymbol& symbol) {
+  if (symbol.isEmpty()) return 0;
+  const auto it = symbolRefs_.constFind(symbol.id());
+  if (it != symbolRefs_.cend()) return it.value();
+
+  // First use since the last snapshot: define it ahead of the record that refers to it.
+  const quint32 ref = quint32(symbolRefs_.size()) + 1;
+  symbolRefs_.insert(symbol.id(), ref);
+  QByteArray payload;
+  QDataStream out(&payload, QIODevice::WriteOnly);
+  out.setVersion(QDataStream::Qt_6_0);
+  out << ref << symbol.text();
+  appendRecord(RecordType::Symbol, payload);
+  return ref;
+}
+
+void TagJournal::appendTag(RecordType type, const TagSession::GameTag& tag) {
+  QByteArray payload;
+  QDataStream out(&payload, QIODevice::WriteOnly);
+  out.setVersion(QDataStream::Qt_6_0);
+  out << tag.id << tag.positionMs << symbolRef(tag.mainEvent) << symbolRef(tag.followUpEvent)
+      << symbolRef(tag.period) << symbolRef(tag.team) << symbolRef(tag.situation) << tag.note;
+  appendRecord(type, payload);
+}
+
+void TagJournal::appendTeams() {
+  QByteArray payload;
+  QDataStream out(&payload, QIODevice::WriteOnly);
+  out.setVersion(QDataStream::Qt_6_0);
+  out << session_->homeTeamName() << session_->awayTeamName()
+      << session_->homeTeamColor() << session_->awayTeamColor();
+  appendRecord(RecordType::Teams, payload);
+}
+
+void TagJournal::scheduleWrite() {
+  if (recordsSinceSnapshot_ >= kCompactAfterRecords || bytesSinceSnapshot_ >= kCompactAfterBytes) {
+    compact();
+  } else if (pending_.size() >= kFlushBytes) {
+    flush();
+  } else if (!flushTimer_->isActive()) {
+    flushTimer_->start();
+  }
+}
+
+void TagJournal::compact() {
+  flush();  // records already encoded refer to the old symbol table and belong to the old generation
+
+  ++generation_;
+  symbolRefs_.clear();
+  // Leading Clear: if the snapshot cannot be written, the writer puts these records in the journal
+  // instead, replayed on top of the older snapshot.
+  appendRecord(RecordType::Clear, QByteArray());
+  appendTeams();
+  for (const TagSession::TagId id : session_->tagIdsByTime()) {
+    if (const TagSession::GameTag* tag = session_->tag(id)) appendTag(RecordType::Tag, *tag);
+  }
+
+  Writer::Job job;
+  job.kind = Writer::Job::Kind::Snapshot;
+  job.journalPath = journalPath_;
+  job.snapshotPath = snapshotPath_;
+  job.generation = generation_;
+  job.bytes = std::exchange(pending_, QByteArray());
+  writer_->submit(std::move(job));
+  recordsSinceSnapshot_ = 0;
+  bytesSinceSnapshot_ = 0;
+  ++stats_.compactions;
+}
+
+void TagJournal::noteAppendCost(qint64 ns) {
+  ++stats_.records;
+  stats_.totalAppendNs += ns;
+  stats_.maxAppendNs = std::max(stats_.maxAppendNs, ns);
+}
+
+void TagJournal::onTagAdded(const TagSession::GameTag& tag) {
+  QElapsedTimer timer;
+  timer.start();
+  appendTag(RecordType::Tag, tag);
+  noteAppendCost(timer.nsecsElapsed());
+  scheduleWrite();
+}
+
+void TagJournal::onTagRemoved(TagSession::TagId id) {
+  QElapsedTimer timer;
+  timer.start();
+  QByteArray payload;
+  QDataStream out(&payload, QIODevice::WriteOnly);
+  out << id;
+  appendRecord(RecordType::Remove, payload);
+  noteAppendCost(timer.nsecsElapsed());
+  scheduleWrite();
+}
+
+void TagJournal::onTagUpdated(TagSession::TagId id) {
+  const TagSession::GameTag* tag = session_->tag(id);
+  if (!tag) return;
+  QElapsedTimer timer;
+  timer.start();
+  appendTag(RecordType::Update, *tag);
+  noteAppendCost(timer.nsecsElapsed());
+  scheduleWrite();
+}
+
+void TagJournal::onTagNoteChanged(TagSession::TagId id) {
+  QElapsedTimer timer;
+  timer.start();
+  QByteArray payload;
+  QDataStream out(&payload, QIODevice::WriteOnly);
+  out.setVersion(QDataStream::Qt_6_0);
+  out << id << session_->tagNote(id);
+  appendRecord(RecordType::Note, payload);
+  noteAppendCost(timer.nsecsElapsed());
+  scheduleWrite();
+}
+
+void TagJournal::onCleared() {
+  appendRecord(RecordType::Clear, QByteArray());
+  scheduleWrite();
+}
+
+void TagJournal::onTeamsChanged() {
+  QElapsedTimer timer;
+  timer.start();
+  appendTeams();
+  noteAppendCost(timer.nsecsElapsed());
+  scheduleWrite();
+}
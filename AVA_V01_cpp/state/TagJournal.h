@@ -0,0 +1,117 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+#include <memory>
+
+#include "TagSession.h"
+#include "TagSymbol.h"
+
+class QTimer;
+
+/// Crash-safe persistence for a TagSession: every mutation is appended to a binary write-ahead
+/// journal next to the video (".<video>.avajournal"), and the journal is periodically folded into
+/// a snapshot (".<video>.avasnap"). Opening the same video again replays snapshot + journal, so
+/// a crash or an accidental close loses at most the last flush interval.
+///
+/// Appends only encode into memory on the UI thread; a writer thread writes and fsyncs in
+/// batches. Records are length-prefixed and checksummed, and recovery stops at the first torn or
+/// corrupt record. Each file carries a generation; a journal whose generation does not match the
+/// snapshot is already contained in it (compaction was interrupted) and is skipped. When a snapshot
+/// cannot be written, the writer rewrites the journal with the same full state instead.
+class TagJournal final : public QObject {
+  Q_OBJECT
+
+public:
+  /// Append cost on the UI thread (encode + buffer) and writer-side batching.
+  struct Stats {
+    qint64 records = 0;
+    qint64 totalAppendNs = 0;
+    qint64 maxAppendNs = 0;
+    qint64 batches = 0;
+    qint64 bytesWritten = 0;
+    qint64 compactions = 0;
+    qint64 failedSnapshots = 0;  // each one fell back to rewriting the journal
+
+    double averageAppendUs() const { return records > 0 ? totalAppendNs / 1000.0 / records : 0.0; }
+  };
+
+  /// Replayed file contents, shared with the archive converter.
+  struct Contents {
+    QVector<TagSession::GameTag> tags;  // in the order they were (re)added
+    QString homeTeamName;
+    QString awayTeamName;
+    QString homeTeamColor;
+    QString awayTeamColor;
+    quint64 generation = 0;
+    bool found = false;  // a snapshot or journal existed
+  };
+
+  explicit TagJournal(TagSession* session, QObject* parent = nullptr);
+  ~TagJournal() override;
+
+  /// Recovers the tags journaled for sourcePath into the (cleared) session, then starts journaling.
+  /// Team names already set on the session win over journaled ones. Returns the recovered tag count.
+  int open(const QString& sourcePath);
+  /// Whether the last open() found a snapshot or journal, even one that holds no tags.
+  bool foundExisting() const { return foundExisting_; }
+  /// Hands buffered records to the writer and stops journaling; the files stay on disk. Call
+  /// before clearing the session, or the clear is journaled too.
+  void close();
+  /// close(), then deletes the journal and snapshot once the writer has let go of them. Only for
+  /// when their contents are safe elsewhere, e.g. in a freshly written archive.
+  void closeAndDiscardFiles();
+  bool isOpen() const { return !sourcePath_.isEmpty(); }
+  QString sourcePath() const { return sourcePath_; }
+
+  /// Submits buffered records now instead of on the next flush tick.
+  void flush();
+  /// Blocks until the writer has written and synced everything submitted so far.
+  void waitForWriter();
+
+  const Stats& stats() const;
+
+  static QString journalPathFor(const QString& sourcePath);
+  static QString snapshotPathFor(const QString& sourcePath);
+  /// Replays snapshot + journal for sourcePath without touching any session.
+  static Contents readContents(const QString& sourcePath);
+
+private:
+  struct Writer;
+  struct Decoder;
+  enum class RecordType : quint8 { Symbol = 1, Tag, Update, Note, Remove, Clear, Teams };
+
+  void onTagAdded(const TagSession::GameTag& tag);
+  void onTagRemoved(TagSession::TagId id);
+  void onTagUpdated(TagSession::TagId id);
+  void onTagNoteChanged(TagSession::TagId id);
+  void onCleared();
+  void onTeamsChanged();
+
+  void appendRecord(RecordType type, const QByteArray& payload);
+  void appendTag(RecordType type, const TagSession::GameTag& tag);
+  void appendTeams();
+  void scheduleWrite();
+  quint32 symbolRef(const TagSymbol& symbol);
+  void compact();
+  void noteAppendCost(qint64 ns);
+
+  TagSession* session_ = nullptr;
+  std::unique_ptr<Writer> writer_;
+  QTimer* flushTimer_ = nullptr;
+  QString sourcePath_;
+  QString journalPath_;
+  QString snapshotPath_;
+  QByteArray pending_;                     // framed records not yet handed to the writer
+  QHash<TagSymbol::Id, quint32> symbolRefs_;  // process symbol -> journal symbol (0 = empty)
+  quint64 generation_ = 0;
+  bool foundExisting_ = false;
+  qint64 recordsSinceSnapshot_ = 0;
+  qint64 bytesSinceSnapshot_ = 0;
+  mutable Stats stats_;
+};
@@ -1,89 +1,315 @@
 #include "TagSession.h"
+#include "TagHistory.h"
 
-TagSession::TagSession(QObject* parent) : QObject(parent) {}
+#include <QMetaObject>
+
+#include <algorithm>
+#include <utility>
+
+TagSession::TagSession(QObject* parent) : QObject(parent), history_(std::make_unique<TagHistory>()) {}
+
+TagSession::~TagSession() = default;
 
 void TagSession::clear() {
   tags_.clear();
-  mainEventCounts_.clear();
-  followUpCountsByMainEvent_.clear();
+  slotById_.clear();
+  latestTagId_ = 0;
+  timeOrderMs_.clear();
+  timeOrderIds_.clear();
+  aggregates_.clear();
+  gameState_.clear();
+  pendingChanges_.clear();
+  pendingCleared_ = true;
+  pendingStatsChange_ = true;
+  history_->clear();
   emit cleared();
-  emit statsChanged();
+  emit historyChanged();
+  scheduleFlush();
 }
 
 void TagSession::clearTeamInfo() {
-  homeTeamName_.clear();
-  awayTeamName_.clear();
-  homeTeamColor_.clear();
-  awayTeamColor_.clear();
+  setGameTeams({}, {}, {}, {});
 }
 
 void TagSession::setGameTeams(const QString& homeName, const QString& awayName,
                               const QString& homeColor, const QString& awayColor) {
-  homeTeamName_ = homeName.trimmed();
-  awayTeamName_ = awayName.trimmed();
-  homeTeamColor_ = homeColor.trimmed();
-  awayTeamColor_ = awayColor.trimmed();
+  const QString home = homeName.trimmed();
+  const QString away = awayName.trimmed();
+  const QString homeColorText = homeColor.trimmed();
+  const QString awayColorText = awayColor.trimmed();
+  if (home == homeTeamName_ && away == awayTeamName_ && homeColorText == homeTeamColor_
+      && awayColorText == awayTeamColor_) {
+    return;
+  }
+  homeTeamName_ = home;
+  awayTeamName_ = away;
+  homeTeamColor_ = homeColorText;
+  awayTeamColor_ = awayColorText;
+  emit teamsChanged();
+}
+
+TagSession::TagId TagSession::addTag(const GameTag& tag) {
+  GameTag stored = tag;
+  stored.id = nextTagId_++;
+  storeTag(stored);
+  return stored.id;
+}
+
+void TagSession::restoreTag(const GameTag& tag) {
+  if (tag.id == 0 || slotById_.contains(tag.id)) return;
+  nextTagId_ = std::max(nextTagId_, tag.id + 1);
+  storeTag(tag);
 }
 
-void TagSession::addTag(const GameTag& tag) {
+void TagSession::storeTag(const GameTag& tag) {
+  slotById_.insert(tag.id, tags_.size());
   tags_.push_back(tag);
+  latestTagId_ = std::max(latestTagId_, tag.id);
+  indexTag(tag);
 
-  const int nextMainCount = mainEventCounts_.value(tag.mainEvent, 0) + 1;
-  mainEventCounts_.insert(tag.mainEvent, nextMainCount);
+  recordHistory(nullptr, &tag);
+  recordChange(tag.id, PendingChange::Added);
+  emit tagAdded(tag);
+}
 
-  if (!tag.followUpEvent.isEmpty()) {
-    auto& followUps = followUpCountsByMainEvent_[tag.mainEvent];
-    const int nextFollowUpCount = followUps.value(tag.followUpEvent, 0) + 1;
-    followUps.insert(tag.followUpEvent, nextFollowUpCount);
+void TagSession::removeTag(TagId id) {
+  const auto it = slotById_.constFind(id);
+  if (it == slotById_.cend()) return;
+  const int slot = it.value();
+  recordHistory(&tags_.at(slot), nullptr);
+  unindexTag(tags_.at(slot));
+
+  // Swap-remove keeps removal O(1); only the moved tag's slot changes.
+  const int lastSlot = tags_.size() - 1;
+  if (slot != lastSlot) {
+    tags_[slot] = std::move(tags_[lastSlot]);
+    slotById_.insert(tags_.at(slot).id, slot);
+  }
+  tags_.removeLast();
+  slotById_.remove(id);
+  if (id == latestTagId_) {
+    // Only removing the newest tag needs a scan; unindexTag() above is already linear.
+    latestTagId_ = 0;
+    for (const GameTag& stored : tags_) latestTagId_ = std::max(latestTagId_, stored.id);
   }
 
-  emit tagAdded(tag);
-  emit statsChanged();
+  recordChange(id, PendingChange::Removed);
+  emit tagRemoved(id);
 }
 
-void TagSession::removeTag(int index) {
-  if (index < 0 || index >= tags_.size()) return;
+void TagSession::updateTag(const GameTag& tag) {
+  const auto it = slotById_.constFind(tag.id);
+  if (it == slotById_.cend()) return;
+  GameTag& stored = tags_[it.value()];
+  recordHistory(&stored, &tag);
+  unindexTag(stored);
+  stored = tag;
+  indexTag(stored);
 
-  const GameTag& tag = tags_.at(index);
-  
-  // Decrement main event count
-  const int currentMainCount = mainEventCounts_.value(tag.mainEvent, 0);
-  if (currentMainCount > 0) {
-    mainEventCounts_.insert(tag.mainEvent, currentMainCount - 1);
-    if (currentMainCount == 1) {
-      mainEventCounts_.remove(tag.mainEvent);
-    }
+  recordChange(tag.id, PendingChange::Modified);
+  emit tagUpdated(tag.id);
+}
+
+void TagSession::setTagNote(TagId id, const QString& note) {
+  const auto it = slotById_.constFind(id);
+  if (it == slotById_.cend()) return;
+  GameTag& stored = tags_[it.value()];
+  if (stored.note == note) return;
+  GameTag edited = stored;
+  edited.note = note;
+  recordHistory(&stored, &edited);
+  stored.note = note;
+  recordChange(id, PendingChange::Modified, /*affectsStats=*/false);
+  emit tagNoteChanged(id);
+}
+
+QString TagSession::tagNote(TagId id) const {
+  const GameTag* found = tag(id);
+  return found ? found->note : QString();
+}
+
+const TagSession::GameTag* TagSession::tag(TagId id) const {
+  const auto it = slotById_.constFind(id);
+  return it == slotById_.cend() ? nullptr : &tags_.at(it.value());
+}
+
+int TagSession::timeSlot(qint64 positionMs, TagId id) const {
+  const auto first = std::lower_bound(timeOrderMs_.cbegin(), timeOrderMs_.cend(), positionMs);
+  const auto last = std::upper_bound(first, timeOrderMs_.cend(), positionMs);
+  // Within one position the IDs are ascending, i.e. insertion order.
+  const auto idsBegin = timeOrderIds_.cbegin() + (first - timeOrderMs_.cbegin());
+  const auto idsEnd = timeOrderIds_.cbegin() + (last - timeOrderMs_.cbegin());
+  return static_cast<int>(std::lower_bound(idsBegin, idsEnd, id) - timeOrderIds_.cbegin());
+}
+
+void TagSession::indexTag(const GameTag& tag) {
+  const int slot = timeSlot(tag.positionMs, tag.id);
+  timeOrderMs_.insert(slot, tag.positionMs);
+  timeOrderIds_.insert(slot, tag.id);
+  aggregates_.add(tag.team, tag.mainEvent, tag.followUpEvent, tag.period);
+  gameState_.addTag(tag.id, tag.positionMs, tag.team, tag.mainEvent, tag.followUpEvent);
+}
+
+void TagSession::unindexTag(const GameTag& tag) {
+  const int slot = timeSlot(tag.positionMs, tag.id);
+  if (slot < timeOrderIds_.size() && timeOrderIds_.at(slot) == tag.id) {
+    timeOrderMs_.removeAt(slot);
+    timeOrderIds_.removeAt(slot);
   }
+  aggregates_.remove(tag.team, tag.mainEvent, tag.followUpEvent, tag.period);
+  gameState_.removeTag(tag.id);
+}
+
+QVector<TagSession::TagId> TagSession::tagIdsInRange(qint64 fromMs, qint64 toMs) const {
+  if (toMs < fromMs) return {};
+  const auto first = std::lower_bound(timeOrderMs_.cbegin(), timeOrderMs_.cend(), fromMs);
+  const auto last = std::upper_bound(first, timeOrderMs_.cend(), toMs);
+  return QVector<TagId>(timeOrderIds_.cbegin() + (first - timeOrderMs_.cbegin()),
+                        timeOrderIds_.cbegin() + (last - timeOrderMs_.cbegin()));
+}
 
-  // Decrement follow-up count if present
-  if (!tag.followUpEvent.isEmpty()) {
-    auto& followUps = followUpCountsByMainEvent_[tag.mainEvent];
-    const int currentFollowUpCount = followUps.value(tag.followUpEvent, 0);
-    if (currentFollowUpCount > 0) {
-      followUps.insert(tag.followUpEvent, currentFollowUpCount - 1);
-      if (currentFollowUpCount == 1) {
-        followUps.remove(tag.followUpEvent);
-        if (followUps.isEmpty()) {
-          followUpCountsByMainEvent_.remove(tag.mainEvent);
-        }
-      }
+TagSession::TagId TagSession::nearestTagId(qint64 positionMs) const {
+  if (timeOrderMs_.isEmpty()) return 0;
+  const int after = static_cast<int>(
+      std::lower_bound(timeOrderMs_.cbegin(), timeOrderMs_.cend(), positionMs) - timeOrderMs_.cbegin());
+  if (after == timeOrderMs_.size()) return timeOrderIds_.constLast();
+  if (after == 0) return timeOrderIds_.constFirst();
+  const qint64 beforeDistance = positionMs - timeOrderMs_.at(after - 1);
+  const qint64 afterDistance = timeOrderMs_.at(after) - positionMs;
+  return beforeDistance <= afterDistance ? timeOrderIds_.at(after - 1) : timeOrderIds_.at(after);
+}
+
+void TagSession::recordChange(TagId id, PendingChange change, bool affectsStats) {
+  pendingStatsChange_ = pendingStatsChange_ || affectsStats;
+  const auto it = pendingChanges_.find(id);
+  if (it == pendingChanges_.end()) {
+    pendingChanges_.insert(id, change);
+  } else if (it.value() == PendingChange::Added) {
+    // Consumers never saw this tag: a later edit is part of the add, a removal cancels it.
+    if (change == PendingChange::Removed) pendingChanges_.erase(it);
+  } else if (it.value() == PendingChange::Removed) {
+    // Consumers still hold the old row: re-adding the ID (undo, restore) replaces it in place.
+    if (change == PendingChange::Added) it.value() = PendingChange::Modified;
+  } else if (change == PendingChange::Removed) {
+    it.value() = PendingChange::Removed;
+  }
+  scheduleFlush();
+}
+
+void TagSession::scheduleFlush() {
+  if (transactionDepth_ > 0 || flushScheduled_) return;
+  flushScheduled_ = true;
+  QMetaObject::invokeMethod(this, &TagSession::flushChanges, Qt::QueuedConnection);
+}
+
+void TagSession::beginTransaction() {
+  ++transactionDepth_;
+  history_->beginGroup();
+}
+
+void TagSession::commitTransaction() {
+  if (transactionDepth_ == 0) return;
+  history_->endGroup();
+  if (--transactionDepth_ == 0) flushChanges();
+}
+
+void TagSession::flushChanges() {
+  flushScheduled_ = false;
+  if (transactionDepth_ > 0) return;  // the outermost commit delivers
+  if (!pendingCleared_ && pendingChanges_.isEmpty()) return;
+
+  ChangeSet changes;
+  changes.cleared = pendingCleared_;
+  for (auto it = pendingChanges_.cbegin(); it != pendingChanges_.cend(); ++it) {
+    switch (it.value()) {
+    case PendingChange::Added: changes.added.append(it.key()); break;
+    case PendingChange::Removed: changes.removed.append(it.key()); break;
+    case PendingChange::Modified: changes.modified.append(it.key()); break;
     }
   }
+  // IDs follow insertion order, so consumers see adds in the order they happened.
+  std::sort(changes.added.begin(), changes.added.end());
+  std::sort(changes.removed.begin(), changes.removed.end());
+  std::sort(changes.modified.begin(), changes.modified.end());
+  const bool statsChange = pendingStatsChange_;
+  pendingChanges_.clear();
+  pendingCleared_ = false;
+  pendingStatsChange_ = false;
+
+  emit changesCommitted(changes);
+  if (statsChange) emit statsChanged();
+}
 
-  tags_.removeAt(index);
-  emit statsChanged();
+void TagSession::recordHistory(const GameTag* before, const GameTag* after) {
+  if (replayingHistory_) return;
+  TagHistory::Command command;
+  command.kind = !before ? TagHistory::Command::Kind::Add
+               : !after ? TagHistory::Command::Kind::Remove
+                        : TagHistory::Command::Kind::Update;
+  if (before) command.before = *before;
+  if (after) command.after = *after;
+  history_->record(std::move(command));
+  emit historyChanged();
 }
 
-void TagSession::setTagNote(int index, const QString& note) {
-  if (index < 0 || index >= tags_.size()) return;
-  if (tags_[index].note == note) return;
-  tags_[index].note = note;
-  emit tagNoteChanged(index);
+bool TagSession::canUndo() const {
+  return history_->canUndo();
 }
 
-QString TagSession::tagNote(int index) const {
-  if (index < 0 || index >= tags_.size()) return QString();
-  return tags_[index].note;
+bool TagSession::canRedo() const {
+  return history_->canRedo();
 }
 
-  
\ No newline at end of file
+void TagSession::undo() {
+  replayHistory(/*undo=*/true);
+}
+
+void TagSession::redo() {
+  replayHistory(/*undo=*/false);
+}
+
+void TagSession::replayHistory(bool undo) {
+  if (undo ? !history_->canUndo() : !history_->canRedo()) return;
+  const TagHistory::Entry entry = undo ? history_->takeUndo() : history_->takeRedo();
+
+  const auto apply = [this](const TagHistory::Command& command, bool inverse) {
+    switch (command.kind) {
+    case TagHistory::Command::Kind::Add:
+      if (inverse) removeTag(command.after.id);
+      else restoreTag(command.after);
+      break;
+    case TagHistory::Command::Kind::Remove:
+      if (inverse) restoreTag(command.before);
+      else removeTag(command.before.id);
+      break;
+    case TagHistory::Command::Kind::Update: {
+      const GameTag& target = inverse ? command.before : command.after;
+      if (TagHistory::sameExceptNote(command.before, command.after)) setTagNote(target.id, target.note);
+      else updateTag(target);
+      break;
+    }
+    }
+  };
+
+  // One transaction per step: consumers patch only the tags this step touched.
+  beginTransaction();
+  replayingHistory_ = true;
+  if (undo) {
+    for (auto it = entry.crbegin(); it != entry.crend(); ++it) apply(*it, true);
+  } else {
+    for (const TagHistory::Command& command : entry) apply(command, false);
+  }
+  replayingHistory_ = false;
+  commitTransaction();
+  emit historyChanged();
+}
+
+void TagSession::clearHistory() {
+  history_->clear();
+  emit historyChanged();
+}
+
+void TagSession::setHistoryBudgetBytes(qint64 bytes) {
+  history_->setBudgetBytes(bytes);
+  emit historyChanged();
+}
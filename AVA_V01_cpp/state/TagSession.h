@@ -6,22 +6,62 @@
 #include <QVector>
 #include <QtGlobal>
 
+#include <memory>
+
+#include "GameStateTimeline.h"
+#include "TagAggregates.h"
+#include "TagSymbol.h"
+
+class TagHistory;
+
 class TagSession final : public QObject {
   Q_OBJECT
 
 public:
+  /// Stable for the lifetime of the session and never reused; 0 means "no tag".
+  using TagId = quint64;
+
   struct GameTag {
-    QString mainEvent;
-    QString followUpEvent;
+    TagId id = 0;        // assigned by addTag
+    TagSymbol mainEvent;
+    TagSymbol followUpEvent;
     qint64 positionMs = 0;
-    QString note;
-    QString period;   // e.g. "Q1", "Q2", "Q3", "Q4"
-    QString team;    // e.g. "Home", "Away"
-    QString situation; // e.g. "Attacking", "Defending"
+    QString note;       // free text, not interned
+    TagSymbol period;    // e.g. "Q1", "Q2", "Q3", "Q4"
+    TagSymbol team;      // e.g. "Home", "Away"
+    TagSymbol situation; // e.g. "Attacking", "Defending"
+  };
+
+  /// Net effect of the mutations since the last delivery. A tag added and removed in the same
+  /// batch appears nowhere; an added tag that was then edited is only listed as added; a removed tag
+  /// that was re-added under its ID is listed as modified.
+  struct ChangeSet {
+    bool cleared = false;  // the session was cleared first; consumers should rebuild from scratch
+    QVector<TagId> added;
+    QVector<TagId> removed;
+    QVector<TagId> modified;
+
+    bool isEmpty() const { return !cleared && added.isEmpty() && removed.isEmpty() && modified.isEmpty(); }
+  };
+
+  /// Groups mutations into one change set, delivered synchronously when the outermost
+  /// transaction ends. Nests; use for imports and multi-selection edits.
+  class Transaction {
+  public:
+    explicit Transaction(TagSession* session) : session_(session) {
+      if (session_) session_->beginTransaction();
+    }
+    ~Transaction() {
+      if (session_) session_->commitTransaction();
+    }
+    Q_DISABLE_COPY(Transaction)
+
+  private:
+    TagSession* session_;
   };
 
   explicit TagSession(QObject* parent = nullptr);
-  ~TagSession() override = default;
+  ~TagSession() override;
 
   void clear();
   void clearTeamInfo();
@@ -32,28 +72,98 @@ public:
   QString homeTeamColor() const { return homeTeamColor_; }
   QString awayTeamColor() const { return awayTeamColor_; }
 
-  void addTag(const GameTag& tag);
-  void removeTag(int index);
-  void setTagNote(int index, const QString& note);
-  QString tagNote(int index) const;
+  /// Stores the tag under a fresh ID (tag.id is ignored) and returns that ID.
+  TagId addTag(const GameTag& tag);
+  void removeTag(TagId id);
+  /// Replaces every field of the tag with the same ID; unknown IDs are ignored.
+  void updateTag(const GameTag& tag);
+  void setTagNote(TagId id, const QString& note);
+  QString tagNote(TagId id) const;
+  /// Re-inserts a tag under its own ID (undo of a removal, journal recovery); ignored if the ID is live.
+  void restoreTag(const GameTag& tag);
 
+  /// Every mutation above is recorded for undo; a transaction is one undo step. Replays run as
+  /// a transaction, so views see one change set per step.
+  bool canUndo() const;
+  bool canRedo() const;
+  void undo();
+  void redo();
+  void clearHistory();
+  void setHistoryBudgetBytes(qint64 bytes);
+
+  /// nullptr for unknown or removed IDs. The pointer is only valid until the next mutation.
+  const GameTag* tag(TagId id) const;
+  bool containsTag(TagId id) const { return slotById_.contains(id); }
+  /// The most recently added tag that still exists, or 0.
+  TagId latestTagId() const { return latestTagId_; }
+
+  /// All tags in storage order. Removal moves the last tag into the freed slot, so this is neither
+  /// insertion nor time order; use tagIdsByTime() when order matters.
   const QVector<GameTag>& tags() const { return tags_; }
-  const QHash<QString, int>& mainEventCounts() const { return mainEventCounts_; }
-  const QHash<QString, QHash<QString, int>>& followUpCountsByMainEvent() const { return followUpCountsByMainEvent_; }
+
+  /// Tag IDs ordered by position, ties in insertion order. Maintained on every add/remove/edit
+  /// with a binary search, so consumers never re-sort.
+  const QVector<TagId>& tagIdsByTime() const { return timeOrderIds_; }
+  /// IDs of the tags with fromMs <= positionMs <= toMs, in time order.
+  QVector<TagId> tagIdsInRange(qint64 fromMs, qint64 toMs) const;
+  /// The tag closest to positionMs (the earlier one on a tie), or 0 when there are no tags.
+  TagId nearestTagId(qint64 positionMs) const;
+
+  void beginTransaction();
+  void commitTransaction();
+  /// Delivers pending changes now instead of on the next event-loop turn.
+  void flushChanges();
+
+  /// Counts by (team, main event, follow-up, period) for any filter, without touching the tags.
+  const TagAggregates& aggregates() const { return aggregates_; }
+  /// Score, cards and penalty corners at any position, derived from the tags as they change.
+  const GameStateTimeline& gameState() const { return gameState_; }
 
 signals:
+  // Per-mutation signals, emitted immediately. Views should prefer changesCommitted.
   void cleared();
   void tagAdded(const TagSession::GameTag& tag);
-  void tagNoteChanged(int index);
+  void tagRemoved(TagSession::TagId id);
+  void tagUpdated(TagSession::TagId id);
+  void tagNoteChanged(TagSession::TagId id);
+  /// Team names or colours changed; emitted immediately, outside the change-set machinery.
+  void teamsChanged();
+  /// Coalesced: at most once per event-loop turn, or once per outermost transaction.
+  void changesCommitted(const TagSession::ChangeSet& changes);
+  /// Emitted right after changesCommitted unless the batch only touched notes.
   void statsChanged();
+  void historyChanged();
 
 private:
+  enum class PendingChange : quint8 { Added, Removed, Modified };
+
+  void recordChange(TagId id, PendingChange change, bool affectsStats = true);
+  void scheduleFlush();
+  void storeTag(const GameTag& tag);
+  void recordHistory(const GameTag* before, const GameTag* after);  // null before: add; null after: remove
+  void replayHistory(bool undo);
+
+  void indexTag(const GameTag& tag);
+  void unindexTag(const GameTag& tag);
+  int timeSlot(qint64 positionMs, TagId id) const;
+
   QVector<GameTag> tags_;
-  QHash<QString, int> mainEventCounts_;
-  QHash<QString, QHash<QString, int>> followUpCountsByMainEvent_;
+  QHash<TagId, int> slotById_;     // ID -> position in tags_
+  QVector<qint64> timeOrderMs_;    // sorted positions, parallel to timeOrderIds_
+  QVector<TagId> timeOrderIds_;
+  TagId nextTagId_ = 1;
+  TagId latestTagId_ = 0;          // largest stored ID; IDs increase with every add
+  QHash<TagId, PendingChange> pendingChanges_;
+  bool pendingCleared_ = false;
+  bool pendingStatsChange_ = false;  // anything beyond note edits
+  bool flushScheduled_ = false;
+  int transactionDepth_ = 0;
+  std::unique_ptr<TagHistory> history_;
+  bool replayingHistory_ = false;
+  TagAggregates aggregates_;
+  GameStateTimeline gameState_;
   QString homeTeamName_;
   QString awayTeamName_;
   QString homeTeamColor_;
   QString awayTeamColor_;
 };
-
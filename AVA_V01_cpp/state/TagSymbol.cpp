@@ -0,0 +1,53 @@
+#include "TagSymbol.h"
+
+#include <QHash>
+
+#include <deque>
+
+namespace {
+struct SymbolTable {
+  std::deque<QString> texts{QString()};  // deque keeps text() references valid while the table grows
+  QHash<QString, TagSymbol::Id> ids;
+};
+
+SymbolTable& symbolTable() {
+  static SymbolTable table;
+  return table;
+}
+} // namespace
+
+TagSymbol::Id TagSymbol::intern(const QString& text) {
+  if (text.isEmpty()) return 0;
+  SymbolTable& table = symbolTable();
+  const auto it = table.ids.constFind(text);
+  if (it != table.ids.cend()) return it.value();
+  const Id id = static_cast<Id>(table.texts.size());
+  table.texts.push_back(text);
+  table.ids.insert(text, id);
+  return id;
+}
+
+const QString& TagSymbol::text() const {
+  return symbolTable().texts[id_];
+}
+
+int TagSymbol::tableSize() {
+  return static_cast<int>(symbolTable().texts.size());
+}
+
+namespace TagVocabulary {
+const TagSymbol& home() {
+  static const TagSymbol symbol(QStringLiteral("Home"));
+  return symbol;
+}
+
+const TagSymbol& away() {
+  static const TagSymbol symbol(QStringLiteral("Away"));
+  return symbol;
+}
+
+const TagSymbol& goal() {
+  static const TagSymbol symbol(QStringLiteral("Goal"));
+  return symbol;
+}
+} // namespace TagVocabulary
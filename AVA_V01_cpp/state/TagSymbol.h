@@ -0,0 +1,46 @@
+#pragma once
+
+#include <QHashFunctions>
+#include <QString>
+#include <QtGlobal>
+
+/// Interned tag vocabulary string: event name, follow-up path, team, period or situation.
+/// A tag stores the 32-bit ID only, so equality is an integer compare and the text is one table
+/// lookup away. Converts implicitly to and from QString so GameTag keeps its string-based API.
+/// The table is shared by every session and only grows; a game uses a few hundred distinct strings.
+/// GUI-thread only, like TagSession itself.
+class TagSymbol {
+public:
+  using Id = quint32;
+
+  TagSymbol() = default;
+  TagSymbol(const QString& text) : id_(intern(text)) {}
+
+  Id id() const { return id_; }
+  bool isEmpty() const { return id_ == 0; }
+  const QString& text() const;
+  operator const QString&() const { return text(); }
+
+  static int tableSize();
+
+  friend bool operator==(TagSymbol a, TagSymbol b) { return a.id_ == b.id_; }
+  friend bool operator!=(TagSymbol a, TagSymbol b) { return a.id_ != b.id_; }
+  // Mixed compares fall back to the text; hot paths compare against a pre-interned symbol instead.
+  friend bool operator==(TagSymbol a, const QString& b) { return a.text() == b; }
+  friend bool operator!=(TagSymbol a, const QString& b) { return a.text() != b; }
+  friend bool operator==(const QString& a, TagSymbol b) { return a == b.text(); }
+  friend bool operator!=(const QString& a, TagSymbol b) { return a != b.text(); }
+  friend size_t qHash(TagSymbol symbol, size_t seed = 0) noexcept { return qHash(symbol.id_, seed); }
+
+private:
+  static Id intern(const QString& text);
+
+  Id id_ = 0;  // 0 is the empty string
+};
+
+/// Symbols the app branches on, interned once.
+namespace TagVocabulary {
+const TagSymbol& home();
+const TagSymbol& away();
+const TagSymbol& goal();
+} // namespace TagVocabulary
@@ -47,8 +47,9 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent) { // ctor-init
     connect(&LocaleNotifier::instance(), &LocaleNotifier::languageChanged, welcomeWindow_,
             &WelcomeWindow::applyUiStrings);
 
-    // State reset on app exit (start of state management)
+    // State reset on app exit; the journal is closed first so the tags survive for the next launch
     connect(qApp, &QCoreApplication::aboutToQuit, this, [this]() {
+        if (workWindow_) workWindow_->closeSessionJournal();
         if (tagSession_) tagSession_->clear();
         if (tagSession_) tagSession_->clearTeamInfo();
     });
@@ -107,6 +108,7 @@ void MainWindow::onVideoImportRequested() {
 }
 
 void MainWindow::onVideoClosed() {
+    if (workWindow_) workWindow_->closeSessionJournal();
     if (tagSession_) tagSession_->clear();
     if (tagSession_) tagSession_->clearTeamInfo();
     showWelcomeWindow();
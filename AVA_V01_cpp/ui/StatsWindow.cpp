@@ -156,15 +156,12 @@ StatsWindow::TeamStatsFilter StatsWindow::currentTeamFilter() const {
     return static_cast<TeamStatsFilter>(id);
 }
 
-bool StatsWindow::tagMatchesTeamFilter(const TagSession::GameTag& tag, TeamStatsFilter filter) const {
-    if (filter == TeamStatsFilter::Both) return true;
-    if (filter == TeamStatsFilter::Home) {
-        return tag.team.compare(QStringLiteral("Home"), Qt::CaseInsensitive) == 0;
-    }
-    if (filter == TeamStatsFilter::Away) {
-        return tag.team.compare(QStringLiteral("Away"), Qt::CaseInsensitive) == 0;
-    }
-    return false;
+TagAggregates::Filter StatsWindow::aggregateFilter(TeamStatsFilter filter) const {
+    TagAggregates::Filter aggregateFilter;
+    aggregateFilter.teamIgnoresCase = true;  // imported tags may spell the side "home" or "HOME"
+    if (filter == TeamStatsFilter::Home) aggregateFilter.team = TagVocabulary::home();
+    if (filter == TeamStatsFilter::Away) aggregateFilter.team = TagVocabulary::away();
+    return aggregateFilter;
 }
 
 void StatsWindow::onTreeItemDoubleClicked(QTreeWidgetItem* item, int /*column*/) {
@@ -186,29 +183,23 @@ void StatsWindow::rebuildTree() {
     clearTree();
     if (!tagSession_) return;
 
-    const TeamStatsFilter filter = currentTeamFilter();
-    QHash<QString, int> mainCounts;
-    QHash<QString, QHash<QString, int>> followUpCounts;
-
-    for (const TagSession::GameTag& tag : tagSession_->tags()) {
-        if (!tagMatchesTeamFilter(tag, filter)) continue;
-        mainCounts[tag.mainEvent] = mainCounts.value(tag.mainEvent, 0) + 1;
-        if (!tag.followUpEvent.isEmpty()) {
-            auto& inner = followUpCounts[tag.mainEvent];
-            inner[tag.followUpEvent] = inner.value(tag.followUpEvent, 0) + 1;
-        }
-    }
+    // Read from the session's aggregate cube: switching the team filter never rescans the tags.
+    const TagAggregates::Filter filter = aggregateFilter(currentTeamFilter());
+    const QHash<TagSymbol, int> mainCounts = tagSession_->aggregates().mainEventCounts(filter);
+    const QHash<TagSymbol, QHash<TagSymbol, int>> followUpCounts =
+        tagSession_->aggregates().followUpCounts(filter);
 
-    QStringList mains = mainCounts.keys();
-    std::sort(mains.begin(), mains.end(), [](const QString& a, const QString& b) {
-        return a.compare(b, Qt::CaseInsensitive) < 0;
+    QList<TagSymbol> mains = mainCounts.keys();
+    std::sort(mains.begin(), mains.end(), [](const TagSymbol& a, const TagSymbol& b) {
+        return a.text().compare(b.text(), Qt::CaseInsensitive) < 0;
     });
 
     const QString homeName = tagSession_->homeTeamName();
     const QString awayName = tagSession_->awayTeamName();
 
-    for (const QString& mainEvent : mains) {
-        const int mainCount = mainCounts.value(mainEvent, 0);
+    for (const TagSymbol& mainSymbol : std::as_const(mains)) {
+        const QString& mainEvent = mainSymbol.text();
+        const int mainCount = mainCounts.value(mainSymbol, 0);
 
         auto* mainItem = new QTreeWidgetItem(tree_);
         mainItem->setText(0, AppLocale::trEvent(mainEvent));
@@ -216,16 +207,17 @@ void StatsWindow::rebuildTree() {
         mainItem->setData(0, Qt::UserRole, mainEvent);
         mainItem->setData(0, Qt::UserRole + 1, QString());
 
-        const auto followUpsIt = followUpCounts.find(mainEvent);
-        if (followUpsIt == followUpCounts.end()) continue;
+        const auto followUpsIt = followUpCounts.constFind(mainSymbol);
+        if (followUpsIt == followUpCounts.cend()) continue;
 
-        QStringList followUps = followUpsIt.value().keys();
-        std::sort(followUps.begin(), followUps.end(), [](const QString& a, const QString& b) {
-            return a.compare(b, Qt::CaseInsensitive) < 0;
+        QList<TagSymbol> followUps = followUpsIt.value().keys();
+        std::sort(followUps.begin(), followUps.end(), [](const TagSymbol& a, const TagSymbol& b) {
+            return a.text().compare(b.text(), Qt::CaseInsensitive) < 0;
         });
 
-        for (const QString& followUp : followUps) {
-            const int followUpCount = followUpsIt.value().value(followUp, 0);
+        for (const TagSymbol& followUpSymbol : std::as_const(followUps)) {
+            const QString& followUp = followUpSymbol.text();
+            const int followUpCount = followUpsIt.value().value(followUpSymbol, 0);
             const QString stripped =
                 AppLocale::followUpPathWithoutTeamSegments(followUp, homeName, awayName);
             if (stripped.isEmpty()) continue;
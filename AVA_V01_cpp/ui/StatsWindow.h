@@ -36,7 +36,7 @@ private:
   void clearTree();
   void updateTeamFilterButtonLabels();
   TeamStatsFilter currentTeamFilter() const;
-  bool tagMatchesTeamFilter(const TagSession::GameTag& tag, TeamStatsFilter filter) const;
+  TagAggregates::Filter aggregateFilter(TeamStatsFilter filter) const;
 
   QLabel* headerLabel_ = nullptr;
   QWidget* teamFilterRow_ = nullptr;
@@ -3,13 +3,19 @@
 #include "../components/VideoPlayer.h"
 #include "../components/GameControls.h"
 #include "../components/Scoreboard.h"
+#include "../components/AngleSync.h"
 #include "../state/TagSession.h"
+#include "../state/TagJournal.h"
+#include "../state/TagArchive.h"
 #include "StatsWindow.h"
 #include "GameSetupWindow.h"
 #include "../i18n/AppLocale.h"
 #include "../i18n/LocaleNotifier.h"
 #include "../export/ExportDialog.h"
 #include "../export/VideoConcatenator.h"
+#include "../media/ProxyGenerator.h"
+#include "../media/AudioPeaks.h"
+#include "../media/SceneAnalysis.h"
 
 #include "VideoControlsBar.h"
 #include "TimelineBar.h"
@@ -42,6 +48,7 @@
 #include <QDialog>
 #include <QFont>
 #include <QModelIndex>
+#include <QItemSelectionModel>
 #include <QSplitter>
 #include <QHBoxLayout>
 #include <QScrollBar>
@@ -49,6 +56,12 @@
 #include <QAbstractSpinBox>
 #include <QComboBox>
 #include <QTextEdit>
+#include <QFileDialog>
+#include <QFile>
+#include <QFileInfo>
+#include <QInputDialog>
+
+#include <algorithm>
 
 namespace {
 
@@ -105,33 +118,40 @@ QColor foregroundForTeamBackground(const QColor& backgroundColor) {
     return luminance > 0.55 ? QColor(20, 20, 20) : QColor(252, 252, 252);
 }
 
-void paintTeamCellForTag(QTableWidgetItem* teamItem, const TagSession::GameTag& tag, TagSession* session) {
-    if (!teamItem) return;
-    if (!session) {
-        teamItem->setBackground(QBrush());
-        teamItem->setForeground(QBrush());
-        return;
-    }
+constexpr qint64 kSuggestionAcceptWindowMs = 5000;   // Y only accepts a suggestion this close to the playhead
+constexpr qint64 kSuggestionMatchMs = 250;           // a re-detected event within this of a handled one is the same
+const QColor kWhistleSuggestionColor(245, 158, 11);  // amber
+const QColor kCrowdSuggestionColor(59, 130, 246);    // blue
+
+/// Session color for the tag's team; invalid when the tag has no team or the team has no usable color.
+QColor teamColorForTag(const TagSession::GameTag& tag, const TagSession* session) {
+    if (!session) return QColor();
     QString hex;
-    if (tag.team == QStringLiteral("Home")) {
+    if (tag.team == TagVocabulary::home()) {
         hex = session->homeTeamColor();
-    } else if (tag.team == QStringLiteral("Away")) {
+    } else if (tag.team == TagVocabulary::away()) {
         hex = session->awayTeamColor();
     } else {
-        teamItem->setBackground(QBrush());
-        teamItem->setForeground(QBrush());
-        return;
+        return QColor();
     }
     QString hexClean = hex.trimmed();
-    if (hexClean.isEmpty()) {
-        teamItem->setBackground(QBrush());
-        teamItem->setForeground(QBrush());
-        return;
-    }
+    if (hexClean.isEmpty()) return QColor();
     if (!hexClean.startsWith(QLatin1Char('#'))) {
         hexClean.prepend(QLatin1Char('#'));
     }
-    const QColor backgroundColor(hexClean);
+    return QColor(hexClean);
+}
+
+/// Timeline marker keyed by tag ID; tags without a team color use `neutral`.
+TagMarkerTrack::Marker timelineMarkerForTag(const TagSession::GameTag& tag, const TagSession* session,
+                                            const QColor& neutral) {
+    const QColor color = teamColorForTag(tag, session);
+    return {tag.positionMs, color.isValid() ? color : neutral, tag.id};
+}
+
+void paintTeamCellForTag(QTableWidgetItem* teamItem, const TagSession::GameTag& tag, TagSession* session) {
+    if (!teamItem) return;
+    const QColor backgroundColor = teamColorForTag(tag, session);
     if (!backgroundColor.isValid()) {
         teamItem->setBackground(QBrush());
         teamItem->setForeground(QBrush());
@@ -221,12 +241,19 @@ void WorkWindow::applyUiStrings() {
     if (replaceVideoAction_) replaceVideoAction_->setText(AppLocale::trUi("menu.replace_video"));
     if (discardVideoAction_) discardVideoAction_->setText(AppLocale::trUi("menu.close_video"));
     if (exportClipsAction_) exportClipsAction_->setText(AppLocale::trUi("menu.export_clips"));
+    if (addAngleAction_) addAngleAction_->setText(AppLocale::trUi("menu.add_angle"));
+    if (anglesMenu_) anglesMenu_->setTitle(AppLocale::trUi("menu.angles"));
+    updateProxyStatusAction();
     if (tagsHeaderLabel_) tagsHeaderLabel_->setText(AppLocale::trUi("tags.header"));
     if (tagsFilterButton_) tagsFilterButton_->setText(AppLocale::trUi("tags.filter"));
     if (tagsRemoveFiltersButton_) tagsRemoveFiltersButton_->setText(AppLocale::trUi("tags.remove_filters"));
-    if (undoLastTagButton_) {
-        undoLastTagButton_->setText(AppLocale::trUi("tags.undo"));
-        undoLastTagButton_->setToolTip(AppLocale::trUi("tags.undo_tooltip"));
+    if (undoTagEditButton_) {
+        undoTagEditButton_->setText(AppLocale::trUi("tags.undo"));
+        undoTagEditButton_->setToolTip(AppLocale::trUi("tags.undo_tooltip"));
+    }
+    if (redoTagEditButton_) {
+        redoTagEditButton_->setText(AppLocale::trUi("tags.redo"));
+        redoTagEditButton_->setToolTip(AppLocale::trUi("tags.redo_tooltip"));
     }
     if (notesEdit_) notesEdit_->setPlaceholderText(AppLocale::trUi("tags.note_placeholder"));
     if (tagsTable_) {
@@ -254,12 +281,15 @@ void WorkWindow::setTagSession(TagSession* session) {
     if (tagSession_) disconnect(tagSession_, nullptr, this, nullptr);
 
     tagSession_ = session;
+    delete sessionJournal_;
+    sessionJournal_ = tagSession_ ? new TagJournal(tagSession_, this) : nullptr;
     if (statsWindow_) statsWindow_->setTagSession(tagSession_);
     if (statsOverlay_) statsOverlay_->setTagSession(tagSession_);
     if (scoreboard_) scoreboard_->setTagSession(tagSession_);
 
     rebuildFilterMenu();
     rebuildTagsList();
+    updateUndoRedoButtons();
 
     if (!tagSession_) {
         if (gameControls_) gameControls_->setSessionTeamNames(QString(), QString());
@@ -271,23 +301,28 @@ void WorkWindow::setTagSession(TagSession* session) {
         gameControls_->setInitialTeamSide(true);
     }
 
-    connect(tagSession_, &TagSession::cleared, this, [this]() {
-        allowedMainEvents_.clear();
-        rebuildFilterMenu();
-        rebuildTagsList();
-    });
-
-    connect(tagSession_, &TagSession::statsChanged, this, [this]() {
-        rebuildFilterMenu();
-        rebuildTagsList();
-    });
+    connect(tagSession_, &TagSession::cleared, this, [this]() { allowedMainEvents_.clear(); });
+    connect(tagSession_, &TagSession::changesCommitted, this, &WorkWindow::applyTagChanges);
+    connect(tagSession_, &TagSession::historyChanged, this, &WorkWindow::updateUndoRedoButtons);
+    connect(tagSession_, &TagSession::tagNoteChanged, this, [this](TagSession::TagId) { loadNoteForSelectedTag(); });
+}
 
-    connect(tagSession_, &TagSession::tagAdded, this, [this](const TagSession::GameTag&) {
-        rebuildFilterMenu();
-        rebuildTagsList();
-        flashNewTagRow();
-    });
-    connect(tagSession_, &TagSession::tagNoteChanged, this, [this](int) { loadNoteForSelectedTag(); });
+void WorkWindow::closeSessionJournal() {
+    if (!sessionJournal_ || !sessionJournal_->isOpen()) return;
+    // Leaving a video finishes its session: keep a compact read-only copy for later review. Once
+    // the archive is on disk it replaces the journal, so the next open maps it instead of replaying.
+    // An emptied session drops its archive, or the deleted tags would come back from it.
+    const QString archivePath = TagArchive::archivePathFor(sessionJournal_->sourcePath());
+    if (tagSession_ && !tagSession_->tags().isEmpty()) {
+        if (TagArchive::writeSession(*tagSession_, archivePath)) {
+            sessionJournal_->closeAndDiscardFiles();
+            return;
+        }
+        qWarning("WorkWindow: could not write the session archive %s", qPrintable(archivePath));
+    } else if (QFile::exists(archivePath) && !QFile::remove(archivePath)) {
+        qWarning("WorkWindow: could not remove the stale session archive %s", qPrintable(archivePath));
+    }
+    sessionJournal_->close();
 }
 
 void WorkWindow::setMode(Mode m) {
@@ -362,6 +397,22 @@ void WorkWindow::buildUi() {
     // Children (video surface, controls, timeline) are reparented into WorkWindow layouts; the shell
     // widget must stay hidden or it paints an empty rectangle at (0,0) over the mode toggle row.
     videoPlayer_->hide();
+
+    // Video stage: main surface on top, extra camera angles in a strip below (hidden until one is added).
+    videoStage_ = new QWidget(this);
+    videoStage_->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+    auto* videoStageLayout = new QVBoxLayout(videoStage_);
+    videoStageLayout->setContentsMargins(0, 0, 0, 0);
+    videoStageLayout->setSpacing(6);
+    videoStageLayout->addWidget(videoPlayer_->videoWidget(), 3);
+    angleStrip_ = new QWidget(videoStage_);
+    auto* angleStripLayout = new QHBoxLayout(angleStrip_);
+    angleStripLayout->setContentsMargins(0, 0, 0, 0);
+    angleStripLayout->setSpacing(6);
+    videoStageLayout->addWidget(angleStrip_, 1);
+    angleStrip_->hide();
+    angleSync_ = new AngleSync(videoPlayer_, this);
+
     auto* videoControlsBar = videoPlayer_->controlsBar();
     videoControlsRow_ = new QWidget(this);
     auto* videoControlsLayout = new QHBoxLayout(videoControlsRow_);
@@ -386,6 +437,13 @@ void WorkWindow::buildUi() {
     discardVideoAction_ = videoMenu_->addAction(QString());
     videoMenu_->addSeparator();
     exportClipsAction_ = videoMenu_->addAction(QString());
+    videoMenu_->addSeparator();
+    addAngleAction_ = videoMenu_->addAction(QString());
+    anglesMenu_ = videoMenu_->addMenu(QString());
+    anglesMenu_->menuAction()->setVisible(false);
+    videoMenu_->addSeparator();
+    proxyStatusAction_ = videoMenu_->addAction(QString());
+    proxyStatusAction_->setEnabled(false); // status line only
     videoMenuButton_->setMenu(videoMenu_);
     videoControlsLayout->addWidget(videoMenuButton_, 0, Qt::AlignRight | Qt::AlignVCenter);
 
@@ -464,15 +522,20 @@ void WorkWindow::buildUi() {
     Style::setRole(tagsFilterIndicator_, "muted");
     tagsFilterIndicator_->hide();
 
-    undoLastTagButton_ = new QToolButton(tagsHeaderRow_);
-    Style::setVariant(undoLastTagButton_, "ghost");
-    Style::setSize(undoLastTagButton_, "sm");
-    undoLastTagButton_->setCursor(Qt::PointingHandCursor);
+    undoTagEditButton_ = new QToolButton(tagsHeaderRow_);
+    Style::setVariant(undoTagEditButton_, "ghost");
+    Style::setSize(undoTagEditButton_, "sm");
+    undoTagEditButton_->setCursor(Qt::PointingHandCursor);
+    redoTagEditButton_ = new QToolButton(tagsHeaderRow_);
+    Style::setVariant(redoTagEditButton_, "ghost");
+    Style::setSize(redoTagEditButton_, "sm");
+    redoTagEditButton_->setCursor(Qt::PointingHandCursor);
 
     tagsHeaderLayout->addWidget(tagsHeaderLabel_, 0);
     tagsHeaderLayout->addStretch(1);
     tagsHeaderLayout->addWidget(tagsFilterIndicator_, 0);
-    tagsHeaderLayout->addWidget(undoLastTagButton_, 0);
+    tagsHeaderLayout->addWidget(undoTagEditButton_, 0);
+    tagsHeaderLayout->addWidget(redoTagEditButton_, 0);
     tagsHeaderLayout->addWidget(tagsRemoveFiltersButton_, 0);
     tagsHeaderLayout->addWidget(tagsFilterButton_, 0);
 
@@ -484,7 +547,7 @@ void WorkWindow::buildUi() {
     tagsTable_->verticalHeader()->hide();
     tagsTable_->setShowGrid(false);
     tagsTable_->setSelectionBehavior(QAbstractItemView::SelectRows);
-    tagsTable_->setSelectionMode(QAbstractItemView::SingleSelection);
+    tagsTable_->setSelectionMode(QAbstractItemView::ExtendedSelection);
     tagsTable_->setEditTriggers(QAbstractItemView::NoEditTriggers);
     tagsTable_->setWordWrap(false);
     tagsTable_->horizontalHeader()->setStretchLastSection(true);
@@ -576,7 +639,7 @@ void WorkWindow::applyTaggingLayout() {
     if (analyzingMainSplitter_) analyzingMainSplitter_->hide();
 
     QWidget* timeline = videoPlayer_ ? videoPlayer_->timelineBar() : nullptr;
-    detachWidgetFromParent(videoPlayer_ ? videoPlayer_->videoWidget() : nullptr);
+    detachWidgetFromParent(videoStage_);
     if (timeline && timeline->parentWidget() != videoTimelineRow_) {
         detachWidgetFromParent(timeline);
     }
@@ -601,8 +664,7 @@ void WorkWindow::applyTaggingLayout() {
     if (videoPlayer_ && videoPlayer_->controlsBar())
         videoPlayer_->controlsBar()->setObjectName("VideoControlsBarSlim");
 
-    QWidget* vw = videoPlayer_->videoWidget();
-    static_cast<QBoxLayout*>(taggingVideoCol_->layout())->addWidget(vw, 1);
+    static_cast<QBoxLayout*>(taggingVideoCol_->layout())->addWidget(videoStage_, 1);
     auto* rightLayout = static_cast<QBoxLayout*>(taggingRightCol_->layout());
     if (gameControls_) {
         // Analyzing mode lowers minimum width; restore so tagging labels are not clipped.
@@ -669,15 +731,15 @@ void WorkWindow::applyAnalyzingLayout() {
         delete item;  // widget stays in tree; do not setParent(nullptr)
     }
 
-    QWidget* vw = videoPlayer_->videoWidget();
+    QWidget* stage = videoStage_;
     QWidget* timeline = videoPlayer_ ? videoPlayer_->timelineBar() : nullptr;
-    if (!vw || !timeline || !analyzingMainSplitter_ || !analyzingLeftSplitter_ || !analyzingRightSplitter_ ||
+    if (!stage || !timeline || !analyzingMainSplitter_ || !analyzingLeftSplitter_ || !analyzingRightSplitter_ ||
         !analyzingTagsControlsSplitter_) {
         rebuildTagsList();
         return;
     }
 
-    detachWidgetFromParent(vw);
+    detachWidgetFromParent(stage);
     detachWidgetFromParent(tagsSection_);
     detachWidgetFromParent(gameControls_);
     detachWidgetFromParent(scoreboard_);
@@ -708,7 +770,7 @@ void WorkWindow::applyAnalyzingLayout() {
     analyzingTagsControlsSplitter_->addWidget(tagsSection_);
     analyzingTagsControlsSplitter_->addWidget(gameControls_);
 
-    analyzingLeftSplitter_->addWidget(vw);
+    analyzingLeftSplitter_->addWidget(stage);
     analyzingLeftSplitter_->addWidget(timeline);
     analyzingLeftSplitter_->addWidget(analyzingTagsControlsSplitter_);
 
@@ -831,6 +893,24 @@ void WorkWindow::wireSignals() {
     connect(videoPlayer_, &VideoPlayer::videoClosed, this, &WorkWindow::videoClosed);
 
     connect(exportClipsAction_, &QAction::triggered, this, &WorkWindow::onExportClips);
+    connect(addAngleAction_, &QAction::triggered, this, &WorkWindow::onAddCameraAngle);
+    // Queued: the menu is rebuilt from actions that may be the sender.
+    connect(angleSync_, &AngleSync::anglesChanged, this, &WorkWindow::rebuildAnglesMenu, Qt::QueuedConnection);
+
+    // Proxy progress / disk usage in the video menu (disk usage refreshed whenever the menu opens)
+    if (auto* proxy = videoPlayer_->proxyGenerator()) {
+        connect(proxy, &ProxyGenerator::progressChanged, this, [this](int) { updateProxyStatusAction(); });
+        connect(proxy, &ProxyGenerator::proxyReady, this, [this](const QString&) { updateProxyStatusAction(); });
+        connect(proxy, &ProxyGenerator::failed, this, [this](const QString&) { updateProxyStatusAction(); });
+    }
+    connect(videoMenu_, &QMenu::aboutToShow, this, &WorkWindow::updateProxyStatusAction);
+
+    // P: instant replay loops the few seconds around the most recent tag
+    connect(videoPlayer_->controlsBar(), &VideoControlsBar::instantReplayRequested, this, [this]() {
+        const TagSession::GameTag* latest = tagSession_ ? tagSession_->tag(tagSession_->latestTagId()) : nullptr;
+        if (!latest) return;
+        videoPlayer_->replayAroundMs(latest->positionMs);
+    });
 
     // GameControls -> capture timestamp and store tags
     connect(gameControls_, &GameControls::mainEventPressed, this, [this](const QString& mainEvent) {
@@ -866,7 +946,7 @@ void WorkWindow::wireSignals() {
             tag.situation = ctx.situation;
             if (gameControls_) {
                 const QString sideKey = gameControls_->selectedTeamSideKey();
-                tag.team = sideKey.isEmpty() ? ctx.team : sideKey;
+                tag.team = sideKey.isEmpty() ? ctx.team : TagSymbol(sideKey);
                 if (!sideKey.isEmpty()) {
                     contextTeam_ = sideKey;
                 }
@@ -893,7 +973,8 @@ void WorkWindow::wireSignals() {
 
     connect(statsWindow_, &StatsWindow::filterByPathRequested, this, &WorkWindow::onFilterByPathRequested);
     connect(tagsRemoveFiltersButton_, &QToolButton::clicked, this, &WorkWindow::onRemoveFilters);
-    connect(undoLastTagButton_, &QToolButton::clicked, this, &WorkWindow::onUndoLastTag);
+    connect(undoTagEditButton_, &QToolButton::clicked, this, &WorkWindow::onUndoTagEdit);
+    connect(redoTagEditButton_, &QToolButton::clicked, this, &WorkWindow::onRedoTagEdit);
 
     auto* modeAction = new QAction(this);
     modeAction->setShortcut(QKeySequence(Qt::Key_M));
@@ -916,7 +997,8 @@ void WorkWindow::wireSignals() {
     noteDebounceTimer_->setSingleShot(true);
     connect(noteDebounceTimer_, &QTimer::timeout, this, &WorkWindow::saveNoteDebounceFired);
 
-    // Debounce playhead-driven table scans: scoreboard is O(log n), but row highlighting is O(rows).
+    // Debounce playhead-driven table scans (row highlighting is O(rows)); the scoreboard is O(log n)
+    // and follows every frame.
     playheadSideEffectsDebounceTimer_ = new QTimer(this);
     playheadSideEffectsDebounceTimer_->setSingleShot(true);
     playheadSideEffectsDebounceTimer_->setInterval(200);
@@ -924,6 +1006,7 @@ void WorkWindow::wireSignals() {
         onPlayheadPositionChanged(lastPlayheadPositionForSideEffectsMs_);
     });
     connect(videoPlayer_, &VideoPlayer::positionChangedMs, this, [this](qint64 positionMs) {
+        if (scoreboard_) scoreboard_->setCurrentTimestampMs(positionMs);
         lastPlayheadPositionForSideEffectsMs_ = positionMs;
         playheadSideEffectsDebounceTimer_->start();
     });
@@ -935,12 +1018,33 @@ void WorkWindow::wireSignals() {
     connect(deleteTagAction, &QAction::triggered, this, &WorkWindow::onDeleteSelectedTag);
     addAction(deleteTagAction);
 
-    // Ctrl+Z to undo last tag (remove most recent)
+    // Y accepts the audio suggestion nearest the playhead as a tag
+    auto* acceptSuggestionAction = new QAction(this);
+    acceptSuggestionAction->setShortcut(QKeySequence(Qt::Key_Y));
+    acceptSuggestionAction->setShortcutContext(Qt::WidgetWithChildrenShortcut);
+    connect(acceptSuggestionAction, &QAction::triggered, this, &WorkWindow::onAcceptNearestSuggestion);
+    addAction(acceptSuggestionAction);
+    // Shift+Y dismisses it instead
+    auto* dismissSuggestionAction = new QAction(this);
+    dismissSuggestionAction->setShortcut(QKeySequence(Qt::SHIFT | Qt::Key_Y));
+    dismissSuggestionAction->setShortcutContext(Qt::WidgetWithChildrenShortcut);
+    connect(dismissSuggestionAction, &QAction::triggered, this, &WorkWindow::onDismissNearestSuggestion);
+    addAction(dismissSuggestionAction);
+    if (AudioPeaksBuilder* audio = videoPlayer_->audioAnalysis()) {
+        connect(audio, &AudioPeaksBuilder::eventsChanged, this, &WorkWindow::onAudioEventsChanged);
+    }
+
+    // Ctrl+Z / Ctrl+Shift+Z undo and redo tag edits (adds, deletes, notes)
     auto* undoTagAction = new QAction(this);
     undoTagAction->setShortcut(QKeySequence::Undo);
     undoTagAction->setShortcutContext(Qt::WidgetWithChildrenShortcut);
-    connect(undoTagAction, &QAction::triggered, this, &WorkWindow::onUndoLastTag);
+    connect(undoTagAction, &QAction::triggered, this, &WorkWindow::onUndoTagEdit);
     addAction(undoTagAction);
+    auto* redoTagAction = new QAction(this);
+    redoTagAction->setShortcut(QKeySequence::Redo);
+    redoTagAction->setShortcutContext(Qt::WidgetWithChildrenShortcut);
+    connect(redoTagAction, &QAction::triggered, this, &WorkWindow::onRedoTagEdit);
+    addAction(redoTagAction);
 
     if (QApplication* application = qobject_cast<QApplication*>(QApplication::instance())) {
         connect(application, &QApplication::focusChanged, this, &WorkWindow::onApplicationFocusWidgetChanged);
@@ -995,12 +1099,25 @@ void WorkWindow::loadVideoFromFile(const QString& filePath) {
     hasPreservedTaggingUiState_ = false;
     preservedTaggingVideoTagsSplitterSizes_.clear();
 
+    closeSessionJournal();
     if (tagSession_) tagSession_->clear();
+    handledSuggestions_.clear();
     hasPendingTag_ = false;
     pendingMainEvent_.clear();
     pendingTimestampMs_ = 0;
     if (tagsTable_) tagsTable_->setRowCount(0);
+    // Tags journaled for this video by an earlier run (crash or close) come back here; only when
+    // there is no journal or snapshot at all, fall back to the archive of a finished session.
+    if (sessionJournal_ && tagSession_) {
+        sessionJournal_->open(filePath);
+        TagArchive archive;
+        if (!sessionJournal_->foundExisting() && archive.open(TagArchive::archivePathFor(filePath))) {
+            archive.loadInto(tagSession_);
+            tagSession_->clearHistory();
+        }
+    }
 
+    if (angleSync_) angleSync_->removeAll();  // offsets were measured against the previous main video
     if (videoPlayer_) {
         videoPlayer_->loadVideoFromFile(filePath);
         videoPlayer_->setControlsVisible(true);
@@ -1025,7 +1142,8 @@ void WorkWindow::loadVideoFromFile(const QString& filePath) {
         if (tagsHeaderRow_) tagsHeaderRow_->show();
         if (tagsHeaderLabel_) tagsHeaderLabel_->show();
         if (tagsFilterButton_) tagsFilterButton_->show();
-        if (undoLastTagButton_) undoLastTagButton_->show();
+        if (undoTagEditButton_) undoTagEditButton_->show();
+        if (redoTagEditButton_) redoTagEditButton_->show();
         updateFilterButtonsVisibility();
     } else {
         if (tagsHeaderRow_) tagsHeaderRow_->hide();
@@ -1088,6 +1206,8 @@ void WorkWindow::onReplaceVideo() {
 }
 
 void WorkWindow::onDiscardVideo() {
+    if (videoPlayer_) videoPlayer_->cancelBackgroundJobs();
+    if (angleSync_) angleSync_->removeAll();
     hasPreservedTaggingUiState_ = false;
     preservedTaggingVideoTagsSplitterSizes_.clear();
 
@@ -1097,7 +1217,9 @@ void WorkWindow::onDiscardVideo() {
     if (modeTaggingBtn_) modeTaggingBtn_->hide();
     if (modeAnalyzingBtn_) modeAnalyzingBtn_->hide();
 
+    closeSessionJournal();
     if (tagSession_) tagSession_->clear();
+    handledSuggestions_.clear();
     hasPendingTag_ = false;
     pendingMainEvent_.clear();
     pendingTimestampMs_ = 0;
@@ -1116,6 +1238,19 @@ void WorkWindow::onExportClips() {
 
     const qint64 duration = videoPlayer_ ? videoPlayer_->durationMs() : 0;
     auto* dialog = new ExportDialog(tagSession_, sourceVideoPath_, duration, this);
+    if (angleSync_ && angleSync_->count() > 0) {
+        QVector<ExportAngle> angles;
+        for (const AngleSync::Angle& angle : angleSync_->angles()) {
+            angles.append({angle.name, angle.path, angle.offsetMs});
+        }
+        dialog->setCameraAngles(angles);
+    }
+    if (SceneAnalyzer* scenes = videoPlayer_ ? videoPlayer_->sceneAnalysis() : nullptr) {
+        dialog->setSceneAnalysis(scenes->analysis());
+    }
+    if (AudioPeaksBuilder* audio = videoPlayer_ ? videoPlayer_->audioAnalysis() : nullptr) {
+        dialog->setAudioEvents(audio->events());
+    }
     dialog->setAttribute(Qt::WA_DeleteOnClose);
     dialog->setModal(true);
     if (videoPlayer_) {
@@ -1129,6 +1264,64 @@ void WorkWindow::onExportClips() {
     dialog->show();
 }
 
+void WorkWindow::onAddCameraAngle() {
+    if (!angleSync_ || sourceVideoPath_.isEmpty()) return;
+    const QString path = QFileDialog::getOpenFileName(this, AppLocale::trUi("menu.add_angle"),
+                                                      QFileInfo(sourceVideoPath_).absolutePath());
+    if (path.isEmpty()) return;
+
+    bool ok = false;
+    const double offsetSeconds = QInputDialog::getDouble(
+        this, AppLocale::trUi("menu.add_angle"),
+        AppLocale::trUi("menu.angle_offset_prompt").arg(QFileInfo(path).fileName()),
+        0.0, -86400.0, 86400.0, 3, &ok);
+    if (!ok) return;
+
+    AngleSync::Angle angle;
+    angle.name = AppLocale::trUi("menu.angle_name").arg(angleSync_->count() + 2);
+    angle.path = path;
+    angle.offsetMs = qRound64(offsetSeconds * 1000.0);
+    const int index = angleSync_->addAngle(angle, angleStrip_);
+    angleStrip_->layout()->addWidget(angleSync_->videoWidget(index));
+    angleStrip_->show();
+}
+
+void WorkWindow::rebuildAnglesMenu() {
+    if (!anglesMenu_ || !angleSync_) return;
+    anglesMenu_->clear();
+    const int count = angleSync_->count();
+    anglesMenu_->menuAction()->setVisible(count > 0);
+
+    bool anyVisible = false;
+    for (int i = 0; i < count; ++i) {
+        const AngleSync::Angle& angle = angleSync_->angle(i);
+        anyVisible = anyVisible || angleSync_->isAngleVisible(i);
+
+        // Hiding an angle pauses its decoder; it re-aligns when shown again.
+        QAction* showAction = anglesMenu_->addAction(AppLocale::trUi("menu.angle_show").arg(angle.name));
+        showAction->setCheckable(true);
+        showAction->setChecked(angleSync_->isAngleVisible(i));
+        connect(showAction, &QAction::toggled, this, [this, i](bool on) { angleSync_->setAngleVisible(i, on); });
+
+        QAction* offsetAction = anglesMenu_->addAction(AppLocale::trUi("menu.angle_offset").arg(angle.name));
+        connect(offsetAction, &QAction::triggered, this, [this, i]() {
+            if (i >= angleSync_->count()) return;
+            const AngleSync::Angle& current = angleSync_->angle(i);
+            bool ok = false;
+            const double seconds = QInputDialog::getDouble(
+                this, current.name, AppLocale::trUi("menu.angle_offset_prompt").arg(QFileInfo(current.path).fileName()),
+                current.offsetMs / 1000.0, -86400.0, 86400.0, 3, &ok);
+            if (ok) angleSync_->setOffsetMs(i, qRound64(seconds * 1000.0));
+        });
+        anglesMenu_->addSeparator();
+    }
+    if (count > 0) {
+        QAction* removeAction = anglesMenu_->addAction(AppLocale::trUi("menu.remove_angles"));
+        connect(removeAction, &QAction::triggered, angleSync_, &AngleSync::removeAll);
+    }
+    if (angleStrip_) angleStrip_->setVisible(anyVisible);
+}
+
 void WorkWindow::onModeToggled() {
     auto* btn = qobject_cast<QToolButton*>(sender());
     if (!btn) return;
@@ -1143,42 +1336,34 @@ void WorkWindow::onModeToggled() {
 
 void WorkWindow::onTagSelectionChanged() {
     noteDebounceTimer_->stop();
-    if (pendingNoteIndex_ >= 0 && tagSession_) {
-        tagSession_->setTagNote(pendingNoteIndex_, pendingNoteText_);
-        pendingNoteIndex_ = -1;
+    if (pendingNoteTagId_ != 0 && tagSession_) {
+        tagSession_->setTagNote(pendingNoteTagId_, pendingNoteText_);
+        pendingNoteTagId_ = 0;
     }
     loadNoteForSelectedTag();
 }
 
 void WorkWindow::onNoteTextChanged() {
-    if (!notesEdit_ || !tagsTable_) return;
-    auto* item = currentTagKeyItem();
-    if (!item) return;
-    QVariant idxVar = item->data(Qt::UserRole + 3);
-    if (!idxVar.isValid()) return;
-    int idx = idxVar.toInt();
-    if (idx < 0 || (tagSession_ && idx >= tagSession_->tags().size())) return;
-    pendingNoteIndex_ = idx;
+    if (!notesEdit_ || !tagsTable_ || !tagSession_) return;
+    const TagSession::TagId id = tagIdForRow(tagsTable_->currentRow());
+    if (!tagSession_->containsTag(id)) return;
+    pendingNoteTagId_ = id;
     pendingNoteText_ = notesEdit_->toPlainText();
     noteDebounceTimer_->start(400);
 }
 
 void WorkWindow::saveNoteDebounceFired() {
-    if (pendingNoteIndex_ >= 0 && tagSession_) {
-        tagSession_->setTagNote(pendingNoteIndex_, pendingNoteText_);
-        pendingNoteIndex_ = -1;
+    if (pendingNoteTagId_ != 0 && tagSession_) {
+        tagSession_->setTagNote(pendingNoteTagId_, pendingNoteText_);
+        pendingNoteTagId_ = 0;
     }
 }
 
 void WorkWindow::syncNoteToSelectedTag() {
-    if (!tagSession_ || !notesEdit_) return;
-    auto* item = currentTagKeyItem();
-    if (!item) return;
-    QVariant idxVar = item->data(Qt::UserRole + 3);
-    if (!idxVar.isValid()) return;
-    int idx = idxVar.toInt();
-    if (idx < 0 || idx >= tagSession_->tags().size()) return;
-    tagSession_->setTagNote(idx, notesEdit_->toPlainText());
+    if (!tagSession_ || !notesEdit_ || !tagsTable_) return;
+    const TagSession::TagId id = tagIdForRow(tagsTable_->currentRow());
+    if (!tagSession_->containsTag(id)) return;
+    tagSession_->setTagNote(id, notesEdit_->toPlainText());
 }
 
 void WorkWindow::showStatsOverlay() {
@@ -1208,16 +1393,13 @@ void WorkWindow::loadNoteForSelectedTag() {
         notesEdit_->setEnabled(false);
         notesEdit_->setPlaceholderText("Select a tag to add a note…");
     } else {
-        QVariant idxVar = item->data(Qt::UserRole + 3);
-        if (idxVar.isValid()) {
-            int idx = idxVar.toInt();
-            if (idx >= 0 && idx < tagSession_->tags().size()) {
-                notesEdit_->setPlainText(tagSession_->tagNote(idx));
-                notesEdit_->setEnabled(true);
-                notesEdit_->setPlaceholderText("Note for this tag…");
-                notesEdit_->blockSignals(false);
-                return;
-            }
+        const TagSession::TagId id = tagIdForRow(tagsTable_->currentRow());
+        if (tagSession_->containsTag(id)) {
+            notesEdit_->setPlainText(tagSession_->tagNote(id));
+            notesEdit_->setEnabled(true);
+            notesEdit_->setPlaceholderText("Note for this tag…");
+            notesEdit_->blockSignals(false);
+            return;
         }
         notesEdit_->clear();
         notesEdit_->setEnabled(true);
@@ -1239,6 +1421,12 @@ QTableWidgetItem* WorkWindow::currentTagKeyItem() const {
     return row >= 0 ? tagsTable_->item(row, 0) : nullptr;
 }
 
+TagSession::TagId WorkWindow::tagIdForRow(int row) const {
+    if (!tagsTable_ || row < 0) return 0;
+    const QTableWidgetItem* keyItem = tagsTable_->item(row, 0);
+    return keyItem ? keyItem->data(Qt::UserRole + 3).toULongLong() : 0;
+}
+
 void WorkWindow::setTagTableRowBackground(int row, const QBrush& brush) {
     if (!tagsTable_ || row < 0) return;
     const bool clearHighlight = (brush.style() == Qt::NoBrush);
@@ -1258,13 +1446,9 @@ void WorkWindow::setTagTableRowBackground(int row, const QBrush& brush) {
         }
     }
     if (QTableWidgetItem* teamItem = tagsTable_->item(row, 1)) {
-        const QVariant tagIndexVar = tagsTable_->item(row, 0) ? tagsTable_->item(row, 0)->data(Qt::UserRole + 3) : QVariant();
-        if (tagSession_ && tagIndexVar.isValid()) {
-            const int tagIndex = tagIndexVar.toInt();
-            if (tagIndex >= 0 && tagIndex < tagSession_->tags().size()) {
-                paintTeamCellForTag(teamItem, tagSession_->tags().at(tagIndex), tagSession_);
-                return;
-            }
+        if (const TagSession::GameTag* tag = tagSession_ ? tagSession_->tag(tagIdForRow(row)) : nullptr) {
+            paintTeamCellForTag(teamItem, *tag, tagSession_);
+            return;
         }
         paintTeamCellForTag(teamItem, TagSession::GameTag{}, tagSession_);
     }
@@ -1272,19 +1456,17 @@ void WorkWindow::setTagTableRowBackground(int row, const QBrush& brush) {
 
 QString WorkWindow::displayTeamForTag(const TagSession::GameTag& tag) const {
     if (!tagSession_) {
-        if (tag.team == QStringLiteral("Home")) return QStringLiteral("Home");
-        if (tag.team == QStringLiteral("Away")) return QStringLiteral("Away");
-        return tag.team.isEmpty() ? QStringLiteral("—") : tag.team;
+        return tag.team.isEmpty() ? QStringLiteral("—") : tag.team.text();
     }
-    if (tag.team == QStringLiteral("Home")) {
+    if (tag.team == TagVocabulary::home()) {
         const QString n = tagSession_->homeTeamName();
         return n.isEmpty() ? QStringLiteral("Home") : n;
     }
-    if (tag.team == QStringLiteral("Away")) {
+    if (tag.team == TagVocabulary::away()) {
         const QString n = tagSession_->awayTeamName();
         return n.isEmpty() ? QStringLiteral("Away") : n;
     }
-    return tag.team.isEmpty() ? QStringLiteral("—") : tag.team;
+    return tag.team.isEmpty() ? QStringLiteral("—") : tag.team.text();
 }
 
 namespace {
@@ -1293,8 +1475,8 @@ const QColor kTagNearPlayheadColor(147, 197, 253); // light blue, lighter than s
 const QColor kNewTagFlashColor(147, 197, 253);     // same light-blue for new-tag flash
 } // namespace
 
-void WorkWindow::flashNewTagRow() {
-    if (!tagsTable_ || tagsTable_->rowCount() == 0) return;
+void WorkWindow::flashTagRow(int row) {
+    if (!tagsTable_ || row < 0 || row >= tagsTable_->rowCount()) return;
     if (newTagFlashTimer_) {
         newTagFlashTimer_->stop();
     } else {
@@ -1302,7 +1484,8 @@ void WorkWindow::flashNewTagRow() {
         newTagFlashTimer_->setSingleShot(true);
         connect(newTagFlashTimer_, &QTimer::timeout, this, &WorkWindow::clearNewTagFlash);
     }
-    newTagFlashRow_ = tagsTable_->rowCount() - 1;
+    if (newTagFlashRow_ >= 0) setTagTableRowBackground(newTagFlashRow_, QBrush());
+    newTagFlashRow_ = row;
     setTagTableRowBackground(newTagFlashRow_, QBrush(kNewTagFlashColor));
     newTagFlashTimer_->start(500);
 }
@@ -1321,6 +1504,51 @@ void WorkWindow::onPlayheadPositionChanged(qint64 positionMs) {
     if (scoreboard_) scoreboard_->setCurrentTimestampMs(positionMs);
 }
 
+void WorkWindow::refreshTimelineMarkers() {
+    TimelineBar* timeline = videoPlayer_ ? videoPlayer_->timelineBar() : nullptr;
+    if (!timeline) return;
+    refreshSuggestionMarkers();
+
+    // Every tag is drawn (filters only narrow the table); tags without a team color use the neutral text color.
+    QVector<TagMarkerTrack::Marker> markers;
+    if (tagSession_) {
+        const QColor neutral = palette().color(QPalette::WindowText);
+        markers.reserve(tagSession_->tags().size());
+        for (const auto& tag : tagSession_->tags()) markers.append(timelineMarkerForTag(tag, tagSession_, neutral));
+    }
+    timeline->setTagMarkers(std::move(markers));
+}
+
+void WorkWindow::refreshSuggestionMarkers() {
+    TimelineBar* timeline = videoPlayer_ ? videoPlayer_->timelineBar() : nullptr;
+    if (!timeline) return;
+
+    QVector<TagMarkerTrack::Marker> suggestions;
+    suggestions.reserve(audioSuggestions_.size());
+    for (const AudioEvent& event : audioSuggestions_) {
+        suggestions.append({event.startMs, event.kind == AudioEvent::Kind::Whistle ? kWhistleSuggestionColor
+                                                                                    : kCrowdSuggestionColor});
+    }
+    timeline->setSuggestionMarkers(std::move(suggestions));
+}
+
+// Patches only the markers of changed tags; the track re-clusters just the buckets they fall in.
+void WorkWindow::updateTimelineMarkers(const TagSession::ChangeSet& changes) {
+    TimelineBar* timeline = videoPlayer_ ? videoPlayer_->timelineBar() : nullptr;
+    if (!timeline || !tagSession_) return;
+
+    const QColor neutral = palette().color(QPalette::WindowText);
+    QVector<TagMarkerTrack::Marker> upserts;
+    upserts.reserve(changes.added.size() + changes.modified.size());
+    for (const QVector<TagSession::TagId>* ids : {&changes.added, &changes.modified}) {
+        for (const TagSession::TagId id : *ids) {
+            const TagSession::GameTag* tag = tagSession_->tag(id);
+            if (tag) upserts.append(timelineMarkerForTag(*tag, tagSession_, neutral));
+        }
+    }
+    timeline->updateTagMarkers(changes.removed, upserts);
+}
+
 void WorkWindow::updateTagPlayheadHighlight(qint64 positionMs) {
     if (!tagsTable_) return;
     for (int row = 0; row < tagsTable_->rowCount(); ++row) {
@@ -1339,26 +1567,90 @@ void WorkWindow::updateTagPlayheadHighlight(qint64 positionMs) {
 void WorkWindow::onDeleteSelectedTag() {
     if (!tagsTable_ || !tagSession_) return;
 
-    auto* item = currentTagKeyItem();
-    if (!item) return;
-    
-    // Get the stored TagSession index directly from the item
-    const QVariant tagIndexVar = item->data(Qt::UserRole + 3);
-    if (!tagIndexVar.isValid()) return;
-    
-    const int tagIndex = tagIndexVar.toInt();
-    if (tagIndex < 0 || tagIndex >= tagSession_->tags().size()) return;
-    
-    tagSession_->removeTag(tagIndex);
-    rebuildTagsList();
+    // Rows store stable IDs, so collecting them first keeps removal independent of row order.
+    QVector<TagSession::TagId> ids;
+    for (const QModelIndex& index : tagsTable_->selectionModel()->selectedRows()) {
+        ids.append(tagIdForRow(index.row()));
+    }
+    if (ids.isEmpty()) ids.append(tagIdForRow(tagsTable_->currentRow()));
+
+    // One transaction: the table, stats and scoreboard update once for the whole selection.
+    TagSession::Transaction transaction(tagSession_);
+    for (const TagSession::TagId id : std::as_const(ids)) tagSession_->removeTag(id);
+}
+
+void WorkWindow::onUndoTagEdit() {
+    // Replays run as one session transaction, so the table is patched rather than rebuilt.
+    if (tagSession_) tagSession_->undo();
+}
+
+void WorkWindow::onRedoTagEdit() {
+    if (tagSession_) tagSession_->redo();
+}
+
+void WorkWindow::updateUndoRedoButtons() {
+    if (undoTagEditButton_) undoTagEditButton_->setEnabled(tagSession_ && tagSession_->canUndo());
+    if (redoTagEditButton_) redoTagEditButton_->setEnabled(tagSession_ && tagSession_->canRedo());
+}
+
+void WorkWindow::onAudioEventsChanged() {
+    // The detector republishes its whole list; drop what the user already accepted or dismissed.
+    AudioPeaksBuilder* audio = videoPlayer_ ? videoPlayer_->audioAnalysis() : nullptr;
+    audioSuggestions_.clear();
+    if (audio) {
+        for (const AudioEvent& event : audio->events()) {
+            if (!isHandledSuggestion(event)) audioSuggestions_.append(event);
+        }
+    }
+    refreshSuggestionMarkers();
+}
+
+bool WorkWindow::isHandledSuggestion(const AudioEvent& event) const {
+    return std::any_of(handledSuggestions_.cbegin(), handledSuggestions_.cend(), [&event](const AudioEvent& h) {
+        return h.kind == event.kind && qAbs(h.startMs - event.startMs) <= kSuggestionMatchMs;
+    });
 }
 
-void WorkWindow::onUndoLastTag() {
+int WorkWindow::nearestSuggestionIndex() const {
+    if (!videoPlayer_ || audioSuggestions_.isEmpty()) return -1;
+
+    // Suggestions are sorted by start; only the two around the playhead can be nearest.
+    const qint64 positionMs = videoPlayer_->currentPositionMs();
+    const auto it = std::lower_bound(audioSuggestions_.cbegin(), audioSuggestions_.cend(), positionMs,
+                                     [](const AudioEvent& e, qint64 ms) { return e.startMs < ms; });
+    int nearest = -1;
+    qint64 nearestDistance = kSuggestionAcceptWindowMs + 1;
+    for (const int i : {int(it - audioSuggestions_.cbegin()) - 1, int(it - audioSuggestions_.cbegin())}) {
+        if (i < 0 || i >= audioSuggestions_.size()) continue;
+        const qint64 distance = qAbs(audioSuggestions_.at(i).startMs - positionMs);
+        if (distance < nearestDistance) {
+            nearestDistance = distance;
+            nearest = i;
+        }
+    }
+    return nearest;
+}
+
+void WorkWindow::onDismissNearestSuggestion() {
+    const int nearest = nearestSuggestionIndex();
+    if (nearest < 0) return;
+    handledSuggestions_.append(audioSuggestions_.takeAt(nearest));
+    refreshSuggestionMarkers();
+}
+
+void WorkWindow::onAcceptNearestSuggestion() {
     if (!tagSession_) return;
-    const int n = tagSession_->tags().size();
-    if (n == 0) return;
-    tagSession_->removeTag(n - 1);
-    rebuildTagsList();
+    const int nearest = nearestSuggestionIndex();
+    if (nearest < 0) return;
+
+    const AudioEvent event = audioSuggestions_.takeAt(nearest);
+    handledSuggestions_.append(event);
+    refreshSuggestionMarkers();
+    TagSession::GameTag tag;
+    tag.mainEvent = event.kind == AudioEvent::Kind::Whistle ? QStringLiteral("Whistle") : QStringLiteral("Crowd");
+    tag.positionMs = event.startMs;
+    tag.period = currentTagContext().period;
+    tagSession_->addTag(tag);  // the change set inserts the row and the timeline marker
 }
 
 void WorkWindow::onSelectAllFilters() {
@@ -1436,6 +1728,29 @@ void WorkWindow::updateFilterButtonsVisibility() {
     }
 }
 
+void WorkWindow::updateProxyStatusAction() {
+    if (!proxyStatusAction_ || !videoPlayer_ || !videoPlayer_->proxyGenerator()) return;
+    const ProxyGenerator* proxy = videoPlayer_->proxyGenerator();
+
+    QString status;
+    switch (proxy->state()) {
+    case ProxyGenerator::State::Running:
+        status = AppLocale::trUi("menu.proxy_building").arg(proxy->progressPercent());
+        break;
+    case ProxyGenerator::State::Ready:
+        status = AppLocale::trUi(videoPlayer_->isPlayingFromProxy() ? "menu.proxy_active" : "menu.proxy_ready");
+        break;
+    case ProxyGenerator::State::Failed:
+        status = AppLocale::trUi("menu.proxy_failed");
+        break;
+    case ProxyGenerator::State::Idle:
+        status = AppLocale::trUi("menu.proxy_idle");
+        break;
+    }
+    const double cacheMb = double(ProxyGenerator::cacheDiskUsageBytes()) / (1024.0 * 1024.0);
+    proxyStatusAction_->setText(AppLocale::trUi("menu.proxy_cache").arg(status).arg(cacheMb, 0, 'f', 0));
+}
+
 void WorkWindow::rebuildFilterMenu() {
     if (!tagsFilterMenu_) return;
 
@@ -1455,7 +1770,10 @@ void WorkWindow::rebuildFilterMenu() {
     tagsFilterMenu_->addSeparator();
 
     if (!tagSession_) return;
-    QStringList mains = tagSession_->mainEventCounts().keys();
+    const QHash<TagSymbol, int> counts = tagSession_->aggregates().mainEventCounts();
+    QStringList mains;
+    mains.reserve(counts.size());
+    for (auto it = counts.cbegin(); it != counts.cend(); ++it) mains.append(it.key().text());
     mains.sort(Qt::CaseInsensitive);
 
     for (const QString& mainEvent : mains) {
@@ -1499,55 +1817,24 @@ void WorkWindow::updateFilterIndicator() {
 }
 
 void WorkWindow::rebuildTagsList() {
+    refreshTimelineMarkers();
     if (!tagsTable_ || !tagSession_) return;
+    tagRowIndex_.clear();
     tagsTable_->setRowCount(0);
 
-    // Collect (tag, tagSessionIndex) for tags that pass the filter
-    struct TagEntry {
-        TagSession::GameTag tag;
-        int tagSessionIndex;
-    };
-    QVector<TagEntry> entries;
-    int tagSessionIndex = 0;
-    for (const auto& tag : tagSession_->tags()) {
-        if (isTagAllowed(tag.mainEvent, tag.followUpEvent) && isTagAllowedByQuickFilters(tag)) {
-            entries.append({tag, tagSessionIndex});
+    // The session's time index keeps the list chronological; only the filter pass is needed.
+    QVector<const TagSession::GameTag*> entries;
+    for (const TagSession::TagId id : tagSession_->tagIdsByTime()) {
+        const TagSession::GameTag* tag = tagSession_->tag(id);
+        if (isTagAllowed(tag->mainEvent, tag->followUpEvent) && isTagAllowedByQuickFilters(*tag)) {
+            entries.append(tag);
         }
-        tagSessionIndex++;
     }
 
-    // Sort by timestamp so the list is always chronological
-    std::sort(entries.begin(), entries.end(), [](const TagEntry& a, const TagEntry& b) {
-        return a.tag.positionMs < b.tag.positionMs;
-    });
-
     tagsTable_->setRowCount(entries.size());
     int row = 0;
-    for (const auto& e : entries) {
-        const auto& tag = e.tag;
-        const QString timeText = formatTimestampMs(tag.positionMs);
-        const QString teamText = displayTeamForTag(tag);
-        const QString eventText =
-            AppLocale::trDisplayTagLine(tag.mainEvent, followUpForEventColumn(tag.followUpEvent, tagSession_));
-
-        auto* timeItem = new QTableWidgetItem(timeText);
-        timeItem->setData(Qt::UserRole, tag.positionMs);
-        timeItem->setData(Qt::UserRole + 1, tag.mainEvent);
-        timeItem->setData(Qt::UserRole + 2, tag.followUpEvent);
-        timeItem->setData(Qt::UserRole + 3, e.tagSessionIndex);
-        timeItem->setTextAlignment(Qt::AlignLeft | Qt::AlignVCenter);
-
-        auto* teamItem = new QTableWidgetItem(teamText);
-        teamItem->setTextAlignment(Qt::AlignLeft | Qt::AlignVCenter);
-        paintTeamCellForTag(teamItem, tag, tagSession_);
-
-        auto* eventItem = new QTableWidgetItem(eventText);
-        eventItem->setTextAlignment(Qt::AlignLeft | Qt::AlignVCenter);
-
-        tagsTable_->setItem(row, 0, timeItem);
-        tagsTable_->setItem(row, 1, teamItem);
-        tagsTable_->setItem(row, 2, eventItem);
-        ++row;
+    for (const TagSession::GameTag* entry : std::as_const(entries)) {
+        setTagRow(row++, *entry);
     }
 
     tagsTable_->resizeColumnToContents(0);
@@ -1559,3 +1846,116 @@ void WorkWindow::rebuildTagsList() {
         updateTagPlayheadHighlight(videoPlayer_->currentPositionMs());
     }
 }
+
+void WorkWindow::applyTagChanges(const TagSession::ChangeSet& changes) {
+    if (!filterMenuMatchesSession()) rebuildFilterMenu();
+    if (changes.cleared || !tagsTable_ || !tagSession_) {
+        rebuildTagsList();
+        return;
+    }
+    updateTimelineMarkers(changes);
+
+    // Rows are patched in place so a batch costs O(changed tags), not a full table rebuild.
+    for (const TagSession::TagId id : changes.removed) {
+        const int row = tagRowForId(id);
+        if (row >= 0) tagsTable_->removeRow(row);
+        tagRowIndex_.remove(id);
+    }
+    for (const TagSession::TagId id : changes.modified) {
+        const TagSession::GameTag* tag = tagSession_->tag(id);
+        const int row = tagRowForId(id);
+        const bool allowed = tag && isTagAllowed(tag->mainEvent, tag->followUpEvent)
+                             && isTagAllowedByQuickFilters(*tag);
+        if (row >= 0 && allowed
+            && tagsTable_->item(row, 0)->data(Qt::UserRole).toLongLong() == tag->positionMs) {
+            setTagRow(row, *tag);  // same slot: keeps selection and the note editor untouched
+            continue;
+        }
+        if (row >= 0) tagsTable_->removeRow(row);
+        tagRowIndex_.remove(id);
+        if (allowed) {
+            const int insertAt = tagRowInsertionPoint(*tag);
+            tagsTable_->insertRow(insertAt);
+            setTagRow(insertAt, *tag);
+        }
+    }
+    int lastAddedRow = -1;
+    for (const TagSession::TagId id : changes.added) {
+        const TagSession::GameTag* tag = tagSession_->tag(id);
+        if (!tag || !isTagAllowed(tag->mainEvent, tag->followUpEvent) || !isTagAllowedByQuickFilters(*tag)) continue;
+        lastAddedRow = tagRowInsertionPoint(*tag);
+        tagsTable_->insertRow(lastAddedRow);
+        setTagRow(lastAddedRow, *tag);
+    }
+
+    if (!changes.added.isEmpty() || !changes.modified.isEmpty()) {
+        tagsTable_->resizeColumnToContents(0);
+        tagsTable_->resizeColumnToContents(1);
+    }
+    updateFilterIndicator();
+    updateFilterButtonsVisibility();
+    if (videoPlayer_) {
+        updateTagPlayheadHighlight(videoPlayer_->currentPositionMs());
+    }
+    if (lastAddedRow >= 0) {
+        tagsTable_->scrollToItem(tagsTable_->item(lastAddedRow, 0));
+        flashTagRow(lastAddedRow);
+    }
+}
+
+void WorkWindow::setTagRow(int row, const TagSession::GameTag& tag) {
+    const QString timeText = formatTimestampMs(tag.positionMs);
+    const QString teamText = displayTeamForTag(tag);
+    const QString eventText =
+        AppLocale::trDisplayTagLine(tag.mainEvent, followUpForEventColumn(tag.followUpEvent, tagSession_));
+
+    auto* timeItem = new QTableWidgetItem(timeText);
+    timeItem->setData(Qt::UserRole, tag.positionMs);
+    timeItem->setData(Qt::UserRole + 1, tag.mainEvent.text());
+    timeItem->setData(Qt::UserRole + 2, tag.followUpEvent.text());
+    timeItem->setData(Qt::UserRole + 3, QVariant::fromValue(tag.id));
+    timeItem->setTextAlignment(Qt::AlignLeft | Qt::AlignVCenter);
+
+    auto* teamItem = new QTableWidgetItem(teamText);
+    teamItem->setTextAlignment(Qt::AlignLeft | Qt::AlignVCenter);
+    paintTeamCellForTag(teamItem, tag, tagSession_);
+
+    auto* eventItem = new QTableWidgetItem(eventText);
+    eventItem->setTextAlignment(Qt::AlignLeft | Qt::AlignVCenter);
+
+    tagsTable_->setItem(row, 0, timeItem);
+    tagRowIndex_.insert(tag.id, QPersistentModelIndex(tagsTable_->model()->index(row, 0)));
+    tagsTable_->setItem(row, 1, teamItem);
+    tagsTable_->setItem(row, 2, eventItem);
+}
+
+int WorkWindow::tagRowForId(TagSession::TagId id) const {
+    const auto it = tagRowIndex_.constFind(id);
+    return it != tagRowIndex_.cend() && it->isValid() ? it->row() : -1;
+}
+
+int WorkWindow::tagRowInsertionPoint(const TagSession::GameTag& tag) const {
+    // Rows mirror the session's time index: by position, then by ID (insertion order).
+    int lo = 0;
+    int hi = tagsTable_->rowCount();
+    while (lo < hi) {
+        const int mid = (lo + hi) / 2;
+        const qint64 midMs = tagsTable_->item(mid, 0)->data(Qt::UserRole).toLongLong();
+        if (midMs < tag.positionMs || (midMs == tag.positionMs && tagIdForRow(mid) < tag.id)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+bool WorkWindow::filterMenuMatchesSession() const {
+    if (!tagSession_) return filterActionByMainEvent_.isEmpty();
+    const QHash<TagSymbol, int> counts = tagSession_->aggregates().mainEventCounts();
+    if (counts.size() != filterActionByMainEvent_.size()) return false;
+    for (auto it = counts.cbegin(); it != counts.cend(); ++it) {
+        if (!filterActionByMainEvent_.contains(it.key().text())) return false;
+    }
+    return true;
+}
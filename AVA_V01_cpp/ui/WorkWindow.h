@@ -6,6 +6,7 @@
 #include <QBrush>
 #include <QHash>
 #include <QList>
+#include <QPersistentModelIndex>
 #include <QSet>
 
 class QLabel;
@@ -24,12 +25,15 @@ class QTemporaryDir;
 
 class VideoConcatenator;
 class VideoPlayer;
+class AngleSync;
 class GameControls;
 class GameSetupWindow;
 class StatsWindow;
 class Scoreboard;
+class TagJournal;
 
 #include "../state/TagSession.h"
+#include "../media/AudioEvents.h"
 
 class WorkWindow final : public QWidget {
   Q_OBJECT
@@ -45,6 +49,8 @@ public:
   void setTagSession(TagSession* session);
   void setConcatenatedVideoTempDir(QTemporaryDir* dir);
   void setPendingConcatenation(VideoConcatenator* concatenator);
+  /// Stops journaling the tag session; call before clearing it so the clear is not persisted.
+  void closeSessionJournal();
   Mode mode() const { return mode_; }
   void setMode(Mode m);
 
@@ -58,7 +64,10 @@ private slots:
   void onTagSelectionChanged();
   void onNoteTextChanged();
   void onDeleteSelectedTag();
-  void onUndoLastTag();
+  void onUndoTagEdit();
+  void onRedoTagEdit();
+  void onAcceptNearestSuggestion();
+  void onDismissNearestSuggestion();
   void onSelectAllFilters();
   void onSelectNoFilters();
   void onFilterActionToggled(bool checked);
@@ -73,6 +82,7 @@ private slots:
                             const QString& homeColor, const QString& awayColor);
   void onTeamSetupCancelled();
   void onExportClips();
+  void onAddCameraAngle();
   void onApplicationLanguageChanged();
 
 private:
@@ -86,15 +96,30 @@ private:
   void captureTaggingModeUiStateForRestore();
   void restoreTaggingModeUiStateAfterLayout();
   void rebuildTagsList();
+  void applyTagChanges(const TagSession::ChangeSet& changes);
+  void setTagRow(int row, const TagSession::GameTag& tag);
+  int tagRowForId(TagSession::TagId id) const;              // -1 when the tag is filtered out
+  int tagRowInsertionPoint(const TagSession::GameTag& tag) const;
+  bool filterMenuMatchesSession() const;
+  void refreshTimelineMarkers();
+  void refreshSuggestionMarkers();
+  void updateTimelineMarkers(const TagSession::ChangeSet& changes);
+  void onAudioEventsChanged();
+  int nearestSuggestionIndex() const;                       // -1 when none is close to the playhead
+  bool isHandledSuggestion(const AudioEvent& event) const;
   void rebuildFilterMenu();
+  void updateProxyStatusAction();
+  void rebuildAnglesMenu();
   void updateFilterIndicator();
   void updateFilterButtonsVisibility();
   void updateTagPlayheadHighlight(qint64 positionMs);
   void syncNoteToSelectedTag();  // immediate save (used on selection change)
   void loadNoteForSelectedTag();
-  void flashNewTagRow();
+  void flashTagRow(int row);
+  void updateUndoRedoButtons();
   void clearNewTagFlash();
   QTableWidgetItem* currentTagKeyItem() const;
+  TagSession::TagId tagIdForRow(int row) const;  // 0 when the row holds no tag
   void setTagTableRowBackground(int row, const QBrush& brush);
   QString displayTeamForTag(const TagSession::GameTag& tag) const;
   bool isMainEventAllowed(const QString& mainEvent) const;
@@ -139,10 +164,16 @@ private:
   QAction* replaceVideoAction_ = nullptr;
   QAction* discardVideoAction_ = nullptr;
   QAction* exportClipsAction_ = nullptr;
+  QAction* proxyStatusAction_ = nullptr;
+  QAction* addAngleAction_ = nullptr;
+  QMenu* anglesMenu_ = nullptr;
   QAction* statsOverlayAction_ = nullptr;
 
   // UI:
   VideoPlayer* videoPlayer_ = nullptr;
+  QWidget* videoStage_ = nullptr;     // main video + synced angle strip; moved as one between layouts
+  QWidget* angleStrip_ = nullptr;
+  AngleSync* angleSync_ = nullptr;
   GameControls* gameControls_ = nullptr;
   Scoreboard* scoreboard_ = nullptr;
   StatsWindow* statsWindow_ = nullptr;
@@ -150,7 +181,7 @@ private:
   QDialog* statsOverlayDialog_ = nullptr;
   StatsWindow* statsOverlay_ = nullptr;
   QTimer* noteDebounceTimer_ = nullptr;
-  int pendingNoteIndex_ = -1;
+  TagSession::TagId pendingNoteTagId_ = 0;
   QString pendingNoteText_;
 
   QLabel* tagsHeaderLabel_ = nullptr;
@@ -158,8 +189,10 @@ private:
   QToolButton* tagsRemoveFiltersButton_ = nullptr;
   QMenu* tagsFilterMenu_ = nullptr;
   QLabel* tagsFilterIndicator_ = nullptr;
-  QToolButton* undoLastTagButton_ = nullptr;
+  QToolButton* undoTagEditButton_ = nullptr;
+  QToolButton* redoTagEditButton_ = nullptr;
   QTableWidget* tagsTable_ = nullptr;
+  QHash<TagSession::TagId, QPersistentModelIndex> tagRowIndex_;  // follows row inserts/removals
 
   QTimer* newTagFlashTimer_ = nullptr;
   int newTagFlashRow_ = -1;
@@ -167,6 +200,9 @@ private:
   qint64 lastPlayheadPositionForSideEffectsMs_ = 0;
 
   TagSession* tagSession_ = nullptr;
+  TagJournal* sessionJournal_ = nullptr;  // persists tagSession_ next to the loaded video
+  QVector<AudioEvent> audioSuggestions_;   // detected whistles / crowd surges not yet accepted, by startMs
+  QVector<AudioEvent> handledSuggestions_; // accepted or dismissed for this video; kept out of rebuilds
   QHash<QString, QAction*> filterActionByMainEvent_;
   QSet<QString> allowedMainEvents_;
   QString activeFilterPathMainEvent_;